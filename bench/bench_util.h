@@ -0,0 +1,186 @@
+/**************************************************************************************
+*
+**	BENCH (bench_util.h)
+*		Helpers shared by the benchmark and the regression suite of the nessie program:
+*		runs nessie in a child process and measures it, counts the bases of a FASTA file
+*		and quotes the strings of the JSON reports, so that the two harnesses run nessie the same way.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+// INCLUDE
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "perf_counters.h"
+
+
+// BENCH UTIL
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT child_run DEFINITION
+//		Structure to store the measures of a single execution of nessie
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct child_run{
+
+	double seconds;	// wall time
+	double cpu_seconds;	// CPU time of the child, user + system
+	long peak_rss_kb;	// peak resident memory of the child
+	int status;	// exit status, -1 if killed by a signal
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	count_bases: returns the number of bases in a FASTA file, headers and new lines excluded
+//
+/////////////////////////////////////////////////////////////////////////////////////
+inline size_t count_bases(const std::string &path){
+
+	std::ifstream fin(path.c_str());
+	if (!fin){ throw std::runtime_error("can not open " + path); }
+
+	size_t bases = 0;
+	std::string line;
+	while (std::getline(fin, line)){
+		if (line.empty() || line[0] == '>'){ continue; }
+		for (size_t i = 0; i < line.size(); ++i){
+			if (line[i] != '\r' && line[i] != ' '){ ++bases; }
+		}
+	}
+
+	return bases;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	split_args: splits the arguments of a case on spaces
+//
+/////////////////////////////////////////////////////////////////////////////////////
+inline std::vector<std::string> split_args(const std::string &args){
+
+	std::vector<std::string> args_vector;
+	std::istringstream sin(args);
+	std::string arg;
+	while (sin >> arg){ args_vector.push_back(arg); }
+
+	return args_vector;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		json_string: returns s as a quoted JSON string
+/////////////////////////////////////////////////////////////////////////////////////
+inline std::string json_string(const std::string &s){
+
+	std::string quoted = "\"";
+	for (size_t i = 0; i < s.size(); ++i){
+		if (s[i] == '"' || s[i] == '\\'){ quoted += '\\'; }
+		quoted += s[i];
+	}
+
+	return quoted + '"';
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	run_nessie: runs nessie -I input_path -O out_path args and measures the execution
+//
+//	parameters:
+//		nessie_path - path to the nessie binary
+//		input_path - input FASTA file
+//		out_path - output file of nessie
+//		work_dir - working directory of nessie, where the log file is written
+//		args - arguments passed to nessie after -I/-O, separated by spaces
+//		perf_ptr - counters opened on the child, NULL if not requested
+//
+//	note: nessie is run in a child process with stdout and stderr sent to /dev/null,
+//		  the peak memory, the CPU time and the counters are the ones of the child only,
+//		  the child waits on a pipe until the counters are opened and they start at exec
+//
+/////////////////////////////////////////////////////////////////////////////////////
+inline child_run run_nessie(const std::string &nessie_path, const std::string &input_path, const std::string &out_path,
+							const std::string &work_dir, const std::string &args, PerfCounters *perf_ptr = NULL){
+
+	std::vector<std::string> args_vector;
+	args_vector.push_back(nessie_path);
+	args_vector.push_back("-I");
+	args_vector.push_back(input_path);
+	args_vector.push_back("-O");
+	args_vector.push_back(out_path);
+	std::vector<std::string> case_args = split_args(args);
+	args_vector.insert(args_vector.end(), case_args.begin(), case_args.end());
+
+	std::vector<char*> argv_vector;
+	for (size_t i = 0; i < args_vector.size(); ++i){ argv_vector.push_back(const_cast<char*>(args_vector[i].c_str())); }
+	argv_vector.push_back(NULL);
+
+	int sync_pipe[2];
+	if (pipe(sync_pipe) != 0){ throw std::runtime_error("pipe failed"); }
+
+	struct timespec start, stop;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	pid_t pid = fork();
+	if (pid < 0){ throw std::runtime_error("fork failed"); }
+	if (pid == 0){	// child
+		char go;
+		close(sync_pipe[1]);
+		if (read(sync_pipe[0], &go, 1) != 1){ _exit(127); }
+		close(sync_pipe[0]);
+		if (chdir(work_dir.c_str()) != 0){ _exit(127); }
+		int null_fd = open("/dev/null", O_WRONLY);
+		if (null_fd >= 0){ dup2(null_fd, 1); dup2(null_fd, 2); close(null_fd); }
+		execv(nessie_path.c_str(), &argv_vector[0]);
+		_exit(127);
+	}
+
+	close(sync_pipe[0]);
+	if (perf_ptr){ perf_ptr->open(pid, true); }
+	if (write(sync_pipe[1], "x", 1) != 1){ throw std::runtime_error("can not start the child"); }
+	close(sync_pipe[1]);
+
+	int status = 0;
+	struct rusage usage;
+	if (wait4(pid, &status, 0, &usage) < 0){ throw std::runtime_error("wait4 failed"); }
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+
+	child_run run;
+	run.seconds = (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) * 1e-9;
+	run.cpu_seconds = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+	run.peak_rss_kb = usage.ru_maxrss;
+	run.status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+
+	return run;
+}
+
+#endif /* BENCH_UTIL_H */
@@ -0,0 +1,315 @@
+/**************************************************************************************
+*
+**	BENCH (genome_generator.cpp)
+*		Deterministic generator of synthetic genomes for the benchmarks.
+*		The background sequence follows the requested GC content, tandem and interspersed repeats,
+*		runs of N and mirror, palindromic and triplex forming motifs are planted at random positions.
+*		The same seed and parameters always produce the same FASTA file.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+// INCLUDE
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <stdint.h>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS Random DEFINITION
+//		Random -- class constructor, xorshift64* generator, the sequence depends only on the seed
+//
+//		next -- returns the next 64-bit value
+//		uniform -- returns a value in [0, n)
+//		probability -- returns a value in [0, 1)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class Random{
+
+private:
+	uint64_t state;
+
+public:
+	Random(uint64_t seed){ state = seed ? seed : 0x9E3779B97F4A7C15ULL; }
+	inline uint64_t next(){
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return state * 0x2545F4914F6CDD1DULL;
+	}
+	inline size_t uniform(size_t n){ return (size_t) (next() % n); }
+	inline double probability(){ return (next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT generator_parameters DEFINITION
+//		Structure to store the parameters of the synthetic genome
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct generator_parameters{
+
+	size_t length;	// bases for each record
+	size_t records;	// number of records
+	double gc;	// GC content of the background sequence
+	double repeats;	// fraction of the bases in tandem or interspersed repeats
+	double n_runs;	// runs of N for each Mb
+	size_t n_len;	// length of the runs of N
+	double planted;	// planted motifs for each Mb, mirror, palindromic and triplex in turn
+	size_t arm_min;	// minimum length of the arm of a planted motif
+	size_t arm_max;	// maximum length of the arm of a planted motif
+	uint64_t seed;	// seed of the generator
+	size_t width;	// line width of the FASTA file
+	size_t motifs;	// maximum number of planted motifs written to the motifs file
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		random_base: returns a background base following the GC content
+/////////////////////////////////////////////////////////////////////////////////////
+inline char random_base(Random &rng, double gc){
+
+	double p = rng.probability();
+	if (p < gc){ return (p < gc / 2) ? 'G' : 'C'; }
+	return (p < gc + (1 - gc) / 2) ? 'A' : 'T';
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		complement_base: returns the complement of a base
+/////////////////////////////////////////////////////////////////////////////////////
+inline char complement_base(char base){
+
+	switch (base){
+		case 'A': return 'T';
+		case 'C': return 'G';
+		case 'G': return 'C';
+		case 'T': return 'A';
+	}
+	return 'N';
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	planted_motif: builds a motif with mirror (0), palindromic (1) or triplex forming (2) symmetry
+//
+//	parameters:
+//		rng - random generator
+//		type - symmetry of the motif
+//		param - parameters of the genome
+//
+//	note: triplex forming motifs are purine mirrors
+//
+/////////////////////////////////////////////////////////////////////////////////////
+std::string planted_motif(Random &rng, size_t type, generator_parameters &param){
+
+	size_t arm = param.arm_min + rng.uniform(param.arm_max - param.arm_min + 1);
+	std::string left, right;
+	for (size_t i = 0; i < arm; ++i){
+		if (type == 2){ left += (rng.uniform(2)) ? 'G' : 'A'; }
+		else { left += random_base(rng, param.gc); }
+	}
+	for (size_t i = arm; i > 0; --i){
+		right += (type == 1) ? complement_base(left[i - 1]) : left[i - 1];
+	}
+	if (type != 1 && rng.uniform(2)){	// odd mirrors have a central base
+		return left + ((type == 2) ? 'G' : random_base(rng, param.gc)) + right;
+	}
+	return left + right;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	generate_record: generates the sequence of a record
+//
+//	parameters:
+//		rng - random generator
+//		param - parameters of the genome
+//		motifs_vector - receives the planted motifs
+//
+/////////////////////////////////////////////////////////////////////////////////////
+std::string generate_record(Random &rng, generator_parameters &param, std::vector<std::string> &motifs_vector){
+
+	std::string seq;
+	seq.reserve(param.length);
+
+	// Events are drawn for each base, each event adds a block of known average length
+	double p_planted = param.planted / 1e6;
+	double p_n = param.n_runs / 1e6;
+	double p_repeat = param.repeats / 150;	// repeats of 150 bases on average
+	size_t type = 0;
+
+	while (seq.size() < param.length){
+		double p = rng.probability();
+		if (p < p_planted){
+			std::string motif = planted_motif(rng, type, param);
+			type = (type + 1) % 3;
+			seq += motif;
+			if (motifs_vector.size() < param.motifs){ motifs_vector.push_back(motif); }
+		}
+		else if (p < p_planted + p_n){
+			seq.append(param.n_len, 'N');
+		}
+		else if (p < p_planted + p_n + p_repeat){
+			size_t len = 50 + rng.uniform(201);
+			if (rng.uniform(2) || seq.size() < len){	// tandem repeat of a short unit
+				size_t unit_len = 1 + rng.uniform(6);
+				std::string unit;
+				for (size_t i = 0; i < unit_len; ++i){ unit += random_base(rng, param.gc); }
+				for (size_t i = 0; i < len; ++i){ seq += unit[i % unit_len]; }
+			}
+			else{	// interspersed copy of an earlier segment with 2% mutations
+				size_t from = rng.uniform(seq.size() - len + 1);
+				for (size_t i = 0; i < len; ++i){
+					char base = seq[from + i];
+					if (base == 'N' || rng.uniform(50) == 0){ base = random_base(rng, param.gc); }
+					seq += base;
+				}
+			}
+		}
+		else{
+			seq += random_base(rng, param.gc);
+		}
+	}
+	seq.resize(param.length);
+
+	return seq;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		write_fasta: writes a record in FASTA format
+/////////////////////////////////////////////////////////////////////////////////////
+void write_fasta(std::ostream &fout, const std::string &header, const std::string &seq, size_t width){
+
+	fout << '>' << header << '\n';
+	for (size_t i = 0; i < seq.size(); i += width){
+		fout.write(seq.data() + i, (seq.size() - i < width) ? seq.size() - i : width);
+		fout << '\n';
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		print_h
+/////////////////////////////////////////////////////////////////////////////////////
+void print_h(std::ostream &pout = std::cout){
+
+	pout << "Usage:" << std::endl;
+	pout << "  genome_generator -o outputFile [ADDITIONAL ARGUMENTS]" << std::endl;
+	pout << std::endl;
+	pout << "Additional arguments" << std::endl;
+	pout << "  -m FILEPATH:  file for the planted motifs (fasta/multifasta), usable with nessie -N" << std::endl;
+	pout << "  -l N:  bases for each record [1000000]" << std::endl;
+	pout << "  -r N:  number of records [1]" << std::endl;
+	pout << "  -gc N:  percentage of GC in the background sequence [41]" << std::endl;
+	pout << "  -rep N:  percentage of the bases in tandem or interspersed repeats [10]" << std::endl;
+	pout << "  -n N:  runs of N for each Mb [2]" << std::endl;
+	pout << "  -nl N:  length of the runs of N [1000]" << std::endl;
+	pout << "  -p N:  planted mirror, palindromic and triplex motifs for each Mb [200]" << std::endl;
+	pout << "  -amin N:  minimum length of the arm of a planted motif [6]" << std::endl;
+	pout << "  -amax N:  maximum length of the arm of a planted motif [15]" << std::endl;
+	pout << "  -mn N:  maximum number of motifs written to the motifs file [100]" << std::endl;
+	pout << "  -s N:  seed [1]" << std::endl;
+	pout << "  -w N:  line width [60]" << std::endl;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		main
+/////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char *argv[]){
+
+	generator_parameters param;
+	param.length = 1000000; param.records = 1; param.gc = 0.41; param.repeats = 0.10;
+	param.n_runs = 2; param.n_len = 1000; param.planted = 200; param.arm_min = 6; param.arm_max = 15;
+	param.seed = 1; param.width = 60; param.motifs = 100;
+	std::string out_path, motifs_path;
+
+	for (int i = 1; i < argc; ++i){
+		std::string arg = argv[i];
+		if (arg == "-h" || arg == "--help"){ print_h(); return 0; }
+		if (i + 1 >= argc){
+			std::cerr << "missing value for " << arg << std::endl;
+			print_h(std::cerr);
+			return 1;
+		}
+		char *value = argv[++i];
+		if (arg == "-o"){ out_path = value; }
+		else if (arg == "-m"){ motifs_path = value; }
+		else if (arg == "-l"){ param.length = strtoull(value, NULL, 10); }
+		else if (arg == "-r"){ param.records = strtoull(value, NULL, 10); }
+		else if (arg == "-gc"){ param.gc = atof(value) / 100; }
+		else if (arg == "-rep"){ param.repeats = atof(value) / 100; }
+		else if (arg == "-n"){ param.n_runs = atof(value); }
+		else if (arg == "-nl"){ param.n_len = strtoull(value, NULL, 10); }
+		else if (arg == "-p"){ param.planted = atof(value); }
+		else if (arg == "-amin"){ param.arm_min = strtoull(value, NULL, 10); }
+		else if (arg == "-amax"){ param.arm_max = strtoull(value, NULL, 10); }
+		else if (arg == "-mn"){ param.motifs = strtoull(value, NULL, 10); }
+		else if (arg == "-s"){ param.seed = strtoull(value, NULL, 10); }
+		else if (arg == "-w"){ param.width = strtoull(value, NULL, 10); }
+		else{
+			std::cerr << "non-recognized argument " << arg << std::endl;
+			print_h(std::cerr);
+			return 1;
+		}
+	}
+
+	if (out_path.empty() || !param.length || !param.width || param.arm_min == 0 || param.arm_min > param.arm_max || param.gc < 0 || param.gc > 1){
+		std::cerr << "invalid arguments" << std::endl;
+		print_h(std::cerr);
+		return 1;
+	}
+
+	std::ofstream fout(out_path.c_str());
+	if (!fout){
+		std::cerr << "can not open " << out_path << std::endl;
+		return 1;
+	}
+
+	Random rng(param.seed);
+	std::vector<std::string> motifs_vector;
+	for (size_t r = 0; r < param.records; ++r){
+		char header[64];
+		snprintf(header, sizeof(header), "synthetic_%zu", r);
+		write_fasta(fout, header, generate_record(rng, param, motifs_vector), param.width);
+	}
+	fout.close();
+
+	if (!motifs_path.empty()){
+		std::ofstream mout(motifs_path.c_str());
+		if (!mout){
+			std::cerr << "can not open " << motifs_path << std::endl;
+			return 1;
+		}
+		for (size_t i = 0; i < motifs_vector.size(); ++i){
+			char header[64];
+			snprintf(header, sizeof(header), "planted_%zu", i);
+			write_fasta(mout, header, motifs_vector[i], param.width);
+		}
+	}
+
+	return 0;
+}
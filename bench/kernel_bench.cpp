@@ -0,0 +1,776 @@
+/**************************************************************************************
+*
+**	BENCH (kernel_bench.cpp)
+*		Microbenchmarks for the inner kernels of the Nessie library.
+*		Each kernel is driven over fixed windows of a random sequence for a sweep of kmer lengths
+*		and mismatch/gap budgets, the cost is reported as ns/op and cycles/op.
+*		Before timing, every output of the kernel is checked against a plain reference implementation,
+*		so that an optimized replacement of a kernel can be validated and measured with the same program.
+*		With --perf the hardware counters (IPC, cache, branch and dTLB misses) are read around each kernel.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+// INCLUDE
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <regex.h>
+#include "../src/Nessie.h"
+#include "perf_counters.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define KERNEL_BENCH_TSC 1
+#endif
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT kernel_result DEFINITION
+//		Structure to store the measures for a kernel and a point of the sweep
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct kernel_result{
+
+	std::string kernel;	// name of the kernel
+	std::string params;	// parameters of the point of the sweep
+	size_t ops;	// calls of the kernel timed
+	double ns_per_op;	// wall time for each call
+	double cycles_per_op;	// time stamp counter cycles for each call, 0 if not available
+	size_t checked;	// outputs compared with the reference
+	size_t errors;	// outputs different from the reference
+	perf_values perf;	// counters read while the kernel was timed
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS KernelTimer DEFINITION
+//		KernelTimer -- class constructor, starts the timer
+//
+//		seconds -- returns the seconds elapsed since the start
+//		cycles -- returns the time stamp counter cycles elapsed since the start, 0 if not available
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class KernelTimer{
+
+private:
+	struct timespec start_time;
+	uint64_t start_cycles;
+
+	static inline uint64_t read_cycles(){
+#ifdef KERNEL_BENCH_TSC
+		return __rdtsc();
+#else
+		return 0;
+#endif
+	}
+
+public:
+	KernelTimer(){
+		clock_gettime(CLOCK_MONOTONIC, &start_time);
+		start_cycles = read_cycles();
+	}
+	double seconds(){
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return (now.tv_sec - start_time.tv_sec) + (now.tv_nsec - start_time.tv_nsec) * 1e-9;
+	}
+	uint64_t cycles(){ return read_cycles() - start_cycles; }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT bench_context DEFINITION
+//		Structure to store the sequence and the settings shared by the kernels
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct bench_context{
+
+	std::string sequence;	// random DNA string
+	std::vector<uint8_t> bases;	// sequence encoded one base per element, A = 0, C = 1, G = 2, T = 3
+	Nessie *nessie_ptr;	// Nessie object built on the sequence
+	size_t windows;	// windows used for the kernels working on single kmers
+	double min_time;	// minimum seconds timed for each point of the sweep
+	PerfCounters perf;	// counters read around the timed loops, not open without --perf
+	std::vector<kernel_result> result_vector;
+};
+
+// Volatile sink so that the compiler does not remove the calls timed
+volatile size_t kernel_sink = 0;
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		ref_pack: encodes the bases [start..start + k) into a mask, first base in the lowest bits
+/////////////////////////////////////////////////////////////////////////////////////
+void ref_pack(const std::vector<uint8_t> &bases, size_t start, size_t k, uint8_t *mask_ptr){
+
+	std::memset(mask_ptr, 0, (k + 3) >> 2);
+	for (size_t c = 0; c < k; ++c){ mask_ptr[c >> 2] |= bases[start + c] << ((c & 3) << 1); }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	ref_symmetry: reference for check_mirror_symmetry (type 0) and check_palindrome_symmetry (type 1)
+//
+//	note: the first and last bases must pair, the mismatches are counted on the inner pairs
+//
+/////////////////////////////////////////////////////////////////////////////////////
+bool ref_symmetry(const std::vector<uint8_t> &bases, size_t start, size_t k, size_t max_mm, int type){
+
+	size_t mm_c = 0;
+	for (size_t j = 0; j < (k >> 1); ++j){
+		uint8_t left = bases[start + j], right = bases[start + k - 1 - j];
+		bool pair = (type == 0) ? (left == right) : (left == 3 - right);
+		if (!pair){
+			if (j == 0){ return false; }
+			++mm_c;
+		}
+	}
+
+	return mm_c <= max_mm;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	ref_alignment: reference for routine_check_global_alignment, returns the result and the operations in forward order
+//
+//	note: global alignment of the kmer against its reverse (mirror) or reverse complement (palindrome),
+//		  the best cell on the anti-diagonal i + j = k is traced back preferring match, then up, then left
+//
+/////////////////////////////////////////////////////////////////////////////////////
+bool ref_alignment(const std::vector<uint8_t> &bases, size_t start, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, int type, std::vector<uint8_t> &ops_vector){
+
+	ops_vector.clear();
+	const uint8_t *s = &bases[start];
+	#define REF_SCORE(i, j) (((type == 0) ? (s[(i)] == s[(j)]) : (s[(i)] == 3 - s[(j)])) ? 1 : -1)
+
+	if (REF_SCORE(0, k - 1) < 0){ return false; }
+
+	std::vector<std::vector<long> > score(k + 1, std::vector<long>(k + 1, 0));
+	for (size_t i = 0; i <= k; ++i){ score[i][0] = -(long) i; score[0][i] = -(long) i; }
+
+	long best = 0;
+	size_t best_i = 0, best_j = 0;
+	bool found = false;
+	for (size_t i = 1; i <= k; ++i){
+		for (size_t j = 1; i + j <= k; ++j){
+			score[i][j] = std::max(score[i - 1][j - 1] + REF_SCORE(i - 1, k - j), std::max(score[i - 1][j], score[i][j - 1]) - 1);
+			if (i + j == k && (!found || score[i][j] > best)){
+				found = true;
+				best = score[i][j];
+				best_i = i;
+				best_j = j;
+			}
+		}
+	}
+
+	long min_score = (long) std::max(best_i, best_j) - (long) ((max_gapmm ? max_gapmm : max_mm + max_gap) << 1);
+	if (best < min_score){ return false; }
+
+	size_t i = best_i, j = best_j, mm_c = 0, gap_c = 0;
+	while (i > 0 || j > 0){
+		if (i > 0 && j > 0 && score[i][j] == score[i - 1][j - 1] + REF_SCORE(i - 1, k - j)){
+			if (REF_SCORE(i - 1, k - j) > 0){ ops_vector.push_back(ALIGNMENT_MATCH); }
+			else { ops_vector.push_back(ALIGNMENT_MISMATCH); ++mm_c; }
+			--i; --j;
+		}
+		else if (i > 0 && score[i][j] == score[i - 1][j] - 1){ ops_vector.push_back(ALIGNMENT_UP); ++gap_c; --i; }
+		else { ops_vector.push_back(ALIGNMENT_LEFT); ++gap_c; --j; }
+	}
+	std::reverse(ops_vector.begin(), ops_vector.end());
+	#undef REF_SCORE
+
+	if (max_gapmm){
+		return (gap_c + mm_c <= max_gapmm) && (!max_gap || gap_c <= max_gap) && (!max_mm || mm_c <= max_mm);
+	}
+	return (gap_c <= max_gap) && (mm_c <= max_mm);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		add_result: stores and prints the measures for a point of the sweep
+/////////////////////////////////////////////////////////////////////////////////////
+void add_result(bench_context &ctx, const std::string &kernel, const std::string &params, size_t ops, double seconds, uint64_t cycles, size_t checked, size_t errors){
+
+	kernel_result r;
+	r.kernel = kernel;
+	r.params = params;
+	r.ops = ops;
+	r.ns_per_op = ops ? seconds * 1e9 / ops : 0;
+	r.cycles_per_op = ops ? (double) cycles / ops : 0;
+	r.checked = checked;
+	r.errors = errors;
+	r.perf = ctx.perf.read();
+	ctx.result_vector.push_back(r);
+
+	std::cerr << std::left << std::setw(36) << kernel << std::setw(26) << params << std::right << std::fixed << std::setprecision(2)
+			  << std::setw(12) << r.ns_per_op << " ns/op" << std::setw(12) << r.cycles_per_op << " cycles/op"
+			  << "  checked " << checked;
+	if (r.perf.available[PERF_CYCLES] && r.perf.available[PERF_INSTRUCTIONS] && r.perf.value[PERF_CYCLES]){
+		std::cerr << "  IPC " << r.perf.value[PERF_INSTRUCTIONS] / r.perf.value[PERF_CYCLES];
+	}
+	std::cerr << (errors ? "  ERRORS " : "");
+	if (errors){ std::cerr << errors; }
+	std::cerr << std::endl;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		params_string: formats the parameters of a point of the sweep
+/////////////////////////////////////////////////////////////////////////////////////
+std::string params_string(size_t k, long perc = -1){
+
+	std::ostringstream sout;
+	sout << "k=" << k;
+	if (perc >= 0){ sout << " perc=" << perc; }
+	return sout.str();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	bench_symmetry: check_mirror_symmetry and check_palindrome_symmetry on the BIT_ARRAY of fixed windows
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void bench_symmetry(bench_context &ctx, size_t k, size_t perc, int type){
+
+	size_t windows = std::min(ctx.windows, ctx.bases.size() - k + 1);
+	size_t max_mm = k * perc / 100;
+
+	// Building the BIT_ARRAY of the windows
+	std::vector<BIT_ARRAY*> bitarray_vector(windows * 4);
+	for (size_t w = 0; w < windows; ++w){
+		for (size_t b = 0; b < 4; ++b){ bitarray_vector[w * 4 + b] = bit_array_create(k); }
+		for (size_t c = 0; c < k; ++c){ bit_array_set(bitarray_vector[w * 4 + ctx.bases[w + c]], c); }
+	}
+
+	// Checking
+	size_t errors = 0;
+	for (size_t w = 0; w < windows; ++w){
+		bool result = (type == 0) ? ctx.nessie_ptr->check_mirror_symmetry(&bitarray_vector[w * 4], k, max_mm)
+								  : ctx.nessie_ptr->check_palindrome_symmetry(&bitarray_vector[w * 4], k, max_mm);
+		if (result != ref_symmetry(ctx.bases, w, k, max_mm, type)){ ++errors; }
+	}
+
+	// Timing
+	size_t ops = 0, found = 0;
+	ctx.perf.start();
+	KernelTimer timer;
+	do{
+		for (size_t w = 0; w < windows; ++w){
+			found += (type == 0) ? ctx.nessie_ptr->check_mirror_symmetry(&bitarray_vector[w * 4], k, max_mm)
+								 : ctx.nessie_ptr->check_palindrome_symmetry(&bitarray_vector[w * 4], k, max_mm);
+		}
+		ops += windows;
+	} while (timer.seconds() < ctx.min_time);
+	double seconds = timer.seconds();
+	uint64_t cycles = timer.cycles();
+	ctx.perf.disable();
+	kernel_sink += found;
+
+	for (size_t i = 0; i < bitarray_vector.size(); ++i){ bit_array_free(bitarray_vector[i]); }
+	add_result(ctx, (type == 0) ? "check_mirror_symmetry" : "check_palindrome_symmetry", params_string(k, perc), ops, seconds, cycles, windows, errors);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	bench_alignment: routine_check_global_alignment on the masks of fixed windows
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void bench_alignment(bench_context &ctx, size_t k, size_t perc, int type){
+
+	size_t windows = std::min(ctx.windows, ctx.bases.size() - k + 1);
+	size_t max_mm = k * perc / 100, max_gap = k * perc / 100;
+	size_t mask_len = (k + 3) >> 2;
+
+	std::vector<uint8_t> mask_vector(windows * mask_len);
+	for (size_t w = 0; w < windows; ++w){ ref_pack(ctx.bases, w, k, &mask_vector[w * mask_len]); }
+	std::vector<uint8_t> ops_buffer((k >> 2) + 1);
+	kmer_alignment alignment;
+	alignment.ops_ptr = &ops_buffer[0];
+	alignment.ops_len = 0;
+
+	// Checking result and operations
+	size_t errors = 0;
+	std::vector<uint8_t> ops_vector;
+	for (size_t w = 0; w < windows; ++w){
+		bool result = ctx.nessie_ptr->routine_check_global_alignment(&mask_vector[w * mask_len], &alignment, k, max_mm, max_gap, 0, type);
+		bool ref_result = ref_alignment(ctx.bases, w, k, max_mm, max_gap, 0, type, ops_vector);
+		bool same = (result == ref_result);
+		if (same && result){
+			same = (alignment.ops_len == ops_vector.size());
+			for (size_t i = 0; same && i < ops_vector.size(); ++i){
+				same = (((alignment.ops_ptr[i >> 2] >> ((i & 3) << 1)) & 3) == ops_vector[i]);
+			}
+		}
+		if (!same){ ++errors; }
+	}
+
+	// Timing
+	size_t ops = 0, found = 0;
+	ctx.perf.start();
+	KernelTimer timer;
+	do{
+		for (size_t w = 0; w < windows; ++w){
+			found += ctx.nessie_ptr->routine_check_global_alignment(&mask_vector[w * mask_len], &alignment, k, max_mm, max_gap, 0, type);
+		}
+		ops += windows;
+	} while (timer.seconds() < ctx.min_time);
+	double seconds = timer.seconds();
+	uint64_t cycles = timer.cycles();
+	ctx.perf.disable();
+	kernel_sink += found;
+
+	add_result(ctx, (type == 0) ? "check_global_alignment_mirror" : "check_global_alignment_palindrome", params_string(k, perc), ops, seconds, cycles, windows, errors);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	bench_shift_bitarray_and_mask: routine_shift_bitarray_and_mask sliding over the sequence
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void bench_shift_bitarray_and_mask(bench_context &ctx, size_t k){
+
+	size_t mask_len = (k + 3) >> 2;
+	size_t last = ctx.bases.size() - k;
+	uint8_t mask[mask_len], ref_mask[mask_len];
+	BIT_ARRAY *monomer_bitarray[4];
+	for (size_t b = 0; b < 4; ++b){ monomer_bitarray[b] = bit_array_create(k); }
+
+	// Checking the mask and the BIT_ARRAY after every shift
+	size_t errors = 0, checked = 0;
+	std::memset(mask, 0, mask_len);
+	ctx.nessie_ptr->routine_init_bitarray_and_mask(monomer_bitarray, mask, k, 0);
+	for (size_t i = 1; i <= last && i <= ctx.windows; ++i){
+		ctx.nessie_ptr->routine_shift_bitarray_and_mask(monomer_bitarray, mask, mask_len, k, i);
+		ref_pack(ctx.bases, i, k, ref_mask);
+		bool same = (std::memcmp(mask, ref_mask, mask_len) == 0);
+		for (size_t c = 0; same && c < k; ++c){
+			for (size_t b = 0; b < 4; ++b){
+				if ((bit_array_get(monomer_bitarray[b], c) != 0) != (ctx.bases[i + c] == b)){ same = false; }
+			}
+		}
+		if (!same){ ++errors; }
+		++checked;
+	}
+
+	// Timing
+	size_t ops = 0;
+	ctx.perf.start();
+	KernelTimer timer;
+	do{
+		for (size_t b = 0; b < 4; ++b){ bit_array_clear_all(monomer_bitarray[b]); }
+		std::memset(mask, 0, mask_len);
+		ctx.nessie_ptr->routine_init_bitarray_and_mask(monomer_bitarray, mask, k, 0);
+		for (size_t i = 1; i <= last; ++i){
+			ctx.nessie_ptr->routine_shift_bitarray_and_mask(monomer_bitarray, mask, mask_len, k, i);
+		}
+		ops += last;
+	} while (timer.seconds() < ctx.min_time);
+	double seconds = timer.seconds();
+	uint64_t cycles = timer.cycles();
+	ctx.perf.disable();
+	kernel_sink += mask[0];
+
+	for (size_t b = 0; b < 4; ++b){ bit_array_free(monomer_bitarray[b]); }
+	add_result(ctx, "routine_shift_bitarray_and_mask", params_string(k), ops, seconds, cycles, checked, errors);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	bench_shift_2_right: shift_2_right on a mask of k bases
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void bench_shift_2_right(bench_context &ctx, size_t k){
+
+	size_t mask_len = (k + 3) >> 2;
+	uint8_t mask[mask_len], ref_mask[mask_len];
+
+	// Checking, the shifted mask is the mask of the next window without its last base
+	size_t errors = 0, checked = std::min(ctx.windows, ctx.bases.size() - k);
+	for (size_t w = 0; w < checked; ++w){
+		ref_pack(ctx.bases, w, k, mask);
+		shift_2_right(mask, mask_len);
+		ref_pack(ctx.bases, w + 1, k, ref_mask);
+		size_t last = k - 1;
+		ref_mask[last >> 2] &= ~(BASE_MASK << ((last & 3) << 1));
+		if (std::memcmp(mask, ref_mask, mask_len) != 0){ ++errors; }
+	}
+
+	// Timing, the mask is refilled since the content drains after 4 * mask_len shifts
+	size_t ops = 0, found = 0;
+	ctx.perf.start();
+	KernelTimer timer;
+	do{
+		for (size_t w = 0; w < 1024; ++w){
+			if (!(w & 3)){ std::memset(mask, (uint8_t) w | 0x1B, mask_len); }
+			shift_2_right(mask, mask_len);
+			found += mask[0];
+		}
+		ops += 1024;
+	} while (timer.seconds() < ctx.min_time);
+	double seconds = timer.seconds();
+	uint64_t cycles = timer.cycles();
+	ctx.perf.disable();
+	kernel_sink += found;
+
+	add_result(ctx, "shift_2_right", params_string(k), ops, seconds, cycles, checked, errors);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	bench_hash_insert: HashTable::insert_kmer for the kmers of the first 4 * windows positions,
+//					   the Kmer is allocated and filled as in the scans
+//
+//	note: the cost of an insertion grows with the kmers already in the bucket
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void bench_hash_insert(bench_context &ctx, size_t k){
+
+	size_t windows = std::min(ctx.windows << 2, ctx.bases.size() - k + 1);
+
+	// Timing, every pass fills a new HashTable
+	size_t ops = 0;
+	double seconds = 0;
+	uint64_t cycles = 0;
+	HashTable *hash_table_ptr = NULL;
+	ctx.perf.reset();
+	do{
+		delete hash_table_ptr;
+		hash_table_ptr = new HashTable();
+		ctx.perf.enable();
+		KernelTimer timer;
+		for (size_t w = 0; w < windows; ++w){
+			Kmer *kmer_ptr = new Kmer(k);
+			ref_pack(ctx.bases, w, k, kmer_ptr->kmer_mask_ptr);
+			kmer_ptr->indexes.push_back(w);
+			kmer_ptr->counts = 1;
+			hash_table_ptr->insert_kmer(kmer_ptr);
+		}
+		seconds += timer.seconds();
+		cycles += timer.cycles();
+		ctx.perf.disable();
+		ops += windows;
+	} while (seconds < ctx.min_time);
+
+	// Checking the counts of the last HashTable against a std::map
+	std::map<std::string, size_t> ref_map;
+	for (size_t w = 0; w < windows; ++w){ ++ref_map[ctx.sequence.substr(w, k)]; }
+	std::ostringstream sout;
+	hash_table_ptr->print_table(sout, true, false);
+	std::istringstream sin(sout.str());
+	std::string line, kmer;
+	size_t errors = 0, checked = 0;
+	while (std::getline(sin, line)){
+		if (line.compare(0, 2, "$|") == 0){ kmer = line.substr(line.find('|', 2) + 1); }
+		else if (line.compare(0, 9, "@counts: ") == 0){
+			std::map<std::string, size_t>::iterator IT = ref_map.find(kmer);
+			if (IT == ref_map.end() || IT->second != strtoull(line.c_str() + 9, NULL, 10)){ ++errors; }
+			++checked;
+		}
+	}
+	if (checked != ref_map.size() || hash_table_ptr->count_kmers() != ref_map.size()){ ++errors; }
+	delete hash_table_ptr;
+
+	add_result(ctx, "HashTable::insert_kmer", params_string(k), ops, seconds, cycles, checked, errors);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	bench_kmers_unique: routine_get_kmers_k_unique over the whole sequence, one op for each kmer
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void bench_kmers_unique(bench_context &ctx, size_t k){
+
+	size_t windows = ctx.bases.size() - k + 1;
+	size_t mask_len = (k + 3) >> 2;
+	uint8_t mask[mask_len];
+
+	// Reference keys, sorted and unique
+	std::set<uint64_t> ref_set;
+	for (size_t w = 0; w < windows; ++w){
+		ref_pack(ctx.bases, w, k, mask);
+		ref_set.insert(ctx.nessie_ptr->routine_convert_to_uint64(mask, mask_len));
+	}
+
+	// Checking
+	std::list<uint64_t> *list_ptr = ctx.nessie_ptr->routine_get_kmers_k_unique(k, 0, ctx.bases.size() - 1);
+	size_t errors = (list_ptr->size() == ref_set.size() && std::equal(list_ptr->begin(), list_ptr->end(), ref_set.begin())) ? 0 : 1;
+	delete list_ptr;
+
+	// Timing
+	size_t ops = 0;
+	ctx.perf.start();
+	KernelTimer timer;
+	do{
+		list_ptr = ctx.nessie_ptr->routine_get_kmers_k_unique(k, 0, ctx.bases.size() - 1);
+		kernel_sink += list_ptr->size();
+		delete list_ptr;
+		ops += windows;
+	} while (timer.seconds() < ctx.min_time);
+	double seconds = timer.seconds();
+	uint64_t cycles = timer.cycles();
+	ctx.perf.disable();
+
+	add_result(ctx, "routine_get_kmers_k_unique", params_string(k), ops, seconds, cycles, 1, errors);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	ref_quadruplex_tracts: tracts of four or more runs of base as the matches of the POSIX regex
+//						   (B{run_min,}[ACGT]{loop_min,loop_max}){3,}B{run_min,}, leftmost longest and not overlapping
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void ref_quadruplex_tracts(const std::string &sequence, char base, size_t run_min, size_t loop_min, size_t loop_max, std::vector<size_t> &tract_vector){
+
+	std::ostringstream pattern;
+	pattern << "(" << base << "{" << run_min << ",}[ACGT]{" << loop_min << "," << loop_max << "}){3,}" << base << "{" << run_min << ",}";
+	regex_t regex;
+	if (regcomp(&regex, pattern.str().c_str(), REG_EXTENDED)){ throw std::runtime_error("can not compile " + pattern.str()); }
+
+	regmatch_t match;
+	size_t i = 0;
+	while (i < sequence.size() && !regexec(&regex, sequence.c_str() + i, 1, &match, i ? REG_NOTBOL : 0)){
+		tract_vector.push_back(i + match.rm_so);
+		tract_vector.push_back(match.rm_eo - match.rm_so);
+		i += match.rm_eo;
+	}
+	regfree(&regex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	bench_quadruplex_tracts: routine_get_quadruplex_tracts for G-runs and C-runs over G-rich sequences, one op for each base
+//
+//	note: before timing the tracts are checked against the regex (ref_quadruplex_tracts) on G-rich random sequences
+//		  and on sequences where a long run must be split into several runs, e.g. GGGGGGGAGGGAGGG
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void bench_quadruplex_tracts(bench_context &ctx, size_t run_min, size_t loop_min, size_t loop_max){
+
+	// G-rich sequences, the same for every point of the sweep
+	std::vector<std::string> sequence_vector;
+	sequence_vector.push_back("GGGGGGGAGGGAGGG");
+	sequence_vector.push_back("GGGGGGGGGGGGGGG");
+	sequence_vector.push_back("CCCCCCCTCCCTCCC");
+	sequence_vector.push_back("CCCCCCCCCCCCCCC");
+	sequence_vector.push_back("AGGGTGGGGGGGGGGTTTTTTTTTGGGAGGGAGGGAGGGGGGGGGAGGG");
+	uint64_t state = 7;
+	for (size_t s = 0; s < 200; ++s){
+		std::string sequence;
+		for (size_t i = 0; i < 500; ++i){
+			state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+			size_t r = (state >> 56) % 20;	// G 50%, C 20%, A 15%, T 15%
+			sequence += (r < 10) ? 'G' : (r < 14) ? 'C' : (r < 17) ? 'A' : 'T';
+		}
+		sequence_vector.push_back(sequence);
+	}
+
+	// Checking
+	size_t errors = 0, checked = 0;
+	std::string timed_sequence;
+	for (size_t s = 0; s < sequence_vector.size(); ++s){
+		const std::string &sequence = sequence_vector[s];
+		timed_sequence += sequence;
+		Nessie nessie(sequence.c_str(), sequence.size());
+		for (size_t b = 0; b < 2; ++b){
+			std::vector<size_t> tract_vector, ref_tract_vector;
+			nessie.routine_get_quadruplex_tracts(tract_vector, b ? ENCODING_C : ENCODING_G, run_min, loop_min, loop_max, 0, sequence.size() - 1);
+			ref_quadruplex_tracts(sequence, b ? 'C' : 'G', run_min, loop_min, loop_max, ref_tract_vector);
+			if (tract_vector != ref_tract_vector){ ++errors; }
+			++checked;
+		}
+	}
+
+	// Timing
+	Nessie nessie(timed_sequence.c_str(), timed_sequence.size());
+	std::vector<size_t> tract_vector;
+	size_t ops = 0;
+	ctx.perf.start();
+	KernelTimer timer;
+	do{
+		tract_vector.clear();
+		nessie.routine_get_quadruplex_tracts(tract_vector, ENCODING_G, run_min, loop_min, loop_max, 0, timed_sequence.size() - 1);
+		nessie.routine_get_quadruplex_tracts(tract_vector, ENCODING_C, run_min, loop_min, loop_max, 0, timed_sequence.size() - 1);
+		kernel_sink += tract_vector.size();
+		ops += timed_sequence.size();
+	} while (timer.seconds() < ctx.min_time);
+	double seconds = timer.seconds();
+	uint64_t cycles = timer.cycles();
+	ctx.perf.disable();
+
+	std::ostringstream params;
+	params << "run_min=" << run_min << " loop=" << loop_min << ".." << loop_max;
+	add_result(ctx, "routine_get_quadruplex_tracts", params.str(), ops, seconds, cycles, checked, errors);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		print_h
+/////////////////////////////////////////////////////////////////////////////////////
+void print_h(std::ostream &pout = std::cout){
+
+	pout << "Usage:" << std::endl;
+	pout << "  kernel_bench [ADDITIONAL ARGUMENTS]" << std::endl;
+	pout << std::endl;
+	pout << "Additional arguments" << std::endl;
+	pout << "  -o FILEPATH:  output file for the JSON report [stdout]" << std::endl;
+	pout << "  -l N:  length of the random sequence [100000]" << std::endl;
+	pout << "  -w N:  windows used for the kernels working on single kmers [4096]" << std::endl;
+	pout << "  -t N:  minimum milliseconds timed for each point of the sweep [200]" << std::endl;
+	pout << "  -f STRING:  run only the kernels whose name contains STRING" << std::endl;
+	pout << "  -s N:  seed [1]" << std::endl;
+	pout << "  --perf:  read the hardware counters around each kernel, reported as null if not available" << std::endl;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		main
+/////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char *argv[]){
+
+	bench_context ctx;
+	size_t length = 100000;
+	uint64_t seed = 1;
+	std::string out_path, filter;
+	bool perf = false;
+	ctx.windows = 4096;
+	ctx.min_time = 0.2;
+
+	for (int i = 1; i < argc; ++i){
+		std::string arg = argv[i];
+		if (arg == "-h" || arg == "--help"){ print_h(); return 0; }
+		if (arg == "--perf"){ perf = true; continue; }
+		if (i + 1 >= argc){
+			std::cerr << "missing value for " << arg << std::endl;
+			print_h(std::cerr);
+			return 1;
+		}
+		char *value = argv[++i];
+		if (arg == "-o"){ out_path = value; }
+		else if (arg == "-l"){ length = strtoull(value, NULL, 10); }
+		else if (arg == "-w"){ ctx.windows = strtoull(value, NULL, 10); }
+		else if (arg == "-t"){ ctx.min_time = atof(value) / 1000; }
+		else if (arg == "-f"){ filter = value; }
+		else if (arg == "-s"){ seed = strtoull(value, NULL, 10); }
+		else{
+			std::cerr << "non-recognized argument " << arg << std::endl;
+			print_h(std::cerr);
+			return 1;
+		}
+	}
+	if (length < 256 || !ctx.windows){
+		std::cerr << "the sequence must be at least 256 bases long and one window is required" << std::endl;
+		return 1;
+	}
+
+	// Random sequence, xorshift64 so that the sequence depends only on the seed
+	uint64_t state = seed ? seed : 1;
+	const char alphabet[] = "ACGT";
+	ctx.sequence.resize(length);
+	ctx.bases.resize(length);
+	for (size_t i = 0; i < length; ++i){
+		state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+		ctx.bases[i] = (uint8_t) (state >> 62);
+		ctx.sequence[i] = alphabet[ctx.bases[i]];
+	}
+	ctx.nessie_ptr = new Nessie(ctx.sequence.c_str(), length);
+
+	// Hardware counters, the kernels are timed as usual if they are not available
+	if (perf){ ctx.perf.open(); }
+	if (perf && !ctx.perf.is_open(PERF_CYCLES)){ std::cerr << "hardware counters are not available (perf_event_open failed), they are reported as null" << std::endl; }
+
+	// Sweep
+	size_t k_symmetry[] = {8, 16, 32, 64, 128};
+	size_t k_alignment[] = {8, 16, 32, 64};
+	size_t k_keys[] = {8, 12, 16, 24, 32};
+	size_t perc[] = {0, 10, 20};
+	#define KERNEL_SELECTED(name) (filter.empty() || std::string(name).find(filter) != std::string::npos)
+
+	for (size_t i = 0; i < 5; ++i){
+		for (size_t p = 0; p < 3; ++p){
+			if (KERNEL_SELECTED("check_mirror_symmetry")){ bench_symmetry(ctx, k_symmetry[i], perc[p], 0); }
+			if (KERNEL_SELECTED("check_palindrome_symmetry")){ bench_symmetry(ctx, k_symmetry[i], perc[p], 1); }
+		}
+	}
+	for (size_t i = 0; i < 4; ++i){
+		for (size_t p = 0; p < 3; ++p){
+			if (KERNEL_SELECTED("check_global_alignment_mirror")){ bench_alignment(ctx, k_alignment[i], perc[p], 0); }
+			if (KERNEL_SELECTED("check_global_alignment_palindrome")){ bench_alignment(ctx, k_alignment[i], perc[p], 1); }
+		}
+	}
+	for (size_t i = 0; i < 5; ++i){
+		if (KERNEL_SELECTED("routine_shift_bitarray_and_mask")){ bench_shift_bitarray_and_mask(ctx, k_symmetry[i]); }
+		if (KERNEL_SELECTED("shift_2_right")){ bench_shift_2_right(ctx, k_symmetry[i]); }
+	}
+	for (size_t i = 0; i < 5; ++i){
+		if (KERNEL_SELECTED("HashTable::insert_kmer")){ bench_hash_insert(ctx, k_keys[i]); }
+		if (KERNEL_SELECTED("routine_get_kmers_k_unique")){ bench_kmers_unique(ctx, k_keys[i]); }
+	}
+	size_t quadruplex_params[][3] = {{3, 1, 7}, {2, 1, 3}, {3, 0, 12}, {4, 2, 5}};
+	for (size_t i = 0; i < 4; ++i){
+		if (KERNEL_SELECTED("routine_get_quadruplex_tracts")){ bench_quadruplex_tracts(ctx, quadruplex_params[i][0], quadruplex_params[i][1], quadruplex_params[i][2]); }
+	}
+	#undef KERNEL_SELECTED
+	delete ctx.nessie_ptr;
+
+	// Report
+	size_t errors = 0;
+	std::ostringstream json;
+	json << "{\n  \"sequence_length\": " << length << ",\n  \"seed\": " << seed << ",\n";
+	json << "  \"cycles\": " << (
+#ifdef KERNEL_BENCH_TSC
+		"\"tsc\""
+#else
+		"null"
+#endif
+		) << ",\n  \"perf\": " << ctx.perf.opened_json() << ",\n  \"results\": [";
+	for (size_t i = 0; i < ctx.result_vector.size(); ++i){
+		kernel_result &r = ctx.result_vector[i];
+		json << (i ? ",\n" : "\n") << "    {\"kernel\": \"" << r.kernel << "\", \"params\": \"" << r.params << "\", \"ops\": " << r.ops
+			 << ", \"ns_per_op\": " << r.ns_per_op << ", \"cycles_per_op\": " << r.cycles_per_op
+			 << ", \"checked\": " << r.checked << ", \"errors\": " << r.errors << ", \"perf_per_op\": " << perf_json(r.perf, r.ops) << "}";
+		errors += r.errors;
+	}
+	json << "\n  ]\n}\n";
+
+	if (out_path.empty()){ std::cout << json.str(); }
+	else{
+		std::ofstream fout(out_path.c_str());
+		if (!fout){ std::cerr << "can not open " << out_path << std::endl; return 1; }
+		fout << json.str();
+	}
+
+	if (errors){
+		std::cerr << errors << " outputs differ from the reference" << std::endl;
+		return 2;
+	}
+
+	return 0;
+}
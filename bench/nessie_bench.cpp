@@ -0,0 +1,364 @@
+/**************************************************************************************
+*
+**	BENCH (nessie_bench.cpp)
+*		Benchmark harness for the nessie program.
+*		Every analysis mode is run over a grid of parameters on each input file,
+*		wall time, peak resident memory and number of hits are measured for every run
+*		and reported as JSON together with the throughput (Mb/s) and the hits per second.
+*		With --perf the hardware counters of each run (IPC, cache, branch and dTLB misses) are reported as well.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+// INCLUDE
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <unistd.h>
+#include "perf_counters.h"
+#include "bench_util.h"
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT bench_case DEFINITION
+//		Structure to store a point of the parameter grid
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct bench_case{
+
+	std::string mode;	// analysis mode, P M T A E L N
+	std::string variant;	// perfect, gapped, MAX, counts, ...
+	std::string args;	// arguments passed to nessie after -I/-O
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT bench_run DEFINITION
+//		Structure to store the measures of a single execution of nessie
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct bench_run{
+
+	double seconds;	// wall time
+	long peak_rss_kb;	// peak resident memory of the child
+	int status;	// exit status, -1 if killed by a signal
+	size_t hits;	// hits in the output
+	perf_values perf;	// counters of the child, not available without --perf
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	add_case: adds a point to the parameter grid
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void add_case(std::vector<bench_case> &grid, const char *mode, const char *variant, const std::string &args){
+
+	bench_case c;
+	c.mode = mode;
+	c.variant = variant;
+	c.args = args;
+	grid.push_back(c);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	build_grid: builds the parameter grid for every analysis mode
+//
+//	parameters:
+//		grid - receives the points of the grid
+//		full - if true every mode is run over several lengths and percentages, a single point for each variant otherwise
+//		motifs_path - motifs file for -N, -N is skipped if empty
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void build_grid(std::vector<bench_case> &grid, bool full, const std::string &motifs_path){
+
+	const char *symmetry[] = {"P", "M", "T"};
+	size_t kmin_quick[] = {8}, kmin_full[] = {6, 10};
+	size_t perc_quick[] = {10}, perc_full[] = {5, 10, 20};
+	size_t *kmins = full ? kmin_full : kmin_quick, n_kmins = full ? 2 : 1;
+	size_t *percs = full ? perc_full : perc_quick, n_percs = full ? 3 : 1;
+
+	for (size_t s = 0; s < 3; ++s){
+		std::string flag = std::string("-") + symmetry[s];
+		std::string purine = (s == 2) ? " -p 10" : "";
+		for (size_t i = 0; i < n_kmins; ++i){
+			std::ostringstream perfect, max_perfect;
+			perfect << flag << " -k " << kmins[i] << " -K " << kmins[i] + 8;
+			add_case(grid, symmetry[s], "perfect", perfect.str());
+			max_perfect << flag << " -k " << kmins[i] << " -K " << kmins[i] + 16 << " -MAX";
+			add_case(grid, symmetry[s], "MAX", max_perfect.str());
+			for (size_t j = 0; j < n_percs; ++j){
+				std::ostringstream gapped, mismatch, max_gapped;
+				gapped << flag << " -k " << kmins[i] << " -K " << kmins[i] + 8 << " -g " << percs[j] << " -m " << percs[j] << purine;
+				add_case(grid, symmetry[s], "gapped", gapped.str());
+				mismatch << flag << " -k " << kmins[i] << " -K " << kmins[i] + 8 << " -m " << percs[j] << purine;
+				add_case(grid, symmetry[s], "mismatch", mismatch.str());
+				max_gapped << flag << " -k " << kmins[i] << " -K " << kmins[i] + 16 << " -MAX -g " << percs[j] << " -m " << percs[j] << purine;
+				add_case(grid, symmetry[s], "MAX_gapped", max_gapped.str());
+			}
+		}
+	}
+
+	add_case(grid, "A", "indexes", "-A -k 8");
+	add_case(grid, "A", "counts", "-A -k 21 -c");
+	if (full){
+		add_case(grid, "A", "indexes", "-A -k 4 -K 12");
+		add_case(grid, "A", "counts", "-A -k 31 -c -B");
+	}
+	add_case(grid, "E", "sliding", "-E -l 1000 -s 500");
+	add_case(grid, "L", "sliding", "-L -l 1000 -s 500 -k 1 -K 8");
+	if (full){
+		add_case(grid, "E", "sliding", "-E -l 100 -s 10");
+		add_case(grid, "L", "sliding", "-L -l 100 -s 10 -k 1 -K 12");
+	}
+	if (!motifs_path.empty()){
+		add_case(grid, "N", "motifs", "-N " + motifs_path);
+		add_case(grid, "N", "both_strands", "-N " + motifs_path + " -B");
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	count_hits: returns the number of hits in a nessie output file
+//
+//	note: the hits are the sum of the @counts lines for the kmers and motifs searches,
+//		  or the number of intervals for the entropy and linguistic complexity
+//
+/////////////////////////////////////////////////////////////////////////////////////
+size_t count_hits(const std::string &path){
+
+	std::ifstream fin(path.c_str());
+	if (!fin){ return 0; }
+
+	size_t hits = 0, intervals = 0;
+	std::string line;
+	while (std::getline(fin, line)){
+		if (line.compare(0, 9, "@counts: ") == 0){ hits += strtoull(line.c_str() + 9, NULL, 10); }
+		else if (!line.empty() && line[0] >= '0' && line[0] <= '9'){ ++intervals; }
+	}
+
+	return hits ? hits : intervals;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	run_case: runs nessie on a grid point and measures the execution (run_nessie)
+//
+//	parameters:
+//		nessie_path - path to the nessie binary
+//		input_path - input FASTA file
+//		work_dir - directory for the output and the log file of nessie
+//		c - grid point
+//		perf_ptr - counters opened on the child, NULL if not requested
+//
+/////////////////////////////////////////////////////////////////////////////////////
+bench_run run_case(const std::string &nessie_path, const std::string &input_path, const std::string &work_dir, const bench_case &c, PerfCounters *perf_ptr){
+
+	std::string out_path = work_dir + "/output.txt";
+	child_run child = run_nessie(nessie_path, input_path, out_path, work_dir, c.args, perf_ptr);
+
+	bench_run run;
+	run.seconds = child.seconds;
+	run.peak_rss_kb = child.peak_rss_kb;
+	run.status = child.status;
+	run.hits = count_hits(out_path);
+	if (perf_ptr){ run.perf = perf_ptr->read(); perf_ptr->close(); }
+	else { run.perf = PerfCounters().read(); }
+	unlink(out_path.c_str());
+
+	return run;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		print_h
+/////////////////////////////////////////////////////////////////////////////////////
+void print_h(std::ostream &pout = std::cout){
+
+	pout << "Usage:" << std::endl;
+	pout << "  nessie_bench -i inputFile [-i inputFile ...] [ADDITIONAL ARGUMENTS]" << std::endl;
+	pout << std::endl;
+	pout << "Additional arguments" << std::endl;
+	pout << "  -b FILEPATH:  nessie binary [./nessie]" << std::endl;
+	pout << "  -o FILEPATH:  output file for the JSON report [stdout]" << std::endl;
+	pout << "  -N FILEPATH:  motifs file for -N, -N is not run if missing" << std::endl;
+	pout << "  -r N:  repetitions of each run, the median time is reported [3]" << std::endl;
+	pout << "  -f STRING:  run only the modes in STRING (e.g. PMT) [PMTAELN]" << std::endl;
+	pout << "  --full:  run the full parameter grid instead of a single point for each variant" << std::endl;
+	pout << "  -w DIRPATH:  working directory for the outputs of nessie [TMPDIR or /tmp]" << std::endl;
+	pout << "  --perf:  read the hardware counters of each run, reported as null if not available" << std::endl;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		main
+/////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char *argv[]){
+
+	std::string nessie_path = "./nessie", out_path, motifs_path, modes = "PMTAELN";
+	std::vector<std::string> inputs_vector;
+	size_t repeats = 3;
+	bool full = false, perf = false;
+	const char *tmp_dir = getenv("TMPDIR");
+	std::string work_root = (tmp_dir && *tmp_dir) ? tmp_dir : "/tmp";
+
+	for (int i = 1; i < argc; ++i){
+		std::string arg = argv[i];
+		if (arg == "-h" || arg == "--help"){ print_h(); return 0; }
+		if (arg == "--full"){ full = true; continue; }
+		if (arg == "--perf"){ perf = true; continue; }
+		if (i + 1 >= argc){
+			std::cerr << "missing value for " << arg << std::endl;
+			print_h(std::cerr);
+			return 1;
+		}
+		char *value = argv[++i];
+		if (arg == "-i"){ inputs_vector.push_back(value); }
+		else if (arg == "-b"){ nessie_path = value; }
+		else if (arg == "-o"){ out_path = value; }
+		else if (arg == "-N"){ motifs_path = value; }
+		else if (arg == "-r"){ repeats = strtoull(value, NULL, 10); }
+		else if (arg == "-f"){ modes = value; }
+		else if (arg == "-w"){ work_root = value; }
+		else{
+			std::cerr << "non-recognized argument " << arg << std::endl;
+			print_h(std::cerr);
+			return 1;
+		}
+	}
+
+	if (inputs_vector.empty() || !repeats){
+		std::cerr << "at least one input and one repetition are required" << std::endl;
+		print_h(std::cerr);
+		return 1;
+	}
+
+	// Paths are made absolute since nessie runs in the working directory
+	char cwd[PATH_MAX];
+	if (!getcwd(cwd, sizeof(cwd))){ std::cerr << "can not read the current directory" << std::endl; return 1; }
+	std::vector<std::string*> paths_vector;
+	paths_vector.push_back(&nessie_path);
+	paths_vector.push_back(&motifs_path);
+	for (size_t i = 0; i < inputs_vector.size(); ++i){ paths_vector.push_back(&inputs_vector[i]); }
+	for (size_t i = 0; i < paths_vector.size(); ++i){
+		std::string &path = *paths_vector[i];
+		if (path.empty() || path[0] == '/'){ continue; }
+		if (path.compare(0, 2, "./") == 0){ path.erase(0, 2); }
+		path = std::string(cwd) + "/" + path;
+	}
+
+	std::string work_template = work_root + "/nessie_bench_XXXXXX";
+	std::vector<char> work_buffer(work_template.begin(), work_template.end());
+	work_buffer.push_back('\0');
+	if (!mkdtemp(&work_buffer[0])){ std::cerr << "can not create the working directory in " << work_root << std::endl; return 1; }
+	std::string work_dir = &work_buffer[0];
+
+	std::vector<bench_case> grid_vector;
+	build_grid(grid_vector, full, motifs_path);
+
+	// Hardware counters, opened on each child, the runs are timed as usual if they are not available
+	PerfCounters perf_counters;
+	PerfCounters *perf_ptr = (perf) ? &perf_counters : NULL;
+	std::string perf_opened = "null";
+	if (perf){
+		perf_counters.open();
+		perf_opened = perf_counters.opened_json();
+		if (!perf_counters.is_open(PERF_CYCLES)){ std::cerr << "hardware counters are not available (perf_event_open failed), they are reported as null" << std::endl; }
+		perf_counters.close();
+	}
+
+	std::ostringstream json;
+	json << "{\n  \"nessie\": " << json_string(nessie_path) << ",\n";
+	json << "  \"grid\": " << json_string(full ? "full" : "quick") << ",\n";
+	json << "  \"repeats\": " << repeats << ",\n";
+	json << "  \"perf\": " << perf_opened << ",\n";
+	json << "  \"results\": [";
+
+	bool first = true;
+	int failed = 0;
+	try{
+		for (size_t i = 0; i < inputs_vector.size(); ++i){
+			size_t bases = count_bases(inputs_vector[i]);
+			for (size_t j = 0; j < grid_vector.size(); ++j){
+				const bench_case &c = grid_vector[j];
+				if (modes.find(c.mode) == std::string::npos){ continue; }
+
+				std::vector<double> seconds_vector;
+				bench_run run;
+				long peak_rss_kb = 0;
+				perf_values perf_sum;	// counters summed over the repetitions
+				for (size_t r = 0; r < repeats; ++r){
+					run = run_case(nessie_path, inputs_vector[i], work_dir, c, perf_ptr);
+					seconds_vector.push_back(run.seconds);
+					peak_rss_kb = std::max(peak_rss_kb, run.peak_rss_kb);
+					if (r){ perf_add(perf_sum, run.perf); }
+					else { perf_sum = run.perf; }
+				}
+				std::vector<double> sorted_vector(seconds_vector);
+				std::sort(sorted_vector.begin(), sorted_vector.end());
+				double median = sorted_vector[sorted_vector.size() / 2];
+				if (run.status != 0){ ++failed; }
+
+				std::cerr << c.mode << " " << c.variant << " [" << c.args << "] " << median << " s" << std::endl;
+
+				json << (first ? "\n" : ",\n");
+				first = false;
+				json << "    {\"input\": " << json_string(inputs_vector[i]) << ", \"bases\": " << bases;
+				json << ", \"mode\": " << json_string(c.mode) << ", \"variant\": " << json_string(c.variant);
+				json << ", \"args\": " << json_string(c.args) << ", \"status\": " << run.status;
+				json << ", \"seconds\": " << median << ", \"seconds_runs\": [";
+				for (size_t r = 0; r < seconds_vector.size(); ++r){ json << (r ? ", " : "") << seconds_vector[r]; }
+				json << "], \"peak_rss_kb\": " << peak_rss_kb << ", \"hits\": " << run.hits;
+				json << ", \"mb_per_s\": " << ((median > 0) ? bases / median / 1e6 : 0);
+				json << ", \"hits_per_s\": " << ((median > 0) ? run.hits / median : 0);
+				json << ", \"perf\": " << perf_json(perf_sum, repeats) << "}";
+			}
+		}
+	}
+	catch (std::exception &e){
+		std::cerr << e.what() << std::endl;
+		unlink((work_dir + "/logfile.txt").c_str());
+		rmdir(work_dir.c_str());
+		return 1;
+	}
+	json << "\n  ]\n}\n";
+
+	unlink((work_dir + "/logfile.txt").c_str());
+	rmdir(work_dir.c_str());
+
+	if (out_path.empty()){ std::cout << json.str(); }
+	else{
+		std::ofstream fout(out_path.c_str());
+		if (!fout){ std::cerr << "can not open " << out_path << std::endl; return 1; }
+		fout << json.str();
+	}
+
+	return failed ? 2 : 0;
+}
@@ -0,0 +1,471 @@
+/**************************************************************************************
+*
+**	BENCH (nessie_regression.cpp)
+*		Regression suite for the nessie program.
+*		Every case of the suite is run over a fixed corpus, the output is normalized
+*		(hits as sets, grouping and order are ignored) and compared with a golden file,
+*		then the case is timed over a larger genome and the throughput is compared with a baseline.
+*		The suite fails if a change alters the results or slows a case down by more than a threshold,
+*		so that a faster kernel can replace a slow one safely.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+// INCLUDE
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <unistd.h>
+#include "bench_util.h"
+
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT regression_case DEFINITION
+//		Structure to store a case of the suite and its results
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct regression_case{
+
+	std::string name;	// name of the case, the golden file is golden/name.txt
+	std::string args;	// arguments passed to nessie after -I/-O
+	std::string golden;	// ok, changed, missing, updated or failed (nessie did not exit with 0)
+	size_t hits;	// lines of the normalized output
+	size_t missing;	// lines of the golden file not in the output
+	size_t extra;	// lines of the output not in the golden file
+	double seconds;	// best CPU time (user + system) on the genome, 0 if not timed
+	double wall_seconds;	// wall time of the same run
+	double mb_per_s;	// throughput on the genome, from the CPU time
+	double baseline_seconds;	// CPU time in the baseline, 0 if not available
+	std::string speed;	// ok, regressed, no_baseline or not_timed
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT kmer_hits DEFINITION
+//		Structure to merge the hits of a kmer when the output is normalized
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct kmer_hits{
+
+	bool has_counts;	// true if @counts was printed
+	size_t counts;	// sum of the @counts, hits printed one by one (-S) are summed
+	std::set<size_t> indexes;	// indexes from @indexes
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_round_numbers: rounds the decimal numbers in a line to 12 significant digits
+//
+//	note: entropy and linguistic complexity are compared up to rounding,
+//		  an optimization that changes the order of the sums must not fail the suite
+//
+/////////////////////////////////////////////////////////////////////////////////////
+std::string routine_round_numbers(const std::string &line){
+
+	std::string rounded, token;
+	for (size_t i = 0; i <= line.size(); ++i){
+		char c = (i < line.size()) ? line[i] : '\0';
+		if (c != '\0' && c != '\t' && c != ' '){ token += c; continue; }
+		char *end_ptr = NULL;
+		double value = strtod(token.c_str(), &end_ptr);
+		if (!token.empty() && *end_ptr == '\0' && token.find_first_of(".eE") != std::string::npos){
+			char buffer[32];
+			snprintf(buffer, sizeof(buffer), "%.12g", value);
+			token = buffer;
+		}
+		rounded += token;
+		if (c != '\0'){ rounded += c; }
+		token.clear();
+	}
+
+	return rounded;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	normalize_output: returns the output of nessie and its log file as a sorted set of lines
+//
+//	parameters:
+//		out_path - output file of nessie
+//		log_path - log file of nessie
+//
+//	note: a kmer becomes a single line RECORD \t SECTION \t $|k|kmer[|alignment] \t counts=N \t indexes=i,j,...
+//		  where SECTION is the motif for -N, hits of the same kmer are merged and the indexes sorted,
+//		  so that hits grouped by kmer or printed as found (-S) give the same lines;
+//		  the other lines (intervals, histograms) are kept with their record and section
+//
+/////////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> normalize_output(const std::string &out_path, const std::string &log_path){
+
+	std::map<std::string, kmer_hits> kmer_map;
+	std::set<std::string> line_set;
+	std::string record = "-", section = "-", kmer_key;
+	std::string line;
+
+	std::ifstream fin(out_path.c_str());
+	while (std::getline(fin, line)){
+		if (line.empty() || line[0] == '#'){ continue; }
+		if (line[0] == '>'){ record = line.substr(1); section = "-"; kmer_key.clear(); }
+		else if (line[0] == '!'){ section = line.substr(1); kmer_key.clear(); }
+		else if (line[0] == '$'){
+			kmer_key = record + '\t' + section + '\t' + line;
+			if (kmer_map.find(kmer_key) == kmer_map.end()){
+				kmer_hits &hits = kmer_map[kmer_key];
+				hits.has_counts = false;
+				hits.counts = 0;
+			}
+		}
+		else if (!kmer_key.empty() && line.compare(0, 9, "@counts: ") == 0){
+			kmer_hits &hits = kmer_map[kmer_key];
+			hits.has_counts = true;
+			hits.counts += strtoull(line.c_str() + 9, NULL, 10);
+		}
+		else if (!kmer_key.empty() && line.compare(0, 10, "@indexes: ") == 0){
+			kmer_hits &hits = kmer_map[kmer_key];
+			const char *ptr = line.c_str() + 10;
+			while (*ptr){
+				char *end_ptr;
+				size_t idx = strtoull(ptr, &end_ptr, 10);
+				if (end_ptr == ptr){ break; }
+				hits.indexes.insert(idx);
+				ptr = end_ptr;
+				if (*ptr == '|'){ ++ptr; }
+			}
+		}
+		else if (line[0] == '@' && line.find(": ") == std::string::npos){	// header of the sliding windows of an interval
+			section = line;
+			kmer_key.clear();
+		}
+		else { line_set.insert(record + '\t' + section + '\t' + routine_round_numbers(line)); }
+	}
+
+	for (std::map<std::string, kmer_hits>::iterator IT = kmer_map.begin(); IT != kmer_map.end(); ++IT){
+		std::ostringstream sout;
+		sout << IT->first << "\tcounts=";
+		if (IT->second.has_counts){ sout << IT->second.counts; }
+		else { sout << '-'; }
+		sout << "\tindexes=";
+		if (IT->second.indexes.empty()){ sout << '-'; }
+		for (std::set<size_t>::iterator it = IT->second.indexes.begin(); it != IT->second.indexes.end(); ++it){
+			sout << ((it == IT->second.indexes.begin()) ? "" : ",") << *it;
+		}
+		line_set.insert(sout.str());
+	}
+
+	// Errors reported for each record
+	std::ifstream flog(log_path.c_str());
+	record = "-";
+	while (std::getline(flog, line)){
+		if (line.empty()){ continue; }
+		if (line[0] == '>'){ record = line.substr(1); }
+		else { line_set.insert("log\t" + record + '\t' + line); }
+	}
+
+	return std::vector<std::string>(line_set.begin(), line_set.end());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	read_cases: reads the cases of the suite, NAME \t ARGUMENTS for each line, # for comments
+//
+/////////////////////////////////////////////////////////////////////////////////////
+std::vector<regression_case> read_cases(const std::string &path, const std::string &motifs_path){
+
+	std::ifstream fin(path.c_str());
+	if (!fin){ throw std::runtime_error("can not open " + path); }
+
+	std::vector<regression_case> case_vector;
+	std::string line;
+	while (std::getline(fin, line)){
+		if (line.empty() || line[0] == '#'){ continue; }
+		size_t tab = line.find('\t');
+		if (tab == std::string::npos){ throw std::runtime_error("missing tab in " + path + ": " + line); }
+		regression_case c;
+		c.name = line.substr(0, tab);
+		c.args = line.substr(tab + 1);
+		size_t pos = c.args.find("MOTIFS");
+		if (pos != std::string::npos){ c.args.replace(pos, 6, motifs_path); }
+		c.hits = 0; c.missing = 0; c.extra = 0;
+		c.seconds = 0; c.wall_seconds = 0; c.mb_per_s = 0; c.baseline_seconds = 0;
+		c.speed = "not_timed";
+		case_vector.push_back(c);
+	}
+
+	return case_vector;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	read_lines: returns the lines of a file, false if the file can not be opened
+//
+/////////////////////////////////////////////////////////////////////////////////////
+bool read_lines(const std::string &path, std::vector<std::string> &lines_vector){
+
+	std::ifstream fin(path.c_str());
+	if (!fin){ return false; }
+	std::string line;
+	while (std::getline(fin, line)){ lines_vector.push_back(line); }
+
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		absolute_path: returns path relative to the current directory as an absolute path
+/////////////////////////////////////////////////////////////////////////////////////
+std::string absolute_path(const std::string &path){
+
+	if (path.empty() || path[0] == '/'){ return path; }
+	char cwd[PATH_MAX];
+	if (!getcwd(cwd, sizeof(cwd))){ throw std::runtime_error("can not read the current directory"); }
+
+	return std::string(cwd) + "/" + ((path.compare(0, 2, "./") == 0) ? path.substr(2) : path);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		print_h
+/////////////////////////////////////////////////////////////////////////////////////
+void print_h(std::ostream &pout = std::cout){
+
+	pout << "Usage:" << std::endl;
+	pout << "  nessie_regression -d DIRPATH [ADDITIONAL ARGUMENTS]" << std::endl;
+	pout << std::endl;
+	pout << "  -d DIRPATH:  folder of the suite, with cases.txt, corpus.fa, motifs.fa and golden/" << std::endl;
+	pout << std::endl;
+	pout << "Additional arguments" << std::endl;
+	pout << "  -b FILEPATH:  nessie binary [./nessie]" << std::endl;
+	pout << "  -o FILEPATH:  output file for the JSON report" << std::endl;
+	pout << "  -p FILEPATH:  genome used to time the cases, the throughput is not checked if missing" << std::endl;
+	pout << "  -r N:  repetitions of each timed run, the best time is used [3]" << std::endl;
+	pout << "  -x N:  percentage of slowdown against the baseline that fails the suite [10]" << std::endl;
+	pout << "  -f STRING:  run only the cases whose name contains STRING" << std::endl;
+	pout << "  -w DIRPATH:  working directory for the outputs of nessie [TMPDIR or /tmp]" << std::endl;
+	pout << "  --update-golden:  write the golden files from the current outputs instead of comparing them" << std::endl;
+	pout << "  --update-baseline:  write DIRPATH/baseline.tsv from the current times instead of comparing them" << std::endl;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		main
+/////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char *argv[]){
+
+	std::string nessie_path = "./nessie", suite_dir, out_path, genome_path, filter;
+	size_t repeats = 3;
+	double threshold = 10;
+	bool update_golden = false, update_baseline = false;
+	const char *tmp_dir = getenv("TMPDIR");
+	std::string work_root = (tmp_dir && *tmp_dir) ? tmp_dir : "/tmp";
+
+	for (int i = 1; i < argc; ++i){
+		std::string arg = argv[i];
+		if (arg == "-h" || arg == "--help"){ print_h(); return 0; }
+		if (arg == "--update-golden"){ update_golden = true; continue; }
+		if (arg == "--update-baseline"){ update_baseline = true; continue; }
+		if (i + 1 >= argc){
+			std::cerr << "missing value for " << arg << std::endl;
+			print_h(std::cerr);
+			return 1;
+		}
+		char *value = argv[++i];
+		if (arg == "-d"){ suite_dir = value; }
+		else if (arg == "-b"){ nessie_path = value; }
+		else if (arg == "-o"){ out_path = value; }
+		else if (arg == "-p"){ genome_path = value; }
+		else if (arg == "-r"){ repeats = strtoull(value, NULL, 10); }
+		else if (arg == "-x"){ threshold = atof(value); }
+		else if (arg == "-f"){ filter = value; }
+		else if (arg == "-w"){ work_root = value; }
+		else{
+			std::cerr << "non-recognized argument " << arg << std::endl;
+			print_h(std::cerr);
+			return 1;
+		}
+	}
+
+	if (suite_dir.empty() || !repeats){
+		std::cerr << "the folder of the suite and one repetition are required" << std::endl;
+		print_h(std::cerr);
+		return 1;
+	}
+	if (update_baseline && genome_path.empty()){
+		std::cerr << "a genome to time the cases [-p] is required to update the baseline" << std::endl;
+		return 1;
+	}
+
+	// Paths are made absolute since nessie runs in the working directory
+	nessie_path = absolute_path(nessie_path);
+	suite_dir = absolute_path(suite_dir);
+	genome_path = absolute_path(genome_path);
+	std::string corpus_path = suite_dir + "/corpus.fa";
+	std::string baseline_path = suite_dir + "/baseline.tsv";
+
+	std::string work_template = work_root + "/nessie_regression_XXXXXX";
+	std::vector<char> work_buffer(work_template.begin(), work_template.end());
+	work_buffer.push_back('\0');
+	if (!mkdtemp(&work_buffer[0])){ std::cerr << "can not create the working directory in " << work_root << std::endl; return 1; }
+	std::string work_dir = &work_buffer[0];
+	std::string nessie_out = work_dir + "/output.txt", nessie_log = work_dir + "/logfile.txt";
+
+	std::vector<regression_case> case_vector;
+	std::map<std::string, double> baseline_map;	// best CPU time for each case
+	size_t genome_bases = 0;
+	int changed = 0, regressed = 0;
+	try{
+		case_vector = read_cases(suite_dir + "/cases.txt", suite_dir + "/motifs.fa");
+		if (!genome_path.empty()){ genome_bases = count_bases(genome_path); }
+
+		std::vector<std::string> baseline_vector;
+		if (!update_baseline && read_lines(baseline_path, baseline_vector)){
+			for (size_t i = 0; i < baseline_vector.size(); ++i){
+				if (baseline_vector[i].empty() || baseline_vector[i][0] == '#'){ continue; }
+				std::istringstream sin(baseline_vector[i]);
+				std::string name;
+				double seconds = 0;
+				if (sin >> name >> seconds){ baseline_map[name] = seconds; }
+			}
+		}
+
+		for (size_t i = 0; i < case_vector.size(); ++i){
+			regression_case &c = case_vector[i];
+			if (!filter.empty() && c.name.find(filter) == std::string::npos){ continue; }
+
+			// Results on the corpus
+			unlink(nessie_log.c_str());
+			std::string golden_path = suite_dir + "/golden/" + c.name + ".txt";
+			if (run_nessie(nessie_path, corpus_path, nessie_out, work_dir, c.args).status != 0){ c.golden = "failed"; ++changed; }
+			else{
+				std::vector<std::string> lines_vector = normalize_output(nessie_out, nessie_log);
+				c.hits = lines_vector.size();
+				std::vector<std::string> golden_vector;
+				if (update_golden){
+					std::ofstream fout(golden_path.c_str());
+					if (!fout){ throw std::runtime_error("can not open " + golden_path); }
+					for (size_t j = 0; j < lines_vector.size(); ++j){ fout << lines_vector[j] << '\n'; }
+					c.golden = "updated";
+				}
+				else if (!read_lines(golden_path, golden_vector)){ c.golden = "missing"; ++changed; }
+				else{
+					std::vector<std::string> missing_vector, extra_vector;
+					std::set_difference(golden_vector.begin(), golden_vector.end(), lines_vector.begin(), lines_vector.end(), std::back_inserter(missing_vector));
+					std::set_difference(lines_vector.begin(), lines_vector.end(), golden_vector.begin(), golden_vector.end(), std::back_inserter(extra_vector));
+					c.missing = missing_vector.size();
+					c.extra = extra_vector.size();
+					c.golden = (c.missing || c.extra) ? "changed" : "ok";
+					if (c.missing || c.extra){
+						++changed;
+						for (size_t j = 0; j < missing_vector.size() && j < 5; ++j){ std::cerr << "  - " << missing_vector[j] << std::endl; }
+						for (size_t j = 0; j < extra_vector.size() && j < 5; ++j){ std::cerr << "  + " << extra_vector[j] << std::endl; }
+					}
+				}
+			}
+
+			// Throughput on the genome
+			if (!genome_path.empty() && c.golden != "failed"){
+				double best = -1;
+				for (size_t r = 0; r < repeats; ++r){
+					child_run run = run_nessie(nessie_path, genome_path, nessie_out, work_dir, c.args);	// the CPU time is much less sensitive than the wall time to other processes
+					if (run.status == 0 && (best < 0 || run.cpu_seconds < best)){ best = run.cpu_seconds; c.wall_seconds = run.seconds; }
+				}
+				if (best > 0){
+					c.seconds = best;
+					c.mb_per_s = genome_bases / best / 1e6;
+					std::map<std::string, double>::iterator IT = baseline_map.find(c.name);
+					if (update_baseline){ c.speed = "updated"; }
+					else if (IT == baseline_map.end()){ c.speed = "no_baseline"; }
+					else{	// 10 ms of slack so that the shortest cases do not fail on the resolution of the clock
+						c.baseline_seconds = IT->second;
+						c.speed = (best > IT->second * (1 + threshold / 100) + 0.01) ? "regressed" : "ok";
+						if (c.speed == "regressed"){ ++regressed; }
+					}
+				}
+			}
+
+			std::cerr << c.name << " [" << c.args << "] results " << c.golden;
+			if (c.golden == "changed"){ std::cerr << " (" << c.missing << " missing, " << c.extra << " extra)"; }
+			if (c.seconds > 0){
+				std::cerr << ", " << c.seconds << " s CPU, " << c.mb_per_s << " Mb/s, speed " << c.speed;
+				if (c.baseline_seconds > 0){ std::cerr << " (baseline " << c.baseline_seconds << " s)"; }
+			}
+			std::cerr << std::endl;
+		}
+	}
+	catch (std::exception &e){
+		std::cerr << e.what() << std::endl;
+		unlink(nessie_out.c_str());
+		unlink(nessie_log.c_str());
+		rmdir(work_dir.c_str());
+		return 1;
+	}
+
+	unlink(nessie_out.c_str());
+	unlink(nessie_log.c_str());
+	rmdir(work_dir.c_str());
+
+	// Baseline
+	if (update_baseline){
+		std::ofstream fout(baseline_path.c_str());
+		if (!fout){ std::cerr << "can not open " << baseline_path << std::endl; return 1; }
+		fout << "# best CPU time in seconds for each case on " << genome_path << " (" << genome_bases << " bases)" << std::endl;
+		for (size_t i = 0; i < case_vector.size(); ++i){
+			if (case_vector[i].seconds > 0){ fout << case_vector[i].name << '\t' << case_vector[i].seconds << std::endl; }
+		}
+	}
+
+	// Report
+	if (!out_path.empty()){
+		std::ofstream fout(out_path.c_str());
+		if (!fout){ std::cerr << "can not open " << out_path << std::endl; return 1; }
+		fout << "{\n  \"nessie\": " << json_string(nessie_path) << ",\n";
+		fout << "  \"genome\": " << json_string(genome_path) << ", \"genome_bases\": " << genome_bases << ",\n";
+		fout << "  \"threshold_pct\": " << threshold << ", \"repeats\": " << repeats << ",\n";
+		fout << "  \"changed\": " << changed << ", \"regressed\": " << regressed << ",\n";
+		fout << "  \"cases\": [";
+		bool first = true;
+		for (size_t i = 0; i < case_vector.size(); ++i){
+			regression_case &c = case_vector[i];
+			if (c.golden.empty()){ continue; }
+			fout << (first ? "\n" : ",\n");
+			first = false;
+			fout << "    {\"name\": " << json_string(c.name) << ", \"args\": " << json_string(c.args)
+				 << ", \"results\": " << json_string(c.golden) << ", \"hits\": " << c.hits
+				 << ", \"missing\": " << c.missing << ", \"extra\": " << c.extra
+				 << ", \"seconds\": " << c.seconds << ", \"wall_seconds\": " << c.wall_seconds << ", \"mb_per_s\": " << c.mb_per_s
+				 << ", \"baseline_seconds\": " << c.baseline_seconds << ", \"speed\": " << json_string(c.speed) << "}";
+		}
+		fout << "\n  ]\n}\n";
+	}
+
+	std::cerr << std::endl << changed << " cases with different results, " << regressed << " cases slower than the baseline by more than " << threshold << "%" << std::endl;
+
+	return (changed || regressed) ? 2 : 0;
+}
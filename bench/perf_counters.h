@@ -0,0 +1,288 @@
+/**************************************************************************************
+*
+**	CLASS (perf_counters.h)
+*		PerfCounters reads the Linux perf_event counters of the benchmarks:
+*		cycles, instructions, cache references and misses, branches and branch misses,
+*		dTLB load misses and page faults, from which IPC and miss rates are derived.
+*		Each counter is opened separately, a counter that is not available
+*		(no PMU in a virtual machine, perf_event_paranoid, non-Linux systems) is reported as null
+*		and the benchmarks run as usual.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+// INCLUDE
+#include <string>
+#include <sstream>
+#include <cstring>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define PERF_COUNTERS_LINUX 1
+#endif
+
+
+// CLASS
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+// Counters, in the order of perf_counter_names
+#define PERF_CYCLES 0
+#define PERF_INSTRUCTIONS 1
+#define PERF_CACHE_REFERENCES 2
+#define PERF_CACHE_MISSES 3
+#define PERF_BRANCHES 4
+#define PERF_BRANCH_MISSES 5
+#define PERF_DTLB_LOAD_MISSES 6
+#define PERF_PAGE_FAULTS 7
+#define PERF_COUNTERS 8
+
+static const char *perf_counter_names[PERF_COUNTERS] = {"cycles", "instructions", "cache_references", "cache_misses",
+														"branches", "branch_misses", "dtlb_load_misses", "page_faults"};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT perf_values DEFINITION
+//		Structure to store the values read from the counters
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct perf_values{
+
+	bool available[PERF_COUNTERS];	// false if the counter could not be opened or was never scheduled
+	double value[PERF_COUNTERS];	// values scaled by the time the counter was scheduled, if multiplexed
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS PerfCounters DEFINITION
+//		PerfCounters -- class constructor, no counter is opened
+//		~PerfCounters -- class destructor, closes the counters
+//
+//		open -- opens the counters for a process, returns the number of counters opened
+//		close -- closes the counters
+//		is_open -- returns true if the counter is open, or if at least one counter is open
+//		opened_json -- returns the names of the counters opened as a JSON array, null if none is open
+//		reset -- sets the counters to zero
+//		enable -- starts counting
+//		disable -- stops counting
+//		start -- sets the counters to zero and starts counting
+//		read -- returns the values of the counters
+//
+//	note: only user space is counted, so that the counters are available with perf_event_paranoid up to 2
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class PerfCounters{
+
+private:
+	int fd[PERF_COUNTERS];
+
+	void routine_ioctl(unsigned long request){
+#ifdef PERF_COUNTERS_LINUX
+		for (int i = 0; i < PERF_COUNTERS; ++i){
+			if (fd[i] >= 0){ ioctl(fd[i], request, 0); }
+		}
+#else
+		(void) request;
+#endif
+	}
+
+public:
+	PerfCounters(){
+		for (int i = 0; i < PERF_COUNTERS; ++i){ fd[i] = -1; }
+	}
+	~PerfCounters(){ PerfCounters::close(); }
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//	open -- opens the counters for a process, returns the number of counters opened
+	//
+	//	parameters:
+	//		pid - process to count, 0 for the calling process
+	//		enable_on_exec - if true the counters start when the process calls exec and follow its threads,
+	//						 otherwise they are opened disabled and started with start or enable
+	//
+	/////////////////////////////////////////////////////////////////////////////////////
+	int open(pid_t pid = 0, bool enable_on_exec = false){
+
+		PerfCounters::close();
+#ifdef PERF_COUNTERS_LINUX
+		const uint32_t types[PERF_COUNTERS] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+											   PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_SOFTWARE};
+		const uint64_t configs[PERF_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+												 PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES,
+												 PERF_COUNT_HW_BRANCH_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES,
+												 PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+												 PERF_COUNT_SW_PAGE_FAULTS};
+		int opened = 0;
+		for (int i = 0; i < PERF_COUNTERS; ++i){
+			struct perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = types[i];
+			attr.config = configs[i];
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.inherit = enable_on_exec;	// threads created by the process are counted as well
+			attr.enable_on_exec = enable_on_exec;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			fd[i] = syscall(__NR_perf_event_open, &attr, pid, -1, -1, 0);
+			if (fd[i] >= 0){ ++opened; }
+		}
+		return opened;
+#else
+		(void) pid; (void) enable_on_exec;
+		return 0;
+#endif
+	}
+
+	void close(){
+		for (int i = 0; i < PERF_COUNTERS; ++i){
+			if (fd[i] >= 0){ ::close(fd[i]); fd[i] = -1; }
+		}
+	}
+
+	bool is_open(int counter = -1){
+		if (counter >= 0){ return fd[counter] >= 0; }
+		for (int i = 0; i < PERF_COUNTERS; ++i){
+			if (fd[i] >= 0){ return true; }
+		}
+		return false;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//	opened_json -- returns the names of the counters opened as a JSON array, null if none is open
+	//
+	/////////////////////////////////////////////////////////////////////////////////////
+	std::string opened_json(){
+
+		if (!PerfCounters::is_open()){ return "null"; }
+		std::string names = "[";
+		for (int i = 0; i < PERF_COUNTERS; ++i){
+			if (fd[i] < 0){ continue; }
+			if (names.size() > 1){ names += ", "; }
+			names += '"' + std::string(perf_counter_names[i]) + '"';
+		}
+		return names + "]";
+	}
+
+#ifdef PERF_COUNTERS_LINUX
+	void reset(){ PerfCounters::routine_ioctl(PERF_EVENT_IOC_RESET); }
+	void enable(){ PerfCounters::routine_ioctl(PERF_EVENT_IOC_ENABLE); }
+	void disable(){ PerfCounters::routine_ioctl(PERF_EVENT_IOC_DISABLE); }
+#else
+	void reset(){}
+	void enable(){}
+	void disable(){}
+#endif
+	void start(){ PerfCounters::reset(); PerfCounters::enable(); }
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//	read -- returns the values of the counters
+	//
+	//	note: if the counters were multiplexed the values are scaled by enabled / running time
+	//
+	/////////////////////////////////////////////////////////////////////////////////////
+	perf_values read(){
+
+		perf_values values;
+		for (int i = 0; i < PERF_COUNTERS; ++i){
+			values.available[i] = false;
+			values.value[i] = 0;
+			uint64_t buffer[3];	// value, time enabled, time running
+			if (fd[i] < 0 || ::read(fd[i], buffer, sizeof(buffer)) != (ssize_t) sizeof(buffer)){ continue; }
+			if (!buffer[2]){ continue; }
+			values.available[i] = true;
+			values.value[i] = (double) buffer[0] * ((double) buffer[1] / buffer[2]);
+		}
+		return values;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	perf_add: adds the values of b to a, a counter is available if it is available in both
+//
+/////////////////////////////////////////////////////////////////////////////////////
+inline void perf_add(perf_values &a, const perf_values &b){
+
+	for (int i = 0; i < PERF_COUNTERS; ++i){
+		a.available[i] = a.available[i] && b.available[i];
+		a.value[i] += b.value[i];
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	perf_ratio: returns numerator / denominator * scale as a JSON number, null if not available
+//
+/////////////////////////////////////////////////////////////////////////////////////
+inline std::string perf_ratio(const perf_values &v, int numerator, int denominator, double scale = 1){
+
+	if (!v.available[numerator] || !v.available[denominator] || !v.value[denominator]){ return "null"; }
+	std::ostringstream sout;
+	sout << v.value[numerator] / v.value[denominator] * scale;
+	return sout.str();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	perf_json: returns the counters divided by ops and the derived ratios as a JSON object,
+//			   null if no counter is available
+//
+//	parameters:
+//		v - values of the counters
+//		ops - the counters are reported for each op, e.g. calls of a kernel or runs of a mode
+//
+//	note: ipc is instructions / cycles, cache_miss_rate is cache misses / cache references,
+//		  branch_mpki and dtlb_mpki are the misses for 1000 instructions
+//
+/////////////////////////////////////////////////////////////////////////////////////
+inline std::string perf_json(const perf_values &v, double ops = 1){
+
+	bool any = false;
+	for (int i = 0; i < PERF_COUNTERS; ++i){ any = any || v.available[i]; }
+	if (!any || ops <= 0){ return "null"; }
+
+	std::ostringstream sout;
+	sout << "{";
+	for (int i = 0; i < PERF_COUNTERS; ++i){
+		sout << '"' << perf_counter_names[i] << "\": ";
+		if (v.available[i]){ sout << v.value[i] / ops; }
+		else { sout << "null"; }
+		sout << ", ";
+	}
+	sout << "\"ipc\": " << perf_ratio(v, PERF_INSTRUCTIONS, PERF_CYCLES)
+		 << ", \"cache_miss_rate\": " << perf_ratio(v, PERF_CACHE_MISSES, PERF_CACHE_REFERENCES)
+		 << ", \"branch_mpki\": " << perf_ratio(v, PERF_BRANCH_MISSES, PERF_INSTRUCTIONS, 1000)
+		 << ", \"dtlb_mpki\": " << perf_ratio(v, PERF_DTLB_LOAD_MISSES, PERF_INSTRUCTIONS, 1000) << "}";
+	return sout.str();
+}
+
+#endif /* PERF_COUNTERS_H */
@@ -266,4 +266,176 @@ inline void copy_uint8_t_arry(uint8_t *empty_array_ptr, size_t empty_array_len,
 	}
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	reverse_complement_dna: writes into an array the reverse complement of a DNA string encoded as bit,
+//							works on whole bytes instead of decoding the string base by base
+//
+//	parameters:
+//		rc_array_ptr - ptr to the uint8_t array that receives the reverse complement
+//		array_ptr - ptr to a uint8_t array containing a DNA string encoded as bit
+//		len_array - length of the two arrays
+//		sequence_len - length of the DNA string
+//
+//	note: every byte is complemented and its four bases are reversed, the order of the bytes is reversed
+//		  and the result is shifted to drop the empty bases that padded the last byte
+//
+/////////////////////////////////////////////////////////////////////////////////////
+inline void reverse_complement_dna(uint8_t *rc_array_ptr, uint8_t *array_ptr, size_t len_array, size_t sequence_len){
+
+	// Complementing and reversing the bytes
+	for (size_t i = 0; i < len_array; ++i){
+		uint8_t byte = ~array_ptr[len_array - i - 1];	// complement, xor 11 for each base
+		byte = (byte >> 4) | (byte << 4);	// swapping the two pairs of bases
+		rc_array_ptr[i] = ((byte >> 2) & 0x33) | ((byte & 0x33) << 2);	// swapping the bases within each pair
+	}
+
+	// Dropping the padding, the empty bases of the last byte are now the first bases of the array
+	uint8_t shift_pad = ((len_array << 2) - sequence_len) << 1;
+	if (shift_pad){
+		for (size_t i = 0; i < (len_array - 1); ++i){
+			rc_array_ptr[i] = (rc_array_ptr[i] >> shift_pad) | (rc_array_ptr[i + 1] << (8 - shift_pad));
+		}
+		rc_array_ptr[len_array - 1] >>= shift_pad;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	is_lower_dna: check if a DNA string encoded as bit precedes another one of the same length
+//				  in lexicographic order (A < C < G < T)
+//
+//	parameters:
+//		array_1_ptr - ptr to a uint8_t array containing a DNA string encoded as bit
+//		array_2_ptr - ptr to another uint8_t array containing a DNA string encoded as bit
+//		len_array - length of the two arrays
+//
+/////////////////////////////////////////////////////////////////////////////////////
+inline bool is_lower_dna(uint8_t *array_1_ptr, uint8_t *array_2_ptr, size_t len_array){
+
+	// Iterating trough the uint8_t array bytes up to the first one that differs
+	for (size_t i = 0; i < len_array; ++i){
+		uint8_t diff = array_1_ptr[i] ^ array_2_ptr[i];
+		if (diff){
+			uint8_t shift_DNA = __builtin_ctz(diff) & ~1;	// first base that differs, bases are stored from the lowest bits
+			return ((array_1_ptr[i] >> shift_DNA) & BASE_MASK) < ((array_2_ptr[i] >> shift_DNA) & BASE_MASK);
+		}
+	}
+
+	return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	count_bases_dna: counts the bases of a DNA string encoded as bit, works on 32 bases at a time
+//
+//	parameters:
+//		array_ptr - ptr to a uint8_t array containing a DNA string encoded as bit, the empty bases of the last byte must be 0
+//		len_array - length of the array
+//		sequence_len - length of the DNA string
+//		counts_ptr - ptr to a size_t array of length 4, counts are added in ENCODING order
+//
+/////////////////////////////////////////////////////////////////////////////////////
+inline void count_bases_dna(uint8_t *array_ptr, size_t len_array, size_t sequence_len, size_t *counts_ptr){
+
+	const uint64_t low_bits = 0x5555555555555555ULL;	// lowest bit of every base
+	size_t i = 0;
+
+	for (; i < len_array; i += 8){
+		uint64_t word = 0;
+		std::memcpy(&word, array_ptr + i, ((len_array - i) < 8) ? (len_array - i) : 8);
+		uint64_t high = word >> 1;	// highest bit of every base moved on the lowest one
+		counts_ptr[ENCODING_A] += __builtin_popcountll(~word & ~high & low_bits);
+		counts_ptr[ENCODING_C] += __builtin_popcountll(word & ~high & low_bits);
+		counts_ptr[ENCODING_G] += __builtin_popcountll(~word & high & low_bits);
+		counts_ptr[ENCODING_T] += __builtin_popcountll(word & high & low_bits);
+	}
+
+	counts_ptr[ENCODING_A] -= (((len_array + 7) >> 3) << 5) - sequence_len;	// empty bases after the end of the string are read as A
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT kmer_alignment DEFINITION
+//		Structure to store the alignment of a kmer as 2-bit operations, four operations per uint8_t
+//		with the first operation in the lowest bits. Operations are printed as two digits.
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct kmer_alignment{
+
+	uint8_t *ops_ptr;	// ptr to the uint8_t array storing the operations
+	size_t ops_len;	// number of operations
+};
+
+// Definition of a bit encoding for the alignment operations
+enum
+{
+	ALIGNMENT_UP = 0x0,	// binary: 00, gap
+	ALIGNMENT_MATCH = 0x1,	// binary: 01
+	ALIGNMENT_MISMATCH = 0x2,	// binary: 10
+	ALIGNMENT_LEFT = 0x3	// binary: 11, gap
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	pack_alignment: packs the operations of a traceback into a kmer_alignment, the order is reversed
+//					so that the first operation of the alignment is the last one of the traceback
+//
+//	parameters:
+//		alignment_ptr - ptr to a kmer_alignment, ops_ptr must store at least (trace_len + 3) / 4 uint8_t
+//		trace_ptr - ptr to a uint8_t array with one operation for each element in traceback order
+//		trace_len - number of operations
+//
+/////////////////////////////////////////////////////////////////////////////////////
+inline void pack_alignment(kmer_alignment *alignment_ptr, uint8_t *trace_ptr, size_t trace_len){
+
+	std::memset(alignment_ptr->ops_ptr, 0, (trace_len + 3) >> 2);
+	for (size_t i = 0; i < trace_len; ++i){
+		alignment_ptr->ops_ptr[i >> 2] |= trace_ptr[trace_len - 1 - i] << ((i & 3) << 1);
+	}
+	alignment_ptr->ops_len = trace_len;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT alignment_print_table DEFINITION
+//		Lookup table from a uint8_t storing four operations to the eight digits printed for them
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct alignment_print_table{
+
+	char digits[256][8];
+
+	alignment_print_table(){
+		for (size_t b = 0; b < 256; ++b){
+			for (size_t i = 0; i < 4; ++i){
+				uint8_t op = (b >> (i << 1)) & BASE_MASK;
+				digits[b][(i << 1)] = '0' + (op >> 1);
+				digits[b][(i << 1) + 1] = '0' + (op & 1);
+			}
+		}
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	print_alignment: prints the operations of an alignment as digits, four operations at a time
+//
+//	parameters:
+//		ops_ptr - ptr to a uint8_t array storing the operations
+//		ops_len - number of operations
+//
+/////////////////////////////////////////////////////////////////////////////////////
+inline void print_alignment(uint8_t *ops_ptr, size_t ops_len, std::ostream &fout = std::cout){
+
+	static const alignment_print_table table;
+
+	for (size_t i = 0; i < (ops_len >> 2); ++i){
+		fout.write(table.digits[ops_ptr[i]], 8);
+	}
+	if (ops_len & 3){	// last operations
+		fout.write(table.digits[ops_ptr[ops_len >> 2]], (ops_len & 3) << 1);
+	}
+}
+
 #endif /* FUNCTIONS_H */
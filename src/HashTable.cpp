@@ -26,6 +26,7 @@
 
 
 #include "HashTable.h"
+#include "Stats.h"
 
 /////////////////////////////////////////////////////////////////////////////////////
 //
@@ -79,6 +80,8 @@ void HashTable::insert_kmer(Kmer *kmer_ptr){
 	// Variables
 	LinkedlistKmer *array_ptr;
 	uint16_t idx;
+	NESSIE_STATS_PHASE(STATS_PHASE_HASHING);
+	NESSIE_STATS_ADD(hash_inserts, 1);
 
 	if (array_short_ptr){	// this is the default
 		array_ptr = array_short_ptr;
@@ -86,7 +89,9 @@ void HashTable::insert_kmer(Kmer *kmer_ptr){
 	}
 	else{
 		array_ptr = array_long_ptr;
-		idx = (kmer_ptr->kmer_mask_ptr[1] << 8) | kmer_ptr->kmer_mask_ptr[0];
+		idx = (kmer_ptr->kmer_mask_len > 1)	// kmers shorter than 5 bases are encoded in a single byte
+			  ? (kmer_ptr->kmer_mask_ptr[1] << 8) | kmer_ptr->kmer_mask_ptr[0]
+			  : kmer_ptr->kmer_mask_ptr[0];
 	}
 
 	array_ptr[idx].update_insert_kmer_end(kmer_ptr);
@@ -107,6 +112,8 @@ void HashTable::insert_kmer_var_len(Kmer *kmer_ptr){
 	// Variables
 	LinkedlistKmer *array_ptr;
 	uint16_t idx;
+	NESSIE_STATS_PHASE(STATS_PHASE_HASHING);
+	NESSIE_STATS_ADD(hash_inserts, 1);
 
 	if (array_short_ptr){	// this is the default
 		array_ptr = array_short_ptr;
@@ -114,7 +121,9 @@ void HashTable::insert_kmer_var_len(Kmer *kmer_ptr){
 	}
 	else{
 		array_ptr = array_long_ptr;
-		idx = (kmer_ptr->kmer_mask_ptr[1] << 8) | kmer_ptr->kmer_mask_ptr[0];
+		idx = (kmer_ptr->kmer_mask_len > 1)	// kmers shorter than 5 bases are encoded in a single byte
+			  ? (kmer_ptr->kmer_mask_ptr[1] << 8) | kmer_ptr->kmer_mask_ptr[0]
+			  : kmer_ptr->kmer_mask_ptr[0];
 	}
 
 	array_ptr[idx].update_insert_kmer_end_var_len(kmer_ptr);
@@ -189,6 +198,7 @@ void HashTable::print_table(std::ostream &fout, bool counts, bool indexes){
 
 	LinkedlistKmer *array_ptr;
 	size_t array_len;
+	StatsPhase stats_phase(STATS_PHASE_PRINTING);
 
 	if (array_short_ptr){
 		array_ptr = array_short_ptr;
@@ -220,6 +230,7 @@ void HashTable::print_table_shifted_indexes(size_t start_idx, std::ostream &fout
 
 	LinkedlistKmer *array_ptr;
 	size_t array_len;
+	StatsPhase stats_phase(STATS_PHASE_PRINTING);
 
 	if (array_short_ptr){
 		array_ptr = array_short_ptr;
@@ -0,0 +1,234 @@
+/**************************************************************************************
+*
+**	FUNCTIONS (HitSink.cpp)
+*		Implements the functions of the HashTableSink, CountSink and PrintSink classes.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+#include "HitSink.h"
+#include "Stats.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+// 								CLASS HashTableSink								   //
+/////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	HashTableSink (constructor): initializes the HashTableSink and its HashTable
+//
+//	parameters:
+//		var_len - bool, if true hits of different length are merged by kmer and length (insert_kmer_var_len) [false]
+//		short_array - bool, passed to the HashTable constructor [false]
+//
+/////////////////////////////////////////////////////////////////////////////////////
+HashTableSink::HashTableSink(bool var_len, bool short_array){
+
+	hash_table_ptr = new HashTable(short_array);
+	this->var_len = var_len;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	~HashTableSink (destructor): deletes the HashTable if it has not been released
+//
+/////////////////////////////////////////////////////////////////////////////////////
+HashTableSink::~HashTableSink(){
+
+	if (hash_table_ptr){
+		delete hash_table_ptr;
+		hash_table_ptr = NULL;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	add_hit: stores the hit as a Kmer object into the HashTable,
+//			 mask and alignment are copied since they belong to the scan routine
+//
+//	parameters:
+//		idx - starting index of the hit
+//		k - length of the hit
+//		kmer_mask_ptr - ptr to the uint8_t array encoding the kmer
+//		kmer_mask_len - length of the kmer_mask_ptr array
+//		alignment_ptr - ptr to the alignment for the hit, NULL if not available
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void HashTableSink::add_hit(size_t idx, size_t k, uint8_t *kmer_mask_ptr, size_t kmer_mask_len, kmer_alignment *alignment_ptr){
+
+	if (!hash_table_ptr){ throw std::runtime_error("HashTableSink: the HashTable has already been released"); }
+	NESSIE_STATS_ADD(hits, 1);
+
+	Kmer *kmer_ptr = (alignment_ptr) ? new Kmer(k, alignment_ptr->ops_len) : new Kmer(k);	// defining ptr to new Kmer object
+	copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, kmer_mask_ptr, kmer_mask_len);
+	kmer_ptr->indexes.push_back(idx);
+	kmer_ptr->counts += 1;
+	if (alignment_ptr){
+		std::memcpy(kmer_ptr->alignment_ptr, alignment_ptr->ops_ptr, (alignment_ptr->ops_len + 3) >> 2);
+	}
+
+	// Adding Kmer to the HashTable
+	if (var_len){
+		hash_table_ptr->insert_kmer_var_len(kmer_ptr);
+	}
+	else{
+		hash_table_ptr->insert_kmer(kmer_ptr);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_hash_table_ptr: returns a ptr to the HashTable, the HashTable is still owned by the HashTableSink
+//
+/////////////////////////////////////////////////////////////////////////////////////
+HashTable *HashTableSink::get_hash_table_ptr(){
+
+	return hash_table_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	release_hash_table_ptr: returns a ptr to the HashTable, the caller is responsible to delete it
+//
+/////////////////////////////////////////////////////////////////////////////////////
+HashTable *HashTableSink::release_hash_table_ptr(){
+
+	HashTable *tmp_ptr = hash_table_ptr;
+	hash_table_ptr = NULL;
+
+	return tmp_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// 								CLASS CountSink									   //
+/////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CountSink (constructor): initializes the counters
+//
+/////////////////////////////////////////////////////////////////////////////////////
+CountSink::CountSink(){
+
+	counts = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	add_hit: increases the counters for the hits, nothing else is stored
+//
+//	parameters:
+//		idx - starting index of the hit
+//		k - length of the hit
+//		kmer_mask_ptr - ptr to the uint8_t array encoding the kmer
+//		kmer_mask_len - length of the kmer_mask_ptr array
+//		alignment_ptr - ptr to the alignment for the hit, NULL if not available
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void CountSink::add_hit(size_t idx, size_t k, uint8_t *kmer_mask_ptr, size_t kmer_mask_len, kmer_alignment *alignment_ptr){
+
+	NESSIE_STATS_ADD(hits, 1);
+	if (k >= counts_k.size()){
+		counts_k.resize(k + 1, 0);
+	}
+	counts_k[k] += 1;
+	counts += 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_counts: returns the number of hits received
+//
+/////////////////////////////////////////////////////////////////////////////////////
+size_t CountSink::get_counts(){
+
+	return counts;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_counts_k: returns the number of hits of length k received
+//
+//	parameters:
+//		k - length of the hits
+//
+/////////////////////////////////////////////////////////////////////////////////////
+size_t CountSink::get_counts_k(size_t k){
+
+	if (k >= counts_k.size()){
+		return 0;
+	}
+
+	return counts_k[k];
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+// 								CLASS PrintSink									   //
+/////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	PrintSink (constructor): initializes the PrintSink
+//
+//	parameters:
+//		fout - ostream element to be used for printing [cout]
+//		counts - bool value, if true print the counts information for the hit [true]
+//		indexes - bool value, if true print the index for the hit [true]
+//		start_idx - starting index used to shift all the printed indexes [0]
+//
+/////////////////////////////////////////////////////////////////////////////////////
+PrintSink::PrintSink(std::ostream &fout, bool counts, bool indexes, size_t start_idx){
+
+	fout_ptr = &fout;
+	this->counts = counts;
+	this->indexes = indexes;
+	this->start_idx = start_idx;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	add_hit: prints the hit using the same format of Kmer::print_full
+//
+//	parameters:
+//		idx - starting index of the hit
+//		k - length of the hit
+//		kmer_mask_ptr - ptr to the uint8_t array encoding the kmer
+//		kmer_mask_len - length of the kmer_mask_ptr array
+//		alignment_ptr - ptr to the alignment for the hit, NULL if not available
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void PrintSink::add_hit(size_t idx, size_t k, uint8_t *kmer_mask_ptr, size_t kmer_mask_len, kmer_alignment *alignment_ptr){
+
+	NESSIE_STATS_ADD(hits, 1);
+
+	// Print
+	*fout_ptr << "$|" << k << '|';
+	print_to_string_no_nl(kmer_mask_ptr, k, *fout_ptr);	// print kmer as string
+	if (alignment_ptr){
+		*fout_ptr << '|';
+		print_alignment(alignment_ptr->ops_ptr, alignment_ptr->ops_len, *fout_ptr);
+	}
+	*fout_ptr << '\n';	// no flush, the hits may be millions
+	if (counts){
+		*fout_ptr << "@counts: " << 1 << '\n';
+	}
+	if (indexes){
+		*fout_ptr << "@indexes: " << idx + start_idx << '|' << '\n';
+	}
+}
@@ -0,0 +1,157 @@
+/**************************************************************************************
+*
+**	CLASS (HitSink.h)
+*		HitSink is the interface used by the Nessie scan routines to deliver hits as soon as they are found,
+*		without building the HashTable of Kmer objects first.
+*		A hit is described by its starting index, its length, the kmer encoded as bit set and the alignment (if gaps are allowed).
+*		HashTableSink, CountSink and PrintSink are the sinks provided with the library.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+// INCLUDE CHECK
+#ifndef __IOSTREAM_H_INCLUDED
+#define __IOSTREAM_H_INCLUDED
+#include <iostream>
+#endif /* __IOSTREAM_H_INCLUDED */
+
+#ifndef __STDINT_H_INCLUDED
+#define __STDINT_H_INCLUDED
+#include <stdint.h>
+#endif /*__STDINT_H_INCLUDED */
+
+#ifndef __VECTOR_H_INCLUDED
+#define __VECTOR_H_INCLUDED
+#include <vector>
+#endif /* __VECTOR_H_INCLUDED */
+
+#ifndef __FUNCTIONS_H_INCLUDED
+#define __FUNCTIONS_H_INCLUDED
+#include "Functions.h"
+#endif /* __FUNCTIONS_H_INCLUDED */
+
+#ifndef __LINKEDLISTKMER_H_INCLUDED
+#define __LINKEDLISTKMER_H_INCLUDED
+#include "LinkedlistKmer.h"
+#endif /* __LINKEDLISTKMER_H_INCLUDED */
+
+#ifndef __HASHTABLE_H_INCLUDED
+#define __HASHTABLE_H_INCLUDED
+#include "HashTable.h"
+#endif /* __HASHTABLE_H_INCLUDED */
+
+
+// CLASS
+#ifndef HITSINK_H
+#define HITSINK_H
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS HitSink DEFINITION
+//		~HitSink -- class destructor
+//
+//		add_hit -- receives a hit from the scan routine
+//
+//	note: kmer_mask_ptr and alignment_ptr belong to the scan routine and are valid only during the call,
+//		  a sink that needs to keep them has to copy them
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class HitSink{
+
+public:
+	virtual ~HitSink(){};
+	virtual void add_hit(size_t idx, size_t k, uint8_t *kmer_mask_ptr, size_t kmer_mask_len, kmer_alignment *alignment_ptr) = 0;
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS HashTableSink DEFINITION
+//		HashTableSink -- class constructor
+//		~HashTableSink -- class destructor, deletes the HashTable if it has not been released
+//
+//		add_hit -- stores the hit as a Kmer object into the HashTable, merging copies of the same kmer
+//		get_hash_table_ptr -- returns a ptr to the HashTable
+//		release_hash_table_ptr -- returns a ptr to the HashTable, the ownership is moved to the caller
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class HashTableSink : public HitSink{
+
+private:
+	HashTable *hash_table_ptr;
+	bool var_len;	// if true kmers of different length are stored in the same HashTable
+
+public:
+	HashTableSink(bool var_len = false, bool short_array = false);
+	~HashTableSink();
+	void add_hit(size_t idx, size_t k, uint8_t *kmer_mask_ptr, size_t kmer_mask_len, kmer_alignment *alignment_ptr);
+	HashTable *get_hash_table_ptr();
+	HashTable *release_hash_table_ptr();
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS CountSink DEFINITION
+//		CountSink -- class constructor
+//
+//		add_hit -- increases the counter for the hits
+//		get_counts -- returns the number of hits received
+//		get_counts_k -- returns the number of hits of length k received
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class CountSink : public HitSink{
+
+private:
+	size_t counts;	// counts of all the hits
+	std::vector<size_t> counts_k;	// counts of the hits by length
+
+public:
+	CountSink();
+	void add_hit(size_t idx, size_t k, uint8_t *kmer_mask_ptr, size_t kmer_mask_len, kmer_alignment *alignment_ptr);
+	size_t get_counts();
+	size_t get_counts_k(size_t k);
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS PrintSink DEFINITION
+//		PrintSink -- class constructor
+//
+//		add_hit -- prints the hit to the ostream as soon as it is received
+//
+//	note: every hit is printed as a Kmer with counts 1 and a single index, hits are not aggregated,
+//		  the output keeps the order in which the scan routine delivers the hits
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class PrintSink : public HitSink{
+
+private:
+	std::ostream *fout_ptr;	// ptr to the ostream used for printing
+	bool counts;	// if true print the counts information for the hit
+	bool indexes;	// if true print the index for the hit
+	size_t start_idx;	// starting index used to shift the printed indexes
+
+public:
+	PrintSink(std::ostream &fout = std::cout, bool counts = true, bool indexes = true, size_t start_idx = 0);
+	void add_hit(size_t idx, size_t k, uint8_t *kmer_mask_ptr, size_t kmer_mask_len, kmer_alignment *alignment_ptr);
+};
+
+#endif /* HITSINK_H */
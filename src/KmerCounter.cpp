@@ -0,0 +1,852 @@
+/**************************************************************************************
+*
+**	FUNCTIONS (KmerCounter.cpp)
+*		Implements the functions of the KmerCounter class.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+#include <algorithm>
+#include <queue>
+#include <cstdlib>
+#include <unistd.h>
+#include <pthread.h>
+#include "KmerCounter.h"
+
+// Out-of-core constants
+#define MINIMIZER_LEN 12	// length of the minimizers used to partition the keys
+#define BUCKETS_MAX 4096	// maximum number of buckets
+#define SPLIT_LEVEL_MAX 4	// maximum number of times a bucket larger than the memory limit is split
+#define READ_KEYS 65536	// number of keys read at once from a bucket file
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_mix_key -- returns a 64-bit hash for a key (finalizer of MurmurHash3)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+static inline uint64_t routine_mix_key(uint64_t key){
+
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ULL;
+	key ^= key >> 33;
+
+	return key;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT routine_compare_top DEFINITION
+//		Orders the distinct kmers by decreasing counts, kmers with the same counts by key
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct routine_compare_top{
+
+	std::vector<uint64_t> *key_vector_ptr;
+	std::vector<size_t> *counts_vector_ptr;
+
+	routine_compare_top(std::vector<uint64_t> *key_vector_ptr, std::vector<size_t> *counts_vector_ptr){
+		this->key_vector_ptr = key_vector_ptr;
+		this->counts_vector_ptr = counts_vector_ptr;
+	}
+
+	bool operator()(size_t i, size_t j) const{
+		if ((*counts_vector_ptr)[i] != (*counts_vector_ptr)[j]){
+			return (*counts_vector_ptr)[i] > (*counts_vector_ptr)[j];
+		}
+		return (*key_vector_ptr)[i] < (*key_vector_ptr)[j];
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT routine_compare_heap DEFINITION
+//		Orders (counts, key) pairs so that the top of a priority_queue is the lowest in the top kmers
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct routine_compare_heap{
+
+	bool operator()(const std::pair<uint64_t, uint64_t> &a, const std::pair<uint64_t, uint64_t> &b) const{
+		if (a.first != b.first){
+			return a.first > b.first;
+		}
+		return a.second < b.second;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT bucket_reader DEFINITION
+//		Reads the sorted keys and counts of a counted bucket during the merge
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct bucket_reader{
+
+	kmer_bucket *bucket_ptr;	// bucket read
+	std::vector<uint64_t> buffer;	// keys and counts read from the file
+	size_t pos;	// position of the next key in the buffer
+	size_t remaining;	// keys and counts still to be read from the file
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT count_thread_arg DEFINITION
+//		Arguments for the threads that count the buckets
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct count_thread_arg{
+
+	KmerCounter *counter_ptr;
+	size_t *next_ptr;	// index of the next bucket to be counted
+	size_t *errors_ptr;	// number of threads that failed
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	KmerCounter (constructor): initializes an empty KmerCounter, keys are counted in memory
+//
+//	parameters:
+//		k - length of the kmers counted, up to 32 bases are stored in a key
+//		canonical - bool value, if true the keys added are canonical kmers [false]
+//
+/////////////////////////////////////////////////////////////////////////////////////
+KmerCounter::KmerCounter(size_t k, bool canonical){
+
+	if (!k || k > 32){ throw std::invalid_argument("KmerCounter: k must be in range [1..32]"); }
+
+	this->k = k;
+	this->canonical = canonical;
+	counted = false;
+	external = false;
+	max_mem = 0;
+	threads = 1;
+	bucket_keys = 0;
+	buffer_keys = 0;
+	distinct = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	KmerCounter (constructor): initializes an empty KmerCounter, keys are counted out-of-core
+//							   if the expected keys do not fit in the memory limit
+//
+//	parameters:
+//		k - length of the kmers counted, up to 32 bases are stored in a key
+//		canonical - bool value, if true the keys added are canonical kmers
+//		max_mem - memory limit in bytes for the keys, 0 for no limit
+//		expected_keys - number of keys that are going to be added, used to define the number of buckets
+//		threads - number of buckets counted in parallel [1]
+//		tmp_dir - directory for the temporary bucket files, if NULL TMPDIR or /tmp is used [NULL]
+//
+//	note: every thread sorts a bucket in memory (the keys and a buffer of the same size),
+//		  the buckets are sized to use half of the memory available to a thread to leave room for unbalanced minimizers
+//
+/////////////////////////////////////////////////////////////////////////////////////
+KmerCounter::KmerCounter(size_t k, bool canonical, size_t max_mem, size_t expected_keys, size_t threads, const char *tmp_dir){
+
+	if (!k || k > 32){ throw std::invalid_argument("KmerCounter: k must be in range [1..32]"); }
+	if (!threads){ throw std::invalid_argument("KmerCounter: at least one thread is needed"); }
+
+	this->k = k;
+	this->canonical = canonical;
+	this->max_mem = max_mem;
+	this->threads = threads;
+	counted = false;
+	distinct = 0;
+
+	// Keys are counted in memory if they fit, a key and the radix sort buffer take 16 bytes
+	external = (max_mem && ((expected_keys << 4) > max_mem));
+	if (!external){
+		bucket_keys = 0;
+		buffer_keys = 0;
+		return;
+	}
+
+	// Temporary directory
+	if (tmp_dir){ this->tmp_dir = tmp_dir; }
+	else if (getenv("TMPDIR")){ this->tmp_dir = getenv("TMPDIR"); }
+	else { this->tmp_dir = "/tmp"; }
+
+	// Sizing the buckets
+	bucket_keys = (max_mem / threads) >> 4;
+	if (bucket_keys < 1024){ throw std::invalid_argument("KmerCounter: memory limit is too low"); }
+	size_t buckets = (expected_keys / (bucket_keys >> 1)) + 1;
+	if (buckets < threads){ buckets = threads; }
+	if (buckets > BUCKETS_MAX){ buckets = BUCKETS_MAX; }
+
+	// Buffers for the buckets use up to a quarter of the memory limit
+	buffer_keys = (max_mem >> 2) / (buckets << 3);
+	if (buffer_keys > 8192){ buffer_keys = 8192; }
+	if (buffer_keys < 64){ buffer_keys = 64; }
+
+	for (size_t i = 0; i < buckets; ++i){
+		bucket_vector.push_back(KmerCounter::routine_open_bucket());
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	~KmerCounter (destructor): closes the temporary files left
+//
+/////////////////////////////////////////////////////////////////////////////////////
+KmerCounter::~KmerCounter(){
+
+	for (size_t i = 0; i < bucket_vector.size(); ++i){
+		if (bucket_vector[i]){ KmerCounter::routine_close_bucket(bucket_vector[i]); }
+	}
+	for (size_t i = 0; i < counted_vector.size(); ++i){
+		if (counted_vector[i]){ KmerCounter::routine_close_bucket(counted_vector[i]); }
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_k: returns the length of the kmers counted
+//
+/////////////////////////////////////////////////////////////////////////////////////
+size_t KmerCounter::get_k(){
+
+	return k;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_canonical: returns true if the keys are canonical kmers
+//
+/////////////////////////////////////////////////////////////////////////////////////
+bool KmerCounter::get_canonical(){
+
+	return canonical;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_external: returns true if the keys are counted out-of-core
+//
+/////////////////////////////////////////////////////////////////////////////////////
+bool KmerCounter::get_external(){
+
+	return external;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_radix_sort: sorts the keys by LSD radix sort, one byte at each pass
+//
+//	parameters:
+//		keys_vector - keys to be sorted
+//		buffer_vector - buffer of the same size of keys_vector
+//
+//	note: only the 2 * k bits used by the keys are sorted
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void KmerCounter::routine_radix_sort(std::vector<uint64_t> &keys_vector, std::vector<uint64_t> &buffer_vector){
+
+	// Variables
+	size_t keys_len = keys_vector.size();
+	size_t passes = ((k << 1) + 7) >> 3;	// bytes used by the keys
+	uint64_t *from_ptr = &keys_vector[0];
+	uint64_t *to_ptr = &buffer_vector[0];
+
+	for (size_t p = 0; p < passes; ++p){
+		size_t shift = p << 3;
+		size_t bucket[256];
+		std::memset(bucket, 0, sizeof(bucket));
+
+		// Counting the keys for each value of the byte
+		for (size_t i = 0; i < keys_len; ++i){
+			++bucket[(from_ptr[i] >> shift) & 0xFF];
+		}
+
+		// Converting the counts into starting offsets
+		size_t offset = 0;
+		for (size_t b = 0; b < 256; ++b){
+			size_t tmp = bucket[b];
+			bucket[b] = offset;
+			offset += tmp;
+		}
+
+		// Scattering the keys, the order of equal bytes is kept
+		for (size_t i = 0; i < keys_len; ++i){
+			to_ptr[bucket[(from_ptr[i] >> shift) & 0xFF]++] = from_ptr[i];
+		}
+
+		uint64_t *tmp_ptr = from_ptr;
+		from_ptr = to_ptr;
+		to_ptr = tmp_ptr;
+	}
+
+	// After an odd number of passes the sorted keys are in the buffer
+	if (passes & 1){
+		keys_vector.swap(buffer_vector);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_open_bucket: returns a ptr to a new bucket with an empty temporary file
+//
+//	note: the file is unlinked as soon as it is created, it is removed when closed or if the program ends
+//
+/////////////////////////////////////////////////////////////////////////////////////
+kmer_bucket *KmerCounter::routine_open_bucket(){
+
+	std::string path = tmp_dir + "/nessie_kmers_XXXXXX";
+	std::vector<char> path_vector(path.begin(), path.end());
+	path_vector.push_back('\0');
+
+	int fd = mkstemp(&path_vector[0]);
+	if (-1 == fd){ throw std::runtime_error("KmerCounter: can not create a temporary file in " + tmp_dir); }
+	unlink(&path_vector[0]);
+
+	kmer_bucket *bucket_ptr = new kmer_bucket;
+	bucket_ptr->file_ptr = fdopen(fd, "w+b");
+	if (!bucket_ptr->file_ptr){
+		close(fd);
+		delete bucket_ptr;
+		throw std::runtime_error("KmerCounter: can not open a temporary file");
+	}
+	bucket_ptr->keys = 0;
+
+	return bucket_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_close_bucket: closes the temporary file of a bucket and deletes the bucket
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void KmerCounter::routine_close_bucket(kmer_bucket *bucket_ptr){
+
+	fclose(bucket_ptr->file_ptr);
+	delete bucket_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_flush_bucket: writes the keys buffered for a bucket to its file
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void KmerCounter::routine_flush_bucket(kmer_bucket *bucket_ptr){
+
+	size_t len = bucket_ptr->buffer.size();
+	if (!len){ return; }
+
+	if (fwrite(&bucket_ptr->buffer[0], sizeof(uint64_t), len, bucket_ptr->file_ptr) != len){
+		throw std::runtime_error("KmerCounter: error writing a temporary file, check the space available in " + tmp_dir);
+	}
+	bucket_ptr->keys += len;
+	bucket_ptr->buffer.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_get_bucket: returns the index of the bucket for a key
+//
+//	parameters:
+//		key - key that encodes the kmer
+//
+//	note: the minimizer is the substring of length MINIMIZER_LEN with the lowest hash,
+//		  a kmer always goes to the same bucket and the kmers that share a minimizer are kept together
+//
+/////////////////////////////////////////////////////////////////////////////////////
+size_t KmerCounter::routine_get_bucket(uint64_t key){
+
+	size_t m = (k < MINIMIZER_LEN) ? k : MINIMIZER_LEN;
+	uint64_t mask_m = (32 == m) ? ~((uint64_t) 0) : ((((uint64_t) 1) << (m << 1)) - 1);
+	uint64_t min_hash = ~((uint64_t) 0);
+
+	for (size_t i = 0; i <= (k - m); ++i){
+		uint64_t hash = routine_mix_key(key & mask_m);
+		if (hash < min_hash){ min_hash = hash; }
+		key >>= 2;
+	}
+
+	return (size_t) (routine_mix_key(min_hash) % bucket_vector.size());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_split_bucket: splits a bucket larger than the memory available to a thread,
+//						  the smaller buckets are added to bucket_vector
+//
+//	parameters:
+//		bucket_ptr - bucket to split, the bucket is closed
+//		level - number of times the keys have been already split
+//
+//	note: keys are split by hash, the same key always goes to the same bucket.
+//		  After SPLIT_LEVEL_MAX splits the bucket is kept as it is, it contains few distinct keys with very high counts
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void KmerCounter::routine_split_bucket(kmer_bucket *bucket_ptr, size_t level){
+
+	if ((bucket_ptr->keys <= bucket_keys) || (level >= SPLIT_LEVEL_MAX)){
+		bucket_vector.push_back(bucket_ptr);
+		return;
+	}
+
+	// Scattering the keys to the smaller buckets
+	size_t buckets = (bucket_ptr->keys / (bucket_keys >> 1)) + 1;
+	std::vector<kmer_bucket*> split_vector;
+	for (size_t i = 0; i < buckets; ++i){
+		split_vector.push_back(KmerCounter::routine_open_bucket());
+	}
+
+	std::vector<uint64_t> read_vector(READ_KEYS);
+	rewind(bucket_ptr->file_ptr);
+	size_t remaining = bucket_ptr->keys;
+	while (remaining){
+		size_t len = (remaining < READ_KEYS) ? remaining : READ_KEYS;
+		if (fread(&read_vector[0], sizeof(uint64_t), len, bucket_ptr->file_ptr) != len){
+			throw std::runtime_error("KmerCounter: error reading a temporary file");
+		}
+		for (size_t i = 0; i < len; ++i){
+			kmer_bucket *split_ptr = split_vector[routine_mix_key(read_vector[i] + level + 1) % buckets];
+			split_ptr->buffer.push_back(read_vector[i]);
+			if (split_ptr->buffer.size() >= buffer_keys){ KmerCounter::routine_flush_bucket(split_ptr); }
+		}
+		remaining -= len;
+	}
+	KmerCounter::routine_close_bucket(bucket_ptr);
+
+	for (size_t i = 0; i < buckets; ++i){
+		KmerCounter::routine_flush_bucket(split_vector[i]);
+		KmerCounter::routine_split_bucket(split_vector[i], level + 1);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_count_bucket: counts the keys of a bucket in memory and writes the sorted keys and counts
+//
+//	parameters:
+//		bucket_ptr - bucket with the keys, the bucket is closed also if an error occurs
+//		counted_ptr - bucket that receives the distinct keys followed by their counts, ordered by key
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void KmerCounter::routine_count_bucket(kmer_bucket *bucket_ptr, kmer_bucket *counted_ptr){
+
+	// Reading the keys
+	std::vector<uint64_t> keys_vector;
+	try{
+		keys_vector.resize(bucket_ptr->keys);
+		rewind(bucket_ptr->file_ptr);
+		if (bucket_ptr->keys && (fread(&keys_vector[0], sizeof(uint64_t), bucket_ptr->keys, bucket_ptr->file_ptr) != bucket_ptr->keys)){
+			throw std::runtime_error("KmerCounter: error reading a temporary file");
+		}
+	}
+	catch (...){
+		KmerCounter::routine_close_bucket(bucket_ptr);
+		throw;
+	}
+	KmerCounter::routine_close_bucket(bucket_ptr);
+	if (keys_vector.empty()){ return; }
+
+	// Sorting
+	{
+		std::vector<uint64_t> buffer_vector(keys_vector.size());
+		KmerCounter::routine_radix_sort(keys_vector, buffer_vector);
+	}
+
+	// Counting runs of equal keys
+	size_t keys_len = keys_vector.size();
+	uint64_t counts = 1;
+	for (size_t i = 1; i <= keys_len; ++i){
+		if ((i < keys_len) && (keys_vector[i] == keys_vector[i - 1])){
+			++counts;
+		}
+		else{
+			counted_ptr->buffer.push_back(keys_vector[i - 1]);
+			counted_ptr->buffer.push_back(counts);
+			if (counted_ptr->buffer.size() >= READ_KEYS){ KmerCounter::routine_flush_bucket(counted_ptr); }
+			counts = 1;
+		}
+	}
+	KmerCounter::routine_flush_bucket(counted_ptr);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_count_worker: counts the buckets not yet taken by the other threads
+//
+//	parameters:
+//		next_ptr - ptr to the index of the next bucket to be counted, shared by the threads
+//		errors_ptr - ptr to the number of threads that failed, shared by the threads
+//
+//	note: the counters shared by the threads are read and written only with atomic operations,
+//		  the threads stop taking buckets as soon as one of them fails
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void KmerCounter::routine_count_worker(size_t *next_ptr, size_t *errors_ptr){
+
+	try{
+		while (!__sync_fetch_and_add(errors_ptr, 0)){	// atomic read
+			size_t i = __sync_fetch_and_add(next_ptr, 1);	// atomic increment, every bucket is taken by one thread
+			if (i >= bucket_vector.size()){ break; }
+			kmer_bucket *bucket_ptr = bucket_vector[i];
+			bucket_vector[i] = NULL;	// the bucket is closed by routine_count_bucket, also if counting fails
+			KmerCounter::routine_count_bucket(bucket_ptr, counted_vector[i]);
+		}
+	}
+	catch (std::exception &e){
+		__sync_fetch_and_add(errors_ptr, 1);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_count_thread: entry point for the threads that count the buckets
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void *KmerCounter::routine_count_thread(void *arg_ptr){
+
+	count_thread_arg *thread_arg_ptr = (count_thread_arg *) arg_ptr;
+	thread_arg_ptr->counter_ptr->routine_count_worker(thread_arg_ptr->next_ptr, thread_arg_ptr->errors_ptr);
+
+	return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	count_keys: counts the keys added
+//
+//	note: in memory the keys are sorted and replaced with the distinct keys and their counts.
+//		  Out-of-core the buckets larger than the memory available to a thread are split first,
+//		  then every bucket is counted in memory by one of the threads and its sorted keys and counts are written back to disk
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void KmerCounter::count_keys(){
+
+	if (counted){ throw std::runtime_error("KmerCounter: keys have already been counted"); }
+	counted = true;
+
+	// Out-of-core counting
+	if (external){
+		// Splitting the buckets too large
+		std::vector<kmer_bucket*> tmp_vector;
+		tmp_vector.swap(bucket_vector);
+		for (size_t i = 0; i < tmp_vector.size(); ++i){
+			KmerCounter::routine_flush_bucket(tmp_vector[i]);
+			kmer_bucket *bucket_ptr = tmp_vector[i];
+			tmp_vector[i] = NULL;
+			KmerCounter::routine_split_bucket(bucket_ptr, 0);
+		}
+		for (size_t i = 0; i < bucket_vector.size(); ++i){
+			counted_vector.push_back(KmerCounter::routine_open_bucket());
+		}
+
+		// Counting the buckets in parallel
+		size_t next = 0;
+		size_t errors = 0;
+		count_thread_arg thread_arg;
+		thread_arg.counter_ptr = this;
+		thread_arg.next_ptr = &next;
+		thread_arg.errors_ptr = &errors;
+
+		std::vector<pthread_t> thread_vector(threads - 1);
+		size_t started = 0;
+		for (size_t i = 0; i < (threads - 1); ++i){
+			if (pthread_create(&thread_vector[i], NULL, KmerCounter::routine_count_thread, &thread_arg)){ break; }
+			++started;
+		}
+		KmerCounter::routine_count_worker(&next, &errors);	// the calling thread counts too
+		for (size_t i = 0; i < started; ++i){
+			pthread_join(thread_vector[i], NULL);
+		}
+		if (errors){ throw std::runtime_error("KmerCounter: error counting the temporary files, check the space available in " + tmp_dir); }
+		bucket_vector.clear();
+
+		for (size_t i = 0; i < counted_vector.size(); ++i){
+			distinct += counted_vector[i]->keys >> 1;
+		}
+		return;
+	}
+
+	// Counting in memory
+	if (key_vector.empty()){ return; }
+
+	{
+		std::vector<uint64_t> buffer_vector(key_vector.size());
+		KmerCounter::routine_radix_sort(key_vector, buffer_vector);
+	}
+
+	// Counting runs of equal keys, distinct keys are compacted at the beginning of key_vector
+	size_t keys_len = key_vector.size();
+	size_t j = 0;
+	counts_vector.push_back(1);
+	for (size_t i = 1; i < keys_len; ++i){
+		if (key_vector[i] == key_vector[j]){
+			++counts_vector[j];
+		}
+		else{
+			key_vector[++j] = key_vector[i];
+			counts_vector.push_back(1);
+		}
+	}
+	key_vector.resize(j + 1);
+	std::vector<uint64_t>(key_vector).swap(key_vector);	// releasing the memory of the duplicated keys
+	distinct = key_vector.size();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_distinct: returns the number of distinct kmers
+//
+/////////////////////////////////////////////////////////////////////////////////////
+size_t KmerCounter::get_distinct(){
+
+	if (!counted){ throw std::runtime_error("KmerCounter: keys have not been counted"); }
+
+	return distinct;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_print_key: prints the kmer encoded by a key as a string
+//
+//	parameters:
+//		key - key that encodes the kmer, first base in the highest bits
+//		fout - ostream element to be used for printing
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void KmerCounter::routine_print_key(uint64_t key, std::ostream &fout){
+
+	char kmer_str[33];
+	const char bases[4] = {'A', 'C', 'G', 'T'};	// ENCODING order
+
+	for (size_t i = 0; i < k; ++i){
+		kmer_str[k - i - 1] = bases[key & BASE_MASK];
+		key >>= 2;
+	}
+	kmer_str[k] = '\0';
+
+	fout << kmer_str << std::endl;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_print_counts_external: prints the distinct kmers with their counts merging the counted buckets
+//
+//	parameters:
+//		fout - ostream element to be used for printing
+//		min_count - kmers with counts lower than min_count are not printed
+//		top - if not 0 only the top kmers with the highest counts are printed, ordered by decreasing counts
+//
+//	note: every counted bucket is sorted by key and a key is only in one bucket,
+//		  the buckets are merged by a priority_queue on the next key of each bucket
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void KmerCounter::routine_print_counts_external(std::ostream &fout, size_t min_count, size_t top){
+
+	// Initializing the readers
+	std::vector<bucket_reader> reader_vector(counted_vector.size());
+	std::priority_queue<std::pair<uint64_t, size_t>, std::vector<std::pair<uint64_t, size_t> >, std::greater<std::pair<uint64_t, size_t> > > merge_queue;
+	std::priority_queue<std::pair<uint64_t, uint64_t>, std::vector<std::pair<uint64_t, uint64_t> >, routine_compare_heap> top_queue;	// (counts, key)
+
+	for (size_t i = 0; i < counted_vector.size(); ++i){
+		reader_vector[i].bucket_ptr = counted_vector[i];
+		reader_vector[i].pos = 0;
+		reader_vector[i].remaining = counted_vector[i]->keys;
+		rewind(counted_vector[i]->file_ptr);
+	}
+
+	// Reading the first key of each bucket
+	for (size_t i = 0; i < reader_vector.size(); ++i){
+		bucket_reader *reader_ptr = &reader_vector[i];
+		if (reader_ptr->remaining){
+			size_t len = (reader_ptr->remaining < READ_KEYS) ? reader_ptr->remaining : READ_KEYS;
+			reader_ptr->buffer.resize(len);
+			if (fread(&reader_ptr->buffer[0], sizeof(uint64_t), len, reader_ptr->bucket_ptr->file_ptr) != len){
+				throw std::runtime_error("KmerCounter: error reading a temporary file");
+			}
+			reader_ptr->remaining -= len;
+			merge_queue.push(std::make_pair(reader_ptr->buffer[0], i));
+		}
+	}
+
+	// Merging
+	while (!merge_queue.empty()){
+		size_t i = merge_queue.top().second;
+		merge_queue.pop();
+		bucket_reader *reader_ptr = &reader_vector[i];
+		uint64_t key = reader_ptr->buffer[reader_ptr->pos];
+		uint64_t counts = reader_ptr->buffer[reader_ptr->pos + 1];
+		reader_ptr->pos += 2;
+
+		if (counts >= min_count){
+			if (!top){
+				fout << "$|" << k << '|';
+				KmerCounter::routine_print_key(key, fout);
+				fout << "@counts: " << counts << std::endl;
+			}
+			else if (top_queue.size() < top){
+				top_queue.push(std::make_pair(counts, key));
+			}
+			else if (routine_compare_heap()(std::make_pair(counts, key), top_queue.top())){	// better than the lowest in the top kmers
+				top_queue.pop();
+				top_queue.push(std::make_pair(counts, key));
+			}
+		}
+
+		// Next key of the bucket
+		if (reader_ptr->pos >= reader_ptr->buffer.size() && reader_ptr->remaining){
+			size_t len = (reader_ptr->remaining < READ_KEYS) ? reader_ptr->remaining : READ_KEYS;
+			reader_ptr->buffer.resize(len);
+			if (fread(&reader_ptr->buffer[0], sizeof(uint64_t), len, reader_ptr->bucket_ptr->file_ptr) != len){
+				throw std::runtime_error("KmerCounter: error reading a temporary file");
+			}
+			reader_ptr->remaining -= len;
+			reader_ptr->pos = 0;
+		}
+		if (reader_ptr->pos < reader_ptr->buffer.size()){
+			merge_queue.push(std::make_pair(reader_ptr->buffer[reader_ptr->pos], i));
+		}
+	}
+
+	// Printing the top kmers by decreasing counts
+	if (top){
+		std::vector<std::pair<uint64_t, uint64_t> > top_vector;
+		while (!top_queue.empty()){
+			top_vector.push_back(top_queue.top());
+			top_queue.pop();
+		}
+		for (size_t i = top_vector.size(); i > 0; --i){
+			fout << "$|" << k << '|';
+			KmerCounter::routine_print_key(top_vector[i - 1].second, fout);
+			fout << "@counts: " << top_vector[i - 1].first << std::endl;
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	print_counts: prints the distinct kmers with their counts
+//
+//	parameters:
+//		fout - ostream element to be used for printing [cout]
+//		min_count - kmers with counts lower than min_count are not printed [1]
+//		top - if not 0 only the top kmers with the highest counts are printed, ordered by decreasing counts [0]
+//
+//	note: without top the kmers are printed in lexicographic order
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void KmerCounter::print_counts(std::ostream &fout, size_t min_count, size_t top){
+
+	if (!counted){ throw std::runtime_error("KmerCounter: keys have not been counted"); }
+
+	if (external){
+		KmerCounter::routine_print_counts_external(fout, min_count, top);
+		return;
+	}
+
+	if (!top){
+		for (size_t i = 0; i < key_vector.size(); ++i){
+			if (counts_vector[i] >= min_count){
+				fout << "$|" << k << '|';
+				KmerCounter::routine_print_key(key_vector[i], fout);
+				fout << "@counts: " << counts_vector[i] << std::endl;
+			}
+		}
+	}
+	else{
+		// Selecting the kmers that pass min_count and ordering the top ones
+		std::vector<size_t> idx_vector;
+		for (size_t i = 0; i < key_vector.size(); ++i){
+			if (counts_vector[i] >= min_count){
+				idx_vector.push_back(i);
+			}
+		}
+		if (top > idx_vector.size()){ top = idx_vector.size(); }
+		std::partial_sort(idx_vector.begin(), idx_vector.begin() + top, idx_vector.end(), routine_compare_top(&key_vector, &counts_vector));
+
+		for (size_t i = 0; i < top; ++i){
+			fout << "$|" << k << '|';
+			KmerCounter::routine_print_key(key_vector[idx_vector[i]], fout);
+			fout << "@counts: " << counts_vector[idx_vector[i]] << std::endl;
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_histogram: returns the number of distinct kmers for each count
+//
+//	parameters:
+//		histogram_map - map that receives the counts as keys and the number of distinct kmers with those counts as values,
+//			the values are added to the ones already in the map
+//
+//	note: out-of-core the counted buckets are read one after the other, a key is only in one bucket
+//		  and the buckets do not need to be merged
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void KmerCounter::get_histogram(std::map<size_t, size_t> &histogram_map){
+
+	if (!counted){ throw std::runtime_error("KmerCounter: keys have not been counted"); }
+
+	if (!external){
+		for (size_t i = 0; i < counts_vector.size(); ++i){
+			++histogram_map[counts_vector[i]];
+		}
+		return;
+	}
+
+	std::vector<uint64_t> buffer(READ_KEYS);
+	for (size_t i = 0; i < counted_vector.size(); ++i){
+		size_t remaining = counted_vector[i]->keys;
+		rewind(counted_vector[i]->file_ptr);
+		while (remaining){
+			size_t len = (remaining < READ_KEYS) ? remaining : READ_KEYS;	// READ_KEYS is even, (key, count) pairs are never split
+			if (fread(&buffer[0], sizeof(uint64_t), len, counted_vector[i]->file_ptr) != len){
+				throw std::runtime_error("KmerCounter: error reading a temporary file");
+			}
+			remaining -= len;
+			for (size_t j = 1; j < len; j += 2){
+				++histogram_map[buffer[j]];
+			}
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	print_histogram: prints the number of distinct kmers for each count
+//
+//	parameters:
+//		fout - ostream element to be used for printing [cout]
+//		min_count - counts lower than min_count are not printed [1]
+//
+//	note: the histogram is printed as $|k|histogram followed by the number of distinct kmers (@distinct)
+//		  and by a counts|kmers line for each count, ordered by increasing counts
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void KmerCounter::print_histogram(std::ostream &fout, size_t min_count){
+
+	std::map<size_t, size_t> histogram_map;
+	KmerCounter::get_histogram(histogram_map);
+
+	fout << "$|" << k << "|histogram" << std::endl;
+	fout << "@distinct: " << distinct << std::endl;
+	for (std::map<size_t, size_t>::iterator it = histogram_map.lower_bound(min_count); it != histogram_map.end(); ++it){
+		fout << it->first << '|' << it->second << std::endl;
+	}
+}
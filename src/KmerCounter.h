@@ -0,0 +1,164 @@
+/**************************************************************************************
+*
+**	CLASS (KmerCounter.h)
+*		KmerCounter counts the kmers of length k (k <= 32) encoded as 64-bit keys,
+*		positions are never stored and only the counts for the distinct kmers are kept.
+*		The keys are sorted by radix sort and the counts are obtained by counting the runs of equal keys.
+*		If the keys do not fit in the memory limit, they are scattered to temporary bucket files partitioned by minimizer,
+*		the buckets are counted independently in parallel and the sorted counts are merged.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+// INCLUDE CHECK
+#ifndef __IOSTREAM_H_INCLUDED
+#define __IOSTREAM_H_INCLUDED
+#include <iostream>
+#endif /* __IOSTREAM_H_INCLUDED */
+
+#ifndef __STDEXCEPT_H_INCLUDED
+#define __STDEXCEPT_H_INCLUDED
+#include <stdexcept>
+#endif /* __STDEXCEPT_H_INCLUDED */
+
+#ifndef __STDINT_H_INCLUDED
+#define __STDINT_H_INCLUDED
+#include <stdint.h>
+#endif /*__STDINT_H_INCLUDED */
+
+#ifndef __CSTDIO_H_INCLUDED
+#define __CSTDIO_H_INCLUDED
+#include <cstdio>
+#endif /*__CSTDIO_H_INCLUDED */
+
+#ifndef __VECTOR_H_INCLUDED
+#define __VECTOR_H_INCLUDED
+#include <vector>
+#endif /* __VECTOR_H_INCLUDED */
+
+#ifndef __STRING_H_INCLUDED
+#define __STRING_H_INCLUDED
+#include <string>
+#endif /* __STRING_H_INCLUDED */
+
+#ifndef __MAP_H_INCLUDED
+#define __MAP_H_INCLUDED
+#include <map>
+#endif /* __MAP_H_INCLUDED */
+
+#ifndef __FUNCTIONS_H_INCLUDED
+#define __FUNCTIONS_H_INCLUDED
+#include "Functions.h"
+#endif /* __FUNCTIONS_H_INCLUDED */
+
+
+// CLASS
+#ifndef KMERCOUNTER_H
+#define KMERCOUNTER_H
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT kmer_bucket DEFINITION
+//		Structure to store a temporary bucket file with the keys (or the sorted keys and counts) of a partition
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct kmer_bucket{
+
+	FILE *file_ptr;	// ptr to the temporary file, the file is removed when closed
+	size_t keys;	// number of keys written to the file
+	std::vector<uint64_t> buffer;	// keys waiting to be written to the file
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS KmerCounter DEFINITION
+//		KmerCounter -- class constructor, in memory counter
+//		KmerCounter -- class constructor, out-of-core counter if the expected keys do not fit in the memory limit
+//		~KmerCounter -- class destructor, closes the temporary files
+//
+//		get_k -- returns the length of the kmers counted
+//		get_canonical -- returns true if the keys are canonical kmers
+//		get_external -- returns true if the keys are counted out-of-core
+//		add_key -- adds the key for a kmer, the kmer is encoded with the first base in the highest bits
+//		count_keys -- counts the keys added, the keys are replaced with the distinct keys and their counts
+//		get_distinct -- returns the number of distinct kmers, available after count_keys
+//		print_counts -- prints the distinct kmers with their counts, available after count_keys
+//		get_histogram -- returns the number of distinct kmers for each count, available after count_keys
+//		print_histogram -- prints the number of distinct kmers for each count, available after count_keys
+//
+//	note: the keys are stored with the first base in the highest bits, the order of the keys
+//		  is the lexicographic order of the kmers (A < C < G < T)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class KmerCounter{
+
+private:
+	size_t k;	// length of the kmers counted
+	bool canonical;	// if true the keys are canonical kmers, the lower between a kmer and its reverse complement
+	bool counted;	// becomes true after count_keys
+	std::vector<uint64_t> key_vector;	// keys added, distinct keys after count_keys
+	std::vector<size_t> counts_vector;	// counts for the distinct keys, filled by count_keys
+
+	// Out-of-core counting
+	bool external;	// if true the keys are scattered to the buckets
+	size_t max_mem;	// memory limit in bytes
+	size_t threads;	// number of buckets counted in parallel
+	size_t bucket_keys;	// maximum number of keys of a bucket counted in memory by a thread
+	size_t buffer_keys;	// number of keys buffered for each bucket before writing to the file
+	size_t distinct;	// number of distinct kmers
+	std::string tmp_dir;	// directory for the temporary files
+	std::vector<kmer_bucket*> bucket_vector;	// buckets with the keys, partitioned by minimizer
+	std::vector<kmer_bucket*> counted_vector;	// buckets with the sorted keys and counts
+
+	void routine_radix_sort(std::vector<uint64_t> &keys_vector, std::vector<uint64_t> &buffer_vector);
+	void routine_print_key(uint64_t key, std::ostream &fout);
+	kmer_bucket *routine_open_bucket();
+	void routine_close_bucket(kmer_bucket *bucket_ptr);
+	void routine_flush_bucket(kmer_bucket *bucket_ptr);
+	size_t routine_get_bucket(uint64_t key);
+	void routine_split_bucket(kmer_bucket *bucket_ptr, size_t level);
+	void routine_count_bucket(kmer_bucket *bucket_ptr, kmer_bucket *counted_ptr);
+	void routine_count_worker(size_t *next_ptr, size_t *errors_ptr);
+	static void *routine_count_thread(void *arg_ptr);
+	void routine_print_counts_external(std::ostream &fout, size_t min_count, size_t top);
+
+public:
+	KmerCounter(size_t k, bool canonical = false);
+	KmerCounter(size_t k, bool canonical, size_t max_mem, size_t expected_keys, size_t threads = 1, const char *tmp_dir = NULL);
+	~KmerCounter();
+	size_t get_k();
+	bool get_canonical();
+	bool get_external();
+	inline void add_key(uint64_t key){
+		if (!external){ key_vector.push_back(key); return; }
+		kmer_bucket *bucket_ptr = bucket_vector[routine_get_bucket(key)];
+		bucket_ptr->buffer.push_back(key);
+		if (bucket_ptr->buffer.size() >= buffer_keys){ routine_flush_bucket(bucket_ptr); }
+	}
+	void count_keys();
+	size_t get_distinct();
+	void print_counts(std::ostream &fout = std::cout, size_t min_count = 1, size_t top = 0);
+	void get_histogram(std::map<size_t, size_t> &histogram_map);
+	void print_histogram(std::ostream &fout = std::cout, size_t min_count = 1);
+};
+
+#endif /* KMERCOUNTER_H */
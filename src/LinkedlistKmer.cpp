@@ -26,6 +26,68 @@
 
 
 #include "LinkedlistKmer.h"
+#include "Stats.h"
+
+/////////////////////////////////////////////////////////////////////////////////////
+// 								CLASS IndexList							   		   //
+/////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_add_chunk: allocates a new block at the end of the IndexList,
+//					   every block doubles the size of the previous one up to INDEXLIST_CHUNK_MAX
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void IndexList::routine_add_chunk(){
+
+	uint32_t size = INDEXLIST_CHUNK_MIN;
+	if (last_ptr){
+		size = (last_ptr->size < INDEXLIST_CHUNK_MAX) ? (last_ptr->size << 1) : INDEXLIST_CHUNK_MAX;
+	}
+
+	index_chunk *chunk_ptr = (index_chunk*) new uint8_t[offsetof(index_chunk, data) + size];
+	chunk_ptr->next_ptr = NULL;
+	chunk_ptr->size = size;
+	chunk_ptr->used = 0;
+
+	if (last_ptr){ last_ptr->next_ptr = chunk_ptr; }
+	else { first_ptr = chunk_ptr; }
+	last_ptr = chunk_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	append: appends all the indexes of list at the end of the IndexList
+//
+//	parameters:
+//		list - IndexList with the indexes to append
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void IndexList::append(const IndexList &list){
+
+	for (iterator IT = list.begin(); IT != list.end(); ++IT){
+		push_back(*IT);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	clear: removes all the indexes and releases the blocks
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void IndexList::clear(){
+
+	index_chunk *chunk_ptr = first_ptr;
+	while (chunk_ptr){
+		index_chunk *next_ptr = chunk_ptr->next_ptr;
+		delete[] (uint8_t*) chunk_ptr;
+		chunk_ptr = next_ptr;
+	}
+	first_ptr = NULL;
+	last_ptr = NULL;
+	len = 0;
+	last_index = 0;
+	inline_used = 0;
+}
 
 /////////////////////////////////////////////////////////////////////////////////////
 // 								CLASS Kmer								   		   //
@@ -38,7 +100,7 @@
 void Kmer::print(std::ostream &fout, bool counts, bool indexes){
 
 	// Variables
-	std::vector<size_t>::iterator IT;
+	IndexList::iterator IT;
 
 	// Print
 	fout << "$|" << k << '|';
@@ -64,18 +126,14 @@ void Kmer::print(std::ostream &fout, bool counts, bool indexes){
 void Kmer::print_full(std::ostream &fout, bool counts, bool indexes){
 
 	// Variables
-	std::vector<size_t>::iterator IT;
-	std::vector<bool>::reverse_iterator it;
+	IndexList::iterator IT;
 
 	// Print
 	fout << "$|" << k << '|';
 	print_to_string_no_nl(kmer_mask_ptr, k, fout);	// print kmer as string
 	if (alignment_ptr){
 		fout << '|';
-		for (it = alignment_ptr->rbegin(); it != alignment_ptr->rend();){
-			fout << *it;
-			++it;
-		}
+		print_alignment(alignment_ptr, alignment_len, fout);
 	}
 	fout << std::endl;
 	if (counts){
@@ -99,18 +157,14 @@ void Kmer::print_full(std::ostream &fout, bool counts, bool indexes){
 void Kmer::print_full_shifted_indexes(size_t start_idx, std::ostream &fout, bool counts, bool indexes){
 
 	// Variables
-	std::vector<size_t>::iterator IT;
-	std::vector<bool>::reverse_iterator it;
+	IndexList::iterator IT;
 
 	// Print
 	fout << "$|" << k << '|';
 	print_to_string_no_nl(kmer_mask_ptr, k, fout);	// print kmer as string
 	if (alignment_ptr){
 		fout << '|';
-		for (it = alignment_ptr->rbegin(); it != alignment_ptr->rend();){
-			fout << *it;
-			++it;
-		}
+		print_alignment(alignment_ptr, alignment_len, fout);
 	}
 	fout << std::endl;
 	if (counts){
@@ -201,14 +255,16 @@ void LinkedlistKmer::update_insert_kmer_end(Kmer *kmer_ptr){
 		Kmer *next_ptr = first_ptr;
 		while (next_ptr){
 			ptr = next_ptr;
+			NESSIE_STATS_ADD(hash_probes, 1);
 
 			if (hamming_distance_0(ptr->kmer_mask_ptr, ptr->kmer_mask_len, kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len)){
-				ptr->indexes.insert(ptr->indexes.end(), kmer_ptr->indexes.begin(), kmer_ptr->indexes.end());	// non ho capito perchè l'editor da errore, sembra però andare bene
+				ptr->indexes.append(kmer_ptr->indexes);
 				ptr->counts += kmer_ptr->counts;
 				updated = true;
 				delete kmer_ptr;
 				break;
 			}
+			NESSIE_STATS_ADD(hash_collisions, 1);
 			next_ptr = ptr->next_kmer_ptr;
 		}
 
@@ -240,16 +296,18 @@ void LinkedlistKmer::update_insert_kmer_end_var_len(Kmer *kmer_ptr){
 		Kmer *next_ptr = first_ptr;
 		while (next_ptr){
 			ptr = next_ptr;
+			NESSIE_STATS_ADD(hash_probes, 1);
 
 			if (ptr->k == kmer_ptr->k){	// compared kmers are of the same length
 				if (hamming_distance_0(ptr->kmer_mask_ptr, ptr->kmer_mask_len, kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len)){
-					ptr->indexes.insert(ptr->indexes.end(), kmer_ptr->indexes.begin(), kmer_ptr->indexes.end());	// non ho capito perchè l'editor da errore, sembra però andare bene
+					ptr->indexes.append(kmer_ptr->indexes);
 					ptr->counts += kmer_ptr->counts;
 					updated = true;
 					delete kmer_ptr;
 					break;
 				}
 			}
+			NESSIE_STATS_ADD(hash_collisions, 1);
 			next_ptr = ptr->next_kmer_ptr;
 		}
 
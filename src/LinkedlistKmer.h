@@ -50,6 +50,11 @@
 #include <cstring>
 #endif /*__CSTRING_H_INCLUDED */
 
+#ifndef __CSTDDEF_H_INCLUDED
+#define __CSTDDEF_H_INCLUDED
+#include <cstddef>
+#endif /*__CSTDDEF_H_INCLUDED */
+
 #ifndef __VECTOR_H_INCLUDED
 #define __VECTOR_H_INCLUDED
 #include <vector>
@@ -65,6 +70,165 @@
 #ifndef LINKEDLISTKMER_H
 #define LINKEDLISTKMER_H
 
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT index_chunk DEFINITION
+//		Structure to store a block of encoded indexes for IndexList, allocated together with its data
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct index_chunk{
+
+	index_chunk *next_ptr;	// ptr to the next block, NULL for the last block
+	uint32_t size;	// bytes available in data
+	uint32_t used;	// bytes used in data
+	uint8_t data[1];	// encoded indexes, the array extends for size bytes
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS IndexList DEFINITION
+//		IndexList -- class constructor
+//		~IndexList -- class destructor
+//
+//		size -- returns the number of indexes stored
+//		empty -- returns true if no index is stored
+//		push_back -- appends an index at the end of the IndexList
+//		append -- appends all the indexes of a second IndexList
+//		clear -- removes all the indexes
+//		begin -- returns an iterator to the first index
+//		end -- returns an iterator past the last index
+//
+//	note: every index is stored as the difference from the previous one, zigzag and varint encoded,
+//		  sorted indexes take one or two bytes each and unsorted indexes are still stored correctly.
+//		  The first bytes are stored inside the object, then blocks of growing size are chained,
+//		  the indexes can only be read in order by the iterator
+//
+/////////////////////////////////////////////////////////////////////////////////////
+#define INDEXLIST_INLINE_BYTES 15	// bytes stored inside the IndexList before the first block is allocated
+#define INDEXLIST_CHUNK_MIN 32	// size of the first block
+#define INDEXLIST_CHUNK_MAX 4096	// maximum size of a block
+#define INDEXLIST_VARINT_MAX 10	// maximum bytes for a varint encoded 64-bit value
+
+class IndexList{
+
+private:
+	index_chunk *first_ptr;	// ptr to the first block, NULL if all the indexes are stored inline
+	index_chunk *last_ptr;	// ptr to the block receiving the new indexes
+	size_t len;	// number of indexes stored
+	size_t last_index;	// last index stored, reference for the next difference
+	uint8_t inline_used;	// bytes used in inline_data
+	uint8_t inline_data[INDEXLIST_INLINE_BYTES];	// first encoded indexes
+
+	IndexList(const IndexList &);	// not copyable
+	IndexList &operator=(const IndexList &);
+
+	void routine_add_chunk();
+
+public:
+	/////////////////////////////////////////////////////////////////////////////////////
+	//
+	//	CLASS iterator DEFINITION
+	//		Forward iterator decoding the indexes of an IndexList in order
+	//
+	/////////////////////////////////////////////////////////////////////////////////////
+	class iterator{
+
+	private:
+		const uint8_t *data_ptr;	// ptr to the data of the current block
+		size_t used;	// bytes used in the current block
+		size_t pos;	// position of the next encoded value in the current block
+		const index_chunk *next_ptr;	// ptr to the block following the current one
+		size_t left;	// indexes left to read, including the current one
+		size_t value;	// current index
+
+		inline void routine_decode(){
+			if (pos == used){	// moving to the next block
+				data_ptr = next_ptr->data;
+				used = next_ptr->used;
+				next_ptr = next_ptr->next_ptr;
+				pos = 0;
+			}
+			uint64_t zz = 0;
+			size_t shift = 0;
+			uint8_t byte;
+			do{
+				byte = data_ptr[pos++];
+				zz |= (uint64_t) (byte & 0x7F) << shift;
+				shift += 7;
+			} while (byte & 0x80);
+			value += (size_t) ((zz >> 1) ^ (~(zz & 1) + 1));	// zigzag decoding of the difference
+		}
+
+	public:
+		inline iterator(){
+			data_ptr = NULL; used = 0; pos = 0; next_ptr = NULL; left = 0; value = 0;
+		}
+
+		inline iterator(const IndexList &list){
+			data_ptr = list.inline_data;
+			used = list.inline_used;
+			pos = 0;
+			next_ptr = list.first_ptr;
+			left = list.len;
+			value = 0;
+			if (left){ routine_decode(); }
+		}
+
+		inline size_t operator*() const{ return value; }
+		inline iterator &operator++(){
+			if (--left){ routine_decode(); }
+			return *this;
+		}
+		inline bool operator==(const iterator &other) const{ return left == other.left; }
+		inline bool operator!=(const iterator &other) const{ return left != other.left; }
+	};
+
+	inline IndexList(){
+		first_ptr = NULL;
+		last_ptr = NULL;
+		len = 0;
+		last_index = 0;
+		inline_used = 0;
+	}
+
+	inline ~IndexList(){ clear(); }
+
+	inline size_t size() const{ return len; }
+	inline bool empty() const{ return len == 0; }
+
+	inline void push_back(size_t index){
+		// Encoding the difference from the previous index
+		uint64_t delta = (uint64_t) index - (uint64_t) last_index;
+		uint64_t zz = (delta << 1) ^ (~((delta >> 63) & 1) + 1);	// zigzag encoding, small negative differences stay small
+		uint8_t buffer[INDEXLIST_VARINT_MAX];
+		size_t bytes = 0;
+		while (zz >= 0x80){
+			buffer[bytes++] = (uint8_t) (zz | 0x80);
+			zz >>= 7;
+		}
+		buffer[bytes++] = (uint8_t) zz;
+
+		// Writing into the current block, a value is never split between two blocks
+		if (!last_ptr && inline_used + bytes <= INDEXLIST_INLINE_BYTES){
+			std::memcpy(inline_data + inline_used, buffer, bytes);
+			inline_used += bytes;
+		}
+		else{
+			if (!last_ptr || last_ptr->used + bytes > last_ptr->size){ routine_add_chunk(); }
+			std::memcpy(last_ptr->data + last_ptr->used, buffer, bytes);
+			last_ptr->used += bytes;
+		}
+		last_index = index;
+		++len;
+	}
+
+	void append(const IndexList &list);
+	void clear();
+
+	inline iterator begin() const{ return iterator(*this); }
+	inline iterator end() const{ return iterator(); }
+};
+
 /////////////////////////////////////////////////////////////////////////////////////
 //
 //	CLASS Kmer DEFINITION
@@ -77,10 +241,11 @@ public:
 	// Variables
 	uint8_t *kmer_mask_ptr;	// ptr to the uint8_t array encoding the kmer as bit set
 	size_t kmer_mask_len;	// length of the kmer_mask_ptr array
-	std::vector<bool> *alignment_ptr;
+	uint8_t *alignment_ptr;	// ptr to the alignment operations packed four per uint8_t, stored after the kmer mask, NULL if no alignment
+	size_t alignment_len;	// number of alignment operations
     size_t k;	// length of the kmer
     size_t counts;	// counts of all the copies of the kmer in the string
-    std::vector<size_t> indexes;	// std::vector<size_t> containing the indexes for all the copies of the kmer in the string
+    IndexList indexes;	// IndexList containing the indexes for all the copies of the kmer in the string
     Kmer *next_kmer_ptr;	// ptr to the next Kmer in a linked list, allows Kmer to be used to build a linked list
 
     // Functions
@@ -93,6 +258,23 @@ public:
     	kmer_mask_ptr = new uint8_t[dna_bytes];	// defining ptr to kmer_mask_ptr
     	std::memset(kmer_mask_ptr, 0, dna_bytes);	// initializing every bit of the kmer_mask_ptr array to 0
     	alignment_ptr = NULL;
+    	alignment_len = 0;
+    	k = kmer_len;
+    	counts = 0;
+    	next_kmer_ptr = NULL;
+    }
+
+    inline Kmer(size_t kmer_len, size_t align_len){
+    	// Bytes necessary to store the kmer and the alignment operations as bit sets
+    	size_t dna_bytes = (kmer_len >> 2) + (0 != (kmer_len & ((1 << 2) - 1)));
+    	size_t align_bytes = (align_len >> 2) + (0 != (align_len & ((1 << 2) - 1)));
+    	kmer_mask_len = dna_bytes;
+
+    	// Defining variables, the alignment is stored in the same array after the kmer mask
+    	kmer_mask_ptr = new uint8_t[dna_bytes + align_bytes];
+    	std::memset(kmer_mask_ptr, 0, dna_bytes + align_bytes);
+    	alignment_ptr = kmer_mask_ptr + dna_bytes;
+    	alignment_len = align_len;
     	k = kmer_len;
     	counts = 0;
     	next_kmer_ptr = NULL;
@@ -101,10 +283,7 @@ public:
     inline ~Kmer(){
     	delete[] kmer_mask_ptr;
     	kmer_mask_ptr = NULL;
-    	if (alignment_ptr){
-    		delete alignment_ptr;
-    		alignment_ptr = NULL;
-    	}
+    	alignment_ptr = NULL;
     	next_kmer_ptr = NULL;
     }
 
@@ -27,6 +27,320 @@
 
 
 #include "Nessie.h"
+#include "Stats.h"
+#include "Progress.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Encoding table flags
+#define ENCODING_LOWER 0x4	// set for lower case bases, the base encoding is in the lowest two bits
+#define ENCODING_INVALID 0x80	// set for non-canonical bases
+#define NO_DIMER 0x10	// no dimer starts at the index in the dimer index
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT encoding_table DEFINITION
+//		Lookup table from an ASCII char to its bit encoding, ENCODING_LOWER is set for lower case bases
+//		and ENCODING_INVALID for non-canonical bases
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct encoding_table{
+
+	uint8_t code[256];
+
+	encoding_table(){
+		std::memset(code, ENCODING_INVALID, 256);
+		code['A'] = ENCODING_A; code['a'] = ENCODING_A | ENCODING_LOWER;
+		code['C'] = ENCODING_C; code['c'] = ENCODING_C | ENCODING_LOWER;
+		code['G'] = ENCODING_G; code['g'] = ENCODING_G | ENCODING_LOWER;
+		code['T'] = ENCODING_T; code['t'] = ENCODING_T | ENCODING_LOWER;
+	}
+};
+
+static const encoding_table dna_encoding_table;
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	EncodedSequence (constructor): encodes the DNA string as bit, non-canonical bases are encoded as A and marked in unknown_ptr,
+//								   lower case bases are marked in lower_ptr
+//
+//	parameters:
+//		dna_str_ptr - a ptr to a char array containing the DNA string
+//		dna_str_len - length of the DNA string (i.e. n)
+//		start - starting index of the interval to be encoded [0]
+//		end - ending index of the interval to be encoded [0]
+//
+/////////////////////////////////////////////////////////////////////////////////////
+EncodedSequence::EncodedSequence(const char *dna_str_ptr, size_t dna_str_len, size_t start, size_t end){
+
+	if (!end){ end = dna_str_len - 1; }
+	if (start > end){ throw std::invalid_argument("EncodedSequence build: starting index is larger than ending index"); }
+	StatsPhase stats_phase(STATS_PHASE_ENCODING);
+
+	// Defining some variables
+	size_t counts_UP[4] = {0, 0, 0, 0}, counts_LOW[4] = {0, 0, 0, 0};	// not stored, every Nessie counts the bases of its interval
+	this->start = start;
+	data_len = end - start + 1;
+
+	data_ptr = new uint8_t[(data_len >> 2) + 1]();
+	unknown_ptr = new uint64_t[(data_len >> 6) + 1]();
+	lower_ptr = new uint64_t[(data_len >> 6) + 1]();
+
+	Nessie::routine_encode_dna(dna_str_ptr + start, data_len, data_ptr, counts_UP, counts_LOW, unknown_ptr, lower_ptr);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	~EncodedSequence (destructor)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+EncodedSequence::~EncodedSequence(){
+
+	delete[] data_ptr;
+	delete[] unknown_ptr;
+	delete[] lower_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_start: returns the index of the first base encoded
+//
+/////////////////////////////////////////////////////////////////////////////////////
+size_t EncodedSequence::get_start(){
+
+	return start;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_end: returns the index of the last base encoded
+//
+/////////////////////////////////////////////////////////////////////////////////////
+size_t EncodedSequence::get_end(){
+
+	return start + data_len - 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	check_unknown: returns true if there are non-canonical bases in the interval [start..end]
+//
+//	parameters:
+//		start - starting index of the interval
+//		end - ending index of the interval
+//
+/////////////////////////////////////////////////////////////////////////////////////
+bool EncodedSequence::check_unknown(size_t start, size_t end){
+
+	size_t i = start - this->start, j = end - this->start;	// relative indexes
+
+	for (size_t w = i >> 6; w <= (j >> 6); ++w){
+		uint64_t word = unknown_ptr[w];
+		if (w == (i >> 6)){ word &= ~((uint64_t) 0) << (i & 63); }	// dropping bits before i
+		if (w == (j >> 6) && (j & 63) != 63){ word &= (((uint64_t) 1) << ((j & 63) + 1)) - 1; }	// dropping bits after j
+		if (word){ return true; }
+	}
+
+	return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	find_unknown: returns the index of the first non-canonical base in the interval [start..end], end + 1 if there is none
+//
+//	parameters:
+//		start - starting index of the interval
+//		end - ending index of the interval
+//
+/////////////////////////////////////////////////////////////////////////////////////
+size_t EncodedSequence::find_unknown(size_t start, size_t end){
+
+	size_t i = start - this->start, j = end - this->start;	// relative indexes
+
+	for (size_t w = i >> 6; w <= (j >> 6); ++w){
+		uint64_t word = unknown_ptr[w];
+		if (w == (i >> 6)){ word &= ~((uint64_t) 0) << (i & 63); }	// dropping bits before i
+		if (word){
+			size_t idx = (w << 6) + __builtin_ctzll(word);
+			return (idx <= j) ? idx + this->start : end + 1;
+		}
+	}
+
+	return end + 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	count_lower: counts the lower case bases in the interval [start..end]
+//
+//	parameters:
+//		start - starting index of the interval
+//		end - ending index of the interval
+//		counts_ptr - ptr to a size_t array of length 4, counts are added in ENCODING order
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void EncodedSequence::count_lower(size_t start, size_t end, size_t *counts_ptr){
+
+	size_t i = start - this->start, j = end - this->start;	// relative indexes
+
+	for (size_t w = i >> 6; w <= (j >> 6); ++w){
+		uint64_t word = lower_ptr[w];
+		if (w == (i >> 6)){ word &= ~((uint64_t) 0) << (i & 63); }	// dropping bits before i
+		if (w == (j >> 6) && (j & 63) != 63){ word &= (((uint64_t) 1) << ((j & 63) + 1)) - 1; }	// dropping bits after j
+		while (word){
+			size_t idx = (w << 6) + __builtin_ctzll(word);
+			++counts_ptr[(data_ptr[idx >> 2] >> ((idx & 3) << 1)) & BASE_MASK];
+			word &= word - 1;	// clearing the lowest bit set
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	copy_interval: copies the encoding of the interval [start..end] into a uint8_t array
+//
+//	parameters:
+//		array_ptr - ptr to a uint8_t array of length (end - start + 1) / 4 rounded up
+//		start - starting index of the interval
+//		end - ending index of the interval
+//
+//	note: the bytes are shifted when start is not the first base of a byte, the empty bases of the last byte are set to 0
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void EncodedSequence::copy_interval(uint8_t *array_ptr, size_t start, size_t end){
+
+	if (start < this->start || end > get_end() || start > end){ throw std::invalid_argument("EncodedSequence copy: interval is out of the sequence encoded"); }
+
+	// Variables
+	size_t i = start - this->start;	// relative index of the first base
+	size_t len = end - start + 1;
+	size_t len_array = (len >> 2) + (0 != (len & ((1 << 2) - 1)));	// (len / 4) + (0 != (len % 4))
+	size_t data_bytes = (data_len >> 2) + 1;
+	uint8_t *src_ptr = data_ptr + (i >> 2);
+	uint8_t shift = (i & ((1 << 2) - 1)) << 1;
+
+	if (!shift){
+		std::memcpy(array_ptr, src_ptr, len_array);
+	}
+	else{
+		for (size_t j = 0; j < len_array; ++j){
+			uint8_t next = ((i >> 2) + j + 1 < data_bytes) ? src_ptr[j + 1] : 0;
+			array_ptr[j] = (src_ptr[j] >> shift) | (next << (8 - shift));
+		}
+	}
+
+	// Clearing the bases after end
+	uint8_t shift_pad = ((len_array << 2) - len) << 1;
+	array_ptr[len_array - 1] &= 0xFF >> shift_pad;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	ScanWorkspace (constructor)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+ScanWorkspace::ScanWorkspace(){
+
+	scoring_ptr = NULL;
+	scoring_len = 0;
+	alignment.ops_ptr = NULL;
+	alignment.ops_len = 0;
+	alignment_bytes = 0;
+	for (size_t s = 0; s < 2; ++s){
+		for (size_t i = 0; i < 4; ++i){
+			monomer_bitarray[s][i] = NULL;
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	~ScanWorkspace (destructor)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+ScanWorkspace::~ScanWorkspace(){
+
+	delete[] scoring_ptr;
+	delete[] alignment.ops_ptr;
+	for (size_t s = 0; s < 2; ++s){
+		for (size_t i = 0; i < 4; ++i){
+			if (monomer_bitarray[s][i]){ bit_array_free(monomer_bitarray[s][i]); }
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_scoring_matrix: returns a ptr to a scoring matrix of (l + 1) * (l + 1) elements, values are not initialized
+//
+//	parameters:
+//		l - length of the sequences aligned
+//
+/////////////////////////////////////////////////////////////////////////////////////
+long *ScanWorkspace::get_scoring_matrix(size_t l){
+
+	size_t len = (l + 1) * (l + 1);
+	if (len > scoring_len){
+		delete[] scoring_ptr;
+		scoring_ptr = NULL;
+		scoring_ptr = new long[len];
+		scoring_len = len;
+	}
+
+	return scoring_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_monomer_bitarrays: returns a ptr to a set of 4 BIT_ARRAY of length k bit set to 0
+//
+//	parameters:
+//		k - length of the kmer
+//		set - set of BIT_ARRAY returned, 0 or 1 [0]
+//
+//	note: the two sets can be used at the same time, a set is cleared every time it is requested
+//
+/////////////////////////////////////////////////////////////////////////////////////
+BIT_ARRAY **ScanWorkspace::get_monomer_bitarrays(size_t k, size_t set){
+
+	BIT_ARRAY **monomer_bitarray_ptr = monomer_bitarray[set];
+	for (size_t i = 0; i < 4; ++i){
+		if (!monomer_bitarray_ptr[i]){
+			monomer_bitarray_ptr[i] = bit_array_create(k);
+			if (!monomer_bitarray_ptr[i]){ throw std::bad_alloc(); }
+		}
+		else{
+			if (!bit_array_resize(monomer_bitarray_ptr[i], k)){ throw std::bad_alloc(); }
+			bit_array_clear_all(monomer_bitarray_ptr[i]);
+		}
+	}
+
+	return monomer_bitarray_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_alignment: returns a ptr to a kmer_alignment that can store the alignment of two sequences of length l
+//
+//	parameters:
+//		l - length of the sequences aligned, the alignment has at most l operations
+//
+/////////////////////////////////////////////////////////////////////////////////////
+kmer_alignment *ScanWorkspace::get_alignment(size_t l){
+
+	size_t bytes = (l >> 2) + 1;
+	if (bytes > alignment_bytes){
+		delete[] alignment.ops_ptr;
+		alignment.ops_ptr = NULL;
+		alignment.ops_ptr = new uint8_t[bytes];
+		alignment_bytes = bytes;
+	}
+	alignment.ops_len = 0;
+
+	return &alignment;
+}
 
 /////////////////////////////////////////////////////////////////////////////////////
 //
@@ -38,7 +352,7 @@
 //		dna_str_len - length of the DNA string (i.e. n)
 //		start - starting index of the interval to be stored
 //		end - ending index of the interval to be stored
-//		build_structure - bool value, if true array_dimer is initialized and bits are set / if false bits are not set [false]
+//		build_structure - bool value, if true the dimer index is built / if false the dimer index is not built [false]
 //		reverse_complement - bool value, if false stores the normal string / if true stores the string in reverse complement [false]
 //
 /////////////////////////////////////////////////////////////////////////////////////
@@ -46,21 +360,19 @@ Nessie::Nessie(const char *dna_str_ptr, size_t dna_str_len, size_t start, size_t
 
 	if (!end){ end = dna_str_len - 1; }
 	if (start > end){ throw std::invalid_argument("Nessie build: starting index is larger than ending index"); }
+	StatsPhase stats_phase(STATS_PHASE_ENCODING);
 
 	// Defining some variables
-	uint8_t shift_DNA;
-	uint8_t dimer_mask = 0x0;	// bit set mask to keep track of the dimers to initialize the indexes
-	uint8_t *dimer_mask_ptr = &dimer_mask;
 	string_bit_ptr = &string_bit;
+	offset = start;
 	size_t dna_len = end - start + 1;
 
 	// Bytes necessary to store the DNA string as a bit set
 	size_t dna_bytes = (dna_len >> 2) + (0 != (dna_len & ((1 << 2) - 1)));	// (dna_len / 4) + (0 != (dna_len % 4))
 	    																	// (0 != dna_len % 4) evaluate to 1 when dna_len is not multiple of 4
-	// Initializing Nessie data structure
-	for(int i = 0; i < 16; ++i){	// array_dimer initialization
-		array_dimer[i] = (build_structure) ? new sparse_bitarray(dna_len) : NULL; // creating the i-bit set (sparse_bitarray) of length n bit if build structure
-	}
+	// Dimer index is built after the encoding if requested
+	dimer_positions_ptr = NULL;
+	std::memset(dimer_offsets, 0, sizeof(dimer_offsets));
 
 	//
 	if (build_structure) {
@@ -71,6 +383,10 @@ Nessie::Nessie(const char *dna_str_ptr, size_t dna_str_len, size_t start, size_t
 		indexes_checked_ptr = NULL;
 	}
 
+	// LCE index is built only if requested
+	lce_forward_ptr = NULL;
+	lce_reverse_ptr = NULL;
+
 	// Initializing string_bit
 	string_bit_ptr->data_len = dna_len;
 	string_bit_ptr->data_ptr = new uint8_t[dna_bytes];	// string_bit uint8_t array in which to store the DNA string encoded as bit
@@ -85,111 +401,26 @@ Nessie::Nessie(const char *dna_str_ptr, size_t dna_str_len, size_t start, size_t
 
 	// Storing DNA into string_bit bit set and filling Nessie data structure
 	if (reverse_complement){	// storing the DNA string in reverse complement
-		bool dimer_set = false;	// becomes true after first iteration, the first dimer is available only while iterating trough the second base
-
-		for (size_t i = 0; i < dna_len; ++i){
-			shift_DNA = (i & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
-													// 2 * (i % 4)
-			switch (dna_str_ptr[(end - i)]){ // index reversed to pick bases from the end of the DNA string
-			case 'A':
-				++string_bit_ptr->array_counts_UP_ptr[ENCODING_T];	// incrementing base counts
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_T << shift_DNA;	// encoding base as bit
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_T);	// setting bit corresponding to dimer index
-				break;
-			case 'a':
-				++string_bit_ptr->array_counts_LOW_ptr[ENCODING_T];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_T << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_T);
-				break;
-			case 'C':
-				++string_bit_ptr->array_counts_UP_ptr[ENCODING_G];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_G << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_G);
-				break;
-			case 'c':
-				++string_bit_ptr->array_counts_LOW_ptr[ENCODING_G];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_G << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_G);
-				break;
-			case 'G':
-				++string_bit_ptr->array_counts_UP_ptr[ENCODING_C];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_C << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_C);
-				break;
-			case 'g':
-				++string_bit_ptr->array_counts_LOW_ptr[ENCODING_C];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_C << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_C);
-				break;
-			case 'T':
-				++string_bit_ptr->array_counts_UP_ptr[ENCODING_A];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_A << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_A);
-				break;
-			case 't':
-				++string_bit_ptr->array_counts_LOW_ptr[ENCODING_A];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_A << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_A);
-				break;
-			default:
-				throw std::invalid_argument("invalid DNA base");
-			}
-			dimer_set = (build_structure) ? true : false;
+		uint8_t *tmp_data_ptr = new uint8_t[dna_bytes]();	// DNA string encoded as it is
+		size_t tmp_counts_UP[4] = {0, 0, 0, 0}, tmp_counts_LOW[4] = {0, 0, 0, 0};
+		try{
+			Nessie::routine_encode_dna(dna_str_ptr + start, dna_len, tmp_data_ptr, tmp_counts_UP, tmp_counts_LOW);
+		}
+		catch (std::exception &e){
+			delete[] tmp_data_ptr;
+			throw;
+		}
+		reverse_complement_dna(string_bit_ptr->data_ptr, tmp_data_ptr, dna_bytes, dna_len);	// reverse complement on the encoded string
+		delete[] tmp_data_ptr;
+		for (size_t i = 0; i < 4; ++i){	// counts of the complementary bases, xor 11
+			string_bit_ptr->array_counts_UP_ptr[i ^ BASE_MASK] = tmp_counts_UP[i];
+			string_bit_ptr->array_counts_LOW_ptr[i ^ BASE_MASK] = tmp_counts_LOW[i];
 		}
 	}
 	else{	// storing the DNA string as it is
-		bool dimer_set = false;
-
-		for (size_t i = 0; i < dna_len; ++i){
-			shift_DNA = (i & ((1 << 2) - 1)) << 1;
-
-			switch (dna_str_ptr[(start + i)]){
-			case 'A':
-				++string_bit_ptr->array_counts_UP_ptr[ENCODING_A];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_A << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_A);
-				break;
-			case 'a':
-				++string_bit_ptr->array_counts_LOW_ptr[ENCODING_A];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_A << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_A);
-				break;
-			case 'C':
-				++string_bit_ptr->array_counts_UP_ptr[ENCODING_C];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_C << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_C);
-				break;
-			case 'c':
-				++string_bit_ptr->array_counts_LOW_ptr[ENCODING_C];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_C << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_C);
-				break;
-			case 'G':
-				++string_bit_ptr->array_counts_UP_ptr[ENCODING_G];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_G << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_G);
-				break;
-			case 'g':
-				++string_bit_ptr->array_counts_LOW_ptr[ENCODING_G];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_G << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_G);
-				break;
-			case 'T':
-				++string_bit_ptr->array_counts_UP_ptr[ENCODING_T];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_T << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_T);
-				break;
-			case 't':
-				++string_bit_ptr->array_counts_LOW_ptr[ENCODING_T];
-				string_bit_ptr->data_ptr[i >> 2] |= ENCODING_T << shift_DNA;
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_T);
-				break;
-			default:
-				throw std::invalid_argument("invalid DNA base");
-			}
-			dimer_set = (build_structure) ? true : false;
-		}
+		Nessie::routine_encode_dna(dna_str_ptr + start, dna_len, string_bit_ptr->data_ptr, string_bit_ptr->array_counts_UP_ptr, string_bit_ptr->array_counts_LOW_ptr);
 	}
+	if (build_structure){ Nessie::routine_build_dimer_index(); }
 
 	// Calculating bases frequencies and storing in string_bit structure
 	for (size_t i = 0; i < 4; ++i){
@@ -221,22 +452,21 @@ Nessie::Nessie(int, const char *dna_str_ptr, size_t dna_str_len, size_t start, s
 
 	if (!end){ end = dna_str_len - 1; }
 	if (start > end){ throw std::invalid_argument("Nessie build: starting index is larger than ending index"); }
+	StatsPhase stats_phase(STATS_PHASE_ENCODING);
 
 	// Defining some variables
-	uint8_t shift_DNA;
-	uint8_t dimer_mask = 0x0;	// bit set mask to keep track of the dimers to initialize the indexes
-	uint8_t *dimer_mask_ptr = &dimer_mask;
 	string_bit_ptr = &string_bit;
+	offset = start;
 	size_t dna_len = end - start + 1;
 
 	// Initializing Nessie data structure
-	for(int i = 0; i < 16; ++i){	// array_dimer initialization
-		array_dimer[i] = new sparse_bitarray(dna_len);	// creating the i-bit set (sparse_bitarray) of length n bit
-	}
+	dimer_positions_ptr = NULL;
+	std::memset(dimer_offsets, 0, sizeof(dimer_offsets));
+	indexes_checked_ptr = NULL;
 
-	//
-	indexes_checked_ptr = new bitarray(dna_len);	// indexes_checked_ptr bit set (bitarray) initialization
-	indexes_checked_ptr->set_bit(0, (dna_len - 1));	// set to 1 all bits
+	// LCE index is built only if requested
+	lce_forward_ptr = NULL;
+	lce_reverse_ptr = NULL;
 
 	// Initializing string_bit
 	string_bit_ptr->data_len = dna_len;
@@ -249,100 +479,118 @@ Nessie::Nessie(int, const char *dna_str_ptr, size_t dna_str_len, size_t start, s
 	string_bit_ptr->array_frequencies_UP_ptr = NULL;
 	string_bit_ptr->array_frequencies_LOW_ptr = NULL;
 
-	// Storing DNA into string_bit bit set and filling Nessie data structure
-	if (reverse_complement){	// storing the DNA string in reverse complement
-		bool dimer_set = false;	// becomes true after first iteration, the first dimer is available only while iterating trough the second base
-
-		for (size_t i = 0; i < dna_len; ++i){
-			shift_DNA = (i & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
-													// 2 * (i % 4)
-			switch (dna_str_ptr[(end - i)]){ // index reversed to pick bases from the end of the DNA string
-			case 'A':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_T);	// setting bit corresponding to dimer index
-				dimer_set = true;
-				break;
-			case 'a':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_T);
-				dimer_set = true;
-				break;
-			case 'C':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_G);
-				dimer_set = true;
-				break;
-			case 'c':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_G);
-				dimer_set = true;
-				break;
-			case 'G':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_C);
-				dimer_set = true;
-				break;
-			case 'g':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_C);
-				dimer_set = true;
-				break;
-			case 'T':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_A);
-				dimer_set = true;
-				break;
-			case 't':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_A);
-				dimer_set = true;
-				break;
-			default:
-				if (dimer_set){	//skipping non-canonical bases and reinitializing dimer mask and dimer_set
-					dimer_mask = 0x0;
-					dimer_set = false;
-				}
-			}
+	// Dimer starting at each index, dimers with non-canonical bases are skipped
+	uint8_t *dimer_codes_ptr = new uint8_t[dna_len];
+	uint8_t previous = ENCODING_INVALID;	// code of the previous base
+
+	for (size_t i = 0; i < dna_len; ++i){
+		uint8_t code = (reverse_complement)	// index reversed to pick bases from the end of the DNA string, complement is xor 11
+					   ? dna_encoding_table.code[(uint8_t) dna_str_ptr[(end - i)]] ^ BASE_MASK
+					   : dna_encoding_table.code[(uint8_t) dna_str_ptr[(start + i)]];
+		if (i){
+			dimer_codes_ptr[i - 1] = ((previous | code) & ENCODING_INVALID)
+									 ? NO_DIMER
+									 : (previous & BASE_MASK) | ((code & BASE_MASK) << 2);	// first base in the lowest bits
 		}
+		previous = code;
+	}
+	dimer_codes_ptr[dna_len - 1] = NO_DIMER;	// last index does not start a dimer
+
+	try{
+		Nessie::routine_build_dimer_positions(dimer_codes_ptr, dna_len);
+	}
+	catch (std::exception &e){
+		delete[] dimer_codes_ptr;
+		throw;
+	}
+	delete[] dimer_codes_ptr;
+
+	indexes_checked_ptr = new bitarray(dna_len);	// indexes_checked_ptr bit set (bitarray) initialization
+	indexes_checked_ptr->set_bit(0, (dna_len - 1));	// set to 1 all bits
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	Nessie (third constructor): builds a Nessie for an interval of a DNA string already encoded,
+//								does not accept non-canonical bases
+//
+//	parameters:
+//		sequence - EncodedSequence that stores the DNA string encoded as bit
+//		start - starting index of the interval to be stored, index in the original DNA string [0]
+//		end - ending index of the interval to be stored, index in the original DNA string [0]
+//		build_structure - bool value, if true the dimer index is built / if false the dimer index is not built [false]
+//		reverse_complement - bool value, if false stores the normal string / if true stores the string in reverse complement [false]
+//
+//	note: with start and end equal to 0 the whole sequence is stored. The encoding is copied a byte at a time,
+//		  the lower case bases are counted from the bit set of the EncodedSequence, as the other constructors upper
+//		  and lower case bases are counted separately
+//
+/////////////////////////////////////////////////////////////////////////////////////
+Nessie::Nessie(EncodedSequence &sequence, size_t start, size_t end, bool build_structure, bool reverse_complement){
+
+	if (!start && !end){ start = sequence.get_start(); end = sequence.get_end(); }
+	if (start > end){ throw std::invalid_argument("Nessie build: starting index is larger than ending index"); }
+	if (start < sequence.get_start() || end > sequence.get_end()){ throw std::invalid_argument("Nessie build: interval is out of the sequence encoded"); }
+	if (sequence.check_unknown(start, end)){ throw std::invalid_argument("invalid DNA base"); }
+
+	// Defining some variables
+	string_bit_ptr = &string_bit;
+	offset = start;
+	size_t dna_len = end - start + 1;
+	size_t dna_bytes = (dna_len >> 2) + (0 != (dna_len & ((1 << 2) - 1)));	// (dna_len / 4) + (0 != (dna_len % 4))
+
+	// Initializing Nessie data structure
+	dimer_positions_ptr = NULL;
+	std::memset(dimer_offsets, 0, sizeof(dimer_offsets));
+
+	if (build_structure) {
+		indexes_checked_ptr = new bitarray(dna_len);
+		indexes_checked_ptr->set_bit(0, (dna_len - 1));	// set to 1 all bits
+	}
+	else{
+		indexes_checked_ptr = NULL;
 	}
-	else{	// storing the DNA string as it is
-		bool dimer_set = false;
 
-		for (size_t i = 0; i < dna_len; ++i){
-			shift_DNA = (i & ((1 << 2) - 1)) << 1;
+	lce_forward_ptr = NULL;
+	lce_reverse_ptr = NULL;
 
-			switch (dna_str_ptr[(start + i)]){
-			case 'A':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_A);
-				dimer_set = true;
-				break;
-			case 'a':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_A);
-				dimer_set = true;
-				break;
-			case 'C':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_C);
-				dimer_set = true;
-				break;
-			case 'c':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_C);
-				dimer_set = true;
-				break;
-			case 'G':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_G);
-				dimer_set = true;
-				break;
-			case 'g':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_G);
-				dimer_set = true;
-				break;
-			case 'T':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_T);
-				dimer_set = true;
-				break;
-			case 't':
-				Nessie::routine_set_array_dimer(array_dimer, dimer_mask_ptr, dimer_set, i, ENCODING_T);
-				dimer_set = true;
-				break;
-			default:
-				if (dimer_set){
-					dimer_mask = 0x0;
-					dimer_set = false;
-				}
-			}
-		}
+	// Initializing string_bit
+	string_bit_ptr->data_len = dna_len;
+	string_bit_ptr->data_ptr = new uint8_t[dna_bytes];
+	string_bit_ptr->dna_str_ptr = NULL;
+	string_bit_ptr->array_counts_UP_ptr = new size_t[4]();
+	string_bit_ptr->array_counts_LOW_ptr = new size_t[4]();
+	string_bit_ptr->array_frequencies_UP_ptr = new double[4]();
+	string_bit_ptr->array_frequencies_LOW_ptr = new double[4]();
+
+	// Copying the encoded interval
+	if (reverse_complement){
+		uint8_t *tmp_data_ptr = new uint8_t[dna_bytes];
+		sequence.copy_interval(tmp_data_ptr, start, end);
+		reverse_complement_dna(string_bit_ptr->data_ptr, tmp_data_ptr, dna_bytes, dna_len);
+		delete[] tmp_data_ptr;
+	}
+	else{
+		sequence.copy_interval(string_bit_ptr->data_ptr, start, end);
+	}
+	if (build_structure){ Nessie::routine_build_dimer_index(); }
+
+	// Calculating bases frequencies, all the bases are counted and the lower case ones are moved to LOW
+	size_t tmp_counts_LOW[4] = {0, 0, 0, 0};
+	count_bases_dna(string_bit_ptr->data_ptr, dna_bytes, dna_len, string_bit_ptr->array_counts_UP_ptr);
+	sequence.count_lower(start, end, tmp_counts_LOW);
+	for (size_t i = 0; i < 4; ++i){
+		size_t j = (reverse_complement) ? (i ^ BASE_MASK) : i;	// counts of the complementary bases, xor 11
+		string_bit_ptr->array_counts_LOW_ptr[j] = tmp_counts_LOW[i];
+		string_bit_ptr->array_counts_UP_ptr[j] -= tmp_counts_LOW[i];
+	}
+	for (size_t i = 0; i < 4; ++i){
+		string_bit_ptr->array_frequencies_UP_ptr[i] = (string_bit_ptr->array_counts_UP_ptr[i])
+													? (double) string_bit_ptr->array_counts_UP_ptr[i] / dna_len
+													: 0;
+		string_bit_ptr->array_frequencies_LOW_ptr[i] = (string_bit_ptr->array_counts_LOW_ptr[i])
+													? (double) string_bit_ptr->array_counts_LOW_ptr[i] / dna_len
+													: 0;
 	}
 }
 
@@ -388,29 +636,175 @@ Nessie::~Nessie(){
 		string_bit_ptr->dna_str_ptr = NULL;
 		//std::cout << "DELETE CHAR ARRAY" << std::endl;
 	}
+
+	// Destructing the dimer index if existent
+	if (dimer_positions_ptr){
+		delete[] dimer_positions_ptr;
+		dimer_positions_ptr = NULL;
+	}
+
+	if (indexes_checked_ptr){
+		delete indexes_checked_ptr;
+		indexes_checked_ptr = NULL;
+	}
+
+	// Destructing the LCE index if existent
+	if (lce_forward_ptr){
+		delete[] lce_forward_ptr;
+		lce_forward_ptr = NULL;
+	}
+
+	if (lce_reverse_ptr){
+		delete[] lce_reverse_ptr;
+		lce_reverse_ptr = NULL;
+	}
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
 //
-//	routine_set_array_dimer
+//	routine_encode_chars: encodes the bases [i..end_i) of a DNA string by the lookup table
+//
+/////////////////////////////////////////////////////////////////////////////////////
+static inline void routine_encode_chars(const char *dna_str_ptr, size_t i, size_t end_i, uint8_t *data_ptr, size_t *counts_UP_ptr, size_t *counts_LOW_ptr, uint64_t *unknown_ptr, uint64_t *lower_ptr){
+
+	for (; i < end_i; ++i){
+		uint8_t code = dna_encoding_table.code[(uint8_t) dna_str_ptr[i]];
+		if (code & ENCODING_INVALID){
+			if (!unknown_ptr){ throw std::invalid_argument("invalid DNA base"); }
+			unknown_ptr[i >> 6] |= ((uint64_t) 1) << (i & 63);	// the base is left encoded as A
+			continue;
+		}
+		if (code & ENCODING_LOWER){
+			++counts_LOW_ptr[code & BASE_MASK];
+			if (lower_ptr){ lower_ptr[i >> 6] |= ((uint64_t) 1) << (i & 63); }
+		}
+		else{ ++counts_UP_ptr[code]; }
+		data_ptr[i >> 2] |= (code & BASE_MASK) << ((i & 3) << 1);	// shift from 0 to 6 with a step of two, 2 * (i % 4)
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_encode_dna: encodes a DNA string as bit and counts upper and lower case bases,
+//						non-canonical bases throws an error or are marked in a bit set
 //
 //	parameters:
-//		array_dimer - array that stores dimers indexes information
-//		dimer_mask_ptr - ptr to a mask that stores the current dimer
-//		dimer_set - bool value that check if the dimer corresponding index has to be set
-//		i - index from the loop
-//		encode - bit encoding for the base as size_t
+//		dna_str_ptr - a ptr to the first char of the DNA string to be encoded
+//		dna_len - number of bases to be encoded
+//		data_ptr - ptr to the uint8_t array that receives the encoded string, must be set to 0
+//		counts_UP_ptr - ptr to a size_t array of length 4, upper case bases counts are added
+//		counts_LOW_ptr - ptr to a size_t array of length 4, lower case bases counts are added
+//		unknown_ptr - ptr to a bit set of length dna_len bit set to 0, if not NULL non-canonical bases
+//			are set to 1 and encoded as A instead of throwing an error [NULL]
+//		lower_ptr - ptr to a bit set of length dna_len bit set to 0, if not NULL lower case bases are set to 1 [NULL]
+//
+//	note: with SSE2 the string is encoded 16 bases at a time, the bases are compared with ACGT ignoring the case
+//		  and the 2-bit codes are packed into 4 bytes, the remaining bases are encoded by the lookup table
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_encode_dna(const char *dna_str_ptr, size_t dna_len, uint8_t *data_ptr, size_t *counts_UP_ptr, size_t *counts_LOW_ptr, uint64_t *unknown_ptr, uint64_t *lower_ptr){
+
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	const __m128i case_mask = _mm_set1_epi8(0x20);	// bit that distinguishes lower from upper case
+	const __m128i byte_mask = _mm_set1_epi32(0xFF);
+
+	for (; (i + 16) <= dna_len; i += 16){
+		__m128i chars = _mm_loadu_si128((const __m128i *) (dna_str_ptr + i));
+		__m128i upper = _mm_andnot_si128(case_mask, chars);
+		__m128i is_A = _mm_cmpeq_epi8(upper, _mm_set1_epi8('A'));
+		__m128i is_C = _mm_cmpeq_epi8(upper, _mm_set1_epi8('C'));
+		__m128i is_G = _mm_cmpeq_epi8(upper, _mm_set1_epi8('G'));
+		__m128i is_T = _mm_cmpeq_epi8(upper, _mm_set1_epi8('T'));
+
+		int bits_A = _mm_movemask_epi8(is_A), bits_C = _mm_movemask_epi8(is_C);
+		int bits_G = _mm_movemask_epi8(is_G), bits_T = _mm_movemask_epi8(is_T);
+		if ((bits_A | bits_C | bits_G | bits_T) != 0xFFFF){	// non-canonical bases, encoded by the lookup table
+			routine_encode_chars(dna_str_ptr, i, i + 16, data_ptr, counts_UP_ptr, counts_LOW_ptr, unknown_ptr, lower_ptr);
+			continue;
+		}
+		int bits_LOW = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(chars, case_mask), case_mask));
+		if (lower_ptr && bits_LOW){ lower_ptr[i >> 6] |= ((uint64_t) bits_LOW) << (i & 63); }	// i is a multiple of 16, the 16 bits are in the same word
+
+		counts_UP_ptr[ENCODING_A] += __builtin_popcount(bits_A & ~bits_LOW); counts_LOW_ptr[ENCODING_A] += __builtin_popcount(bits_A & bits_LOW);
+		counts_UP_ptr[ENCODING_C] += __builtin_popcount(bits_C & ~bits_LOW); counts_LOW_ptr[ENCODING_C] += __builtin_popcount(bits_C & bits_LOW);
+		counts_UP_ptr[ENCODING_G] += __builtin_popcount(bits_G & ~bits_LOW); counts_LOW_ptr[ENCODING_G] += __builtin_popcount(bits_G & bits_LOW);
+		counts_UP_ptr[ENCODING_T] += __builtin_popcount(bits_T & ~bits_LOW); counts_LOW_ptr[ENCODING_T] += __builtin_popcount(bits_T & bits_LOW);
+
+		// 2-bit code for each base, then the four codes of every 32-bit lane are packed into its lowest byte
+		__m128i codes = _mm_or_si128(_mm_or_si128(_mm_and_si128(is_C, _mm_set1_epi8(ENCODING_C)), _mm_and_si128(is_G, _mm_set1_epi8(ENCODING_G))),
+									 _mm_and_si128(is_T, _mm_set1_epi8(ENCODING_T)));
+		codes = _mm_or_si128(_mm_or_si128(codes, _mm_srli_epi32(codes, 6)), _mm_or_si128(_mm_srli_epi32(codes, 12), _mm_srli_epi32(codes, 18)));
+		codes = _mm_and_si128(codes, byte_mask);
+		codes = _mm_packs_epi32(codes, codes);
+		codes = _mm_packus_epi16(codes, codes);
+		uint32_t packed = _mm_cvtsi128_si32(codes);
+		std::memcpy(data_ptr + (i >> 2), &packed, 4);
+	}
+#endif
+
+	routine_encode_chars(dna_str_ptr, i, dna_len, data_ptr, counts_UP_ptr, counts_LOW_ptr, unknown_ptr, lower_ptr);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_build_dimer_index: builds the dimer index from the DNA string encoded as bit
 //
 /////////////////////////////////////////////////////////////////////////////////////
-void Nessie::routine_set_array_dimer(sparse_bitarray *array_dimer[], uint8_t *dimer_mask_ptr, bool dimer_set, size_t i, size_t encode){
+void Nessie::routine_build_dimer_index(){
 
-	if (dimer_set){ // Initializing dimers
-		*dimer_mask_ptr >>= 2;	// 0000xx00 -> 000000xx
-		*dimer_mask_ptr |= encode << 2;	// 0000yyxx
-		array_dimer[*dimer_mask_ptr]->set_bit(i - 1);	// setting dimer starting index
+	uint8_t *data_ptr = string_bit_ptr->data_ptr;
+	size_t dna_len = string_bit_ptr->data_len;
+	uint8_t *dimer_codes_ptr = new uint8_t[dna_len];
+
+	for (size_t i = 1; i < dna_len; ++i){
+		dimer_codes_ptr[i - 1] = ((data_ptr[(i - 1) >> 2] >> (((i - 1) & 3) << 1)) & BASE_MASK)	// first base in the lowest bits
+								 | (((data_ptr[i >> 2] >> ((i & 3) << 1)) & BASE_MASK) << 2);
 	}
-	else{
-		*dimer_mask_ptr |= encode << 2;	// first iteration no dimers discovered yet, filling 0000xx00
+	dimer_codes_ptr[dna_len - 1] = NO_DIMER;	// last index does not start a dimer
+
+	try{
+		Nessie::routine_build_dimer_positions(dimer_codes_ptr, dna_len);
+	}
+	catch (std::exception &e){
+		delete[] dimer_codes_ptr;
+		throw;
+	}
+	delete[] dimer_codes_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_build_dimer_positions: builds the dimer index by counting sort of the starting indexes on the dimers
+//
+//	parameters:
+//		dimer_codes_ptr - ptr to a uint8_t array with the dimer starting at each index, NO_DIMER if no dimer starts at the index
+//		len - length of the dimer_codes_ptr array (i.e. n)
+//
+//	note: the starting indexes of every dimer are stored in ascending order in a single uint32_t array,
+//		  the index takes 4 bytes for each dimer in the string
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_build_dimer_positions(uint8_t *dimer_codes_ptr, size_t len){
+
+	if (len > 0xFFFFFFFF){ throw std::invalid_argument("Nessie build: sequence is too long for the dimer index"); }
+
+	size_t counts[16] = {0};
+
+	for (size_t i = 0; i < len; ++i){
+		if (dimer_codes_ptr[i] != NO_DIMER){ ++counts[dimer_codes_ptr[i]]; }
+	}
+
+	dimer_offsets[0] = 0;
+	for (size_t d = 0; d < 16; ++d){
+		dimer_offsets[d + 1] = dimer_offsets[d] + counts[d];
+		counts[d] = dimer_offsets[d];	// next free position for dimer d
+	}
+
+	dimer_positions_ptr = new uint32_t[dimer_offsets[16] + 1];	// at least one element for strings without dimers
+	for (size_t i = 0; i < len; ++i){
+		if (dimer_codes_ptr[i] != NO_DIMER){ dimer_positions_ptr[counts[dimer_codes_ptr[i]]++] = (uint32_t) i; }
 	}
 }
 
@@ -424,6 +818,16 @@ bitarray *Nessie::get_indexes_checked_ptr(){
 	return indexes_checked_ptr;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_length: returns the length of the DNA string stored
+//
+/////////////////////////////////////////////////////////////////////////////////////
+size_t Nessie::get_length(){
+
+	return string_bit_ptr->data_len;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 //
 //	to_string: converts the DNA stored as bit in the dna_bitset structure back to a upper case string,
@@ -519,10 +923,12 @@ Kmer *Nessie::check_kmer_bit(uint8_t *kmer_bit_ptr, size_t k, size_t start, size
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }
 	if (start > end){ throw std::invalid_argument("Check kmer bit: starting index is larger than ending index"); }
 	if (k > (end - start + 1)){ throw std::invalid_argument("Check kmer bit: motif is longer than sequence interval"); }
+	if (k < 2){ throw std::invalid_argument("Check kmer bit: motif is shorter than a dimer"); }
+	if (!dimer_positions_ptr){ throw std::runtime_error("Check kmer bit: dimer index is not built"); }
 
 	// Defining some variables
 	size_t idx = k >> 1;	// dimers index
-	size_t kmer_dimers[idx];	// look up array to retrieve subsequent dimers identity (to be used as indexes within the array_dimer)
+	size_t kmer_dimers[idx + 1];	// look up array to retrieve subsequent dimers identity (to be used as indexes within the array_dimer)
 	size_t *kmer_dimers_ptr = kmer_dimers;
 	uint8_t shift_monomer;
 	uint8_t shift_dimer;
@@ -554,32 +960,17 @@ Kmer *Nessie::check_kmer_bit(uint8_t *kmer_bit_ptr, size_t k, size_t start, size
 		}
 	}
 
-	// Checking windows
-	size_t step = 5000000;
-	if ((end - start + 1) > step){ //std::cout << "STEP " << std::endl;
-		size_t i = start;	// index
-		while(true){
-			size_t end_i = (i + step + k - 2 > end) ? end : i + step + k - 2;
-			if (end - end_i > step + k - 1){
-				Nessie::routine_check_kmer_bit(kmer_ptr, k, idx, kmer_dimers_ptr, i, end_i);
-			}
-			else{
-				Nessie::routine_check_kmer_bit(kmer_ptr, k, idx, kmer_dimers_ptr, i , end);
-				break;
-			}
-			i += step;
-		}
-	}
-	else{
-		Nessie::routine_check_kmer_bit(kmer_ptr, k, idx, kmer_dimers_ptr, start , end);
-	}
+	// Checking the interval
+	Nessie::routine_check_kmer_bit(kmer_ptr, k, idx, kmer_dimers_ptr, start, end);
 
 	// Assigning remaining informations to Kmer object
 	kmer_ptr->counts = kmer_ptr->indexes.size();
+	NESSIE_STATS_ADD(hits, kmer_ptr->counts);
 	if (kmer_ptr->counts){
 		copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, kmer_bit_ptr, dna_bytes);
 	}
 	else{
+		delete kmer_ptr;
 		throw std::runtime_error("kmer not found");
 	}
 
@@ -598,138 +989,44 @@ Kmer *Nessie::check_kmer_bit(uint8_t *kmer_bit_ptr, size_t k, size_t start, size
 //		start - starting index of the interval considered
 //		end - ending index of the interval considered
 //
-// 	nota: per velocizzare dovrei riuscire a tirare loop fuori dal while
+//	note: the indexes of the first dimer are read in ascending order and the following dimers are searched
+//		  at the expected index, every dimer keeps its position in the index since the expected indexes only grow
 //
 /////////////////////////////////////////////////////////////////////////////////////
 void Nessie::routine_check_kmer_bit(Kmer *kmer_ptr, size_t k, size_t idx, size_t *kmer_dimers_ptr, size_t start, size_t end){
 
 	// Variables
-	size_t nBit=EMPTY_ELEM;
-
-	// Reading indexes associated to the first dimer of the kmer and saving into vector kmer_ptr.indexes if a match for the full kmer is found
-	//bool first = true;	// allows to keep set the first index for the kmer in indexes_checked_ptr
-	if (0 == start){	// searching from the beginning
-		if (!(k & 1)){	// even kmer
-			array_dimer[kmer_dimers_ptr[0]]->init_scan(bbo::NON_DESTRUCTIVE);
-			while(true){
-				bool add = true;
-				nBit=array_dimer[kmer_dimers_ptr[0]]->next_bit();
-				if((nBit==EMPTY_ELEM) || (nBit > (end - k + 1))) break;
-
-				for (size_t i = 1; i < idx; ++i){
-					if (!(array_dimer[kmer_dimers_ptr[i]]->is_bit(nBit + (i << 1)))){
-						add = false;
-						break;
-					}
-				}
+	size_t last = (k & 1) ? idx : idx - 1;	// dimers following the first one, the last dimer of an odd kmer overlaps the previous one by a base
+	uint32_t *cursor_ptr[idx + 1];	// current position in the index of the following dimers
+	uint32_t *cursor_end_ptr[idx + 1];
 
-				if (add){
-					//if (first){
-						kmer_ptr->indexes.push_back(nBit);
-						//first = false;
-					//}
-					//else{
-						//kmer_ptr->indexes.push_back(nBit);
-						indexes_checked_ptr->erase_bit((nBit-start));
-					//}
-				}
-			}
-		}
-		else{	// odd kmer
-			array_dimer[kmer_dimers_ptr[0]]->init_scan(bbo::NON_DESTRUCTIVE);
-			while(true){
-				bool add = true;
-				nBit=array_dimer[kmer_dimers_ptr[0]]->next_bit();
-				if((nBit==EMPTY_ELEM) || (nBit > (end - k + 1))) break;
-
-				for (size_t i = 1; i <= idx; ++i){
-					if (i != idx){
-						if (!(array_dimer[kmer_dimers_ptr[i]]->is_bit(nBit + (i << 1)))){
-							add = false;
-							break;
-						}
-					}
-					else{
-						if (!(array_dimer[kmer_dimers_ptr[i]]->is_bit(nBit + (i << 1) - 1))){
-							add = false;
-							break;
-						}
-					}
-				}
-
-				if (add){
-					//if (first){
-						kmer_ptr->indexes.push_back(nBit);
-						//first = false;
-					//}
-					//else{
-						//kmer_ptr->indexes.push_back(nBit);
-						indexes_checked_ptr->erase_bit((nBit-start));
-					//}
-				}
-			}
-		}
+	for (size_t i = 1; i <= last; ++i){
+		cursor_ptr[i] = dimer_positions_ptr + dimer_offsets[kmer_dimers_ptr[i]];
+		cursor_end_ptr[i] = dimer_positions_ptr + dimer_offsets[kmer_dimers_ptr[i] + 1];
 	}
-	else{	// searching from an index
-		if (!(k & 1)){	// even kmer
-			array_dimer[kmer_dimers_ptr[0]]->init_scan_from((start - 1), bbo::NON_DESTRUCTIVE);
-			while(true){
-				bool add = true;
-				nBit=array_dimer[kmer_dimers_ptr[0]]->next_bit();
-				if((nBit==EMPTY_ELEM) || (nBit > (end - k + 1))) break;
-
-				for (size_t i = 1; i < idx; ++i){
-					if (!(array_dimer[kmer_dimers_ptr[i]]->is_bit(nBit + (i << 1)))){
-						add = false;
-						break;
-					}
-				}
 
-				if (add){
-					//if (first){
-						kmer_ptr->indexes.push_back(nBit);
-						//first = false;
-					//}
-					//else{
-						//kmer_ptr->indexes.push_back(nBit);
-						indexes_checked_ptr->erase_bit((nBit-start));
-					//}
-				}
+	// Reading indexes associated to the first dimer of the kmer and saving into vector kmer_ptr.indexes if a match for the full kmer is found
+	uint32_t *first_end_ptr = dimer_positions_ptr + dimer_offsets[kmer_dimers_ptr[0] + 1];
+	uint32_t *first_ptr = std::lower_bound(dimer_positions_ptr + dimer_offsets[kmer_dimers_ptr[0]], first_end_ptr, (uint32_t) start);
+
+	for (; first_ptr != first_end_ptr; ++first_ptr){
+		size_t nBit = *first_ptr;
+		if (nBit > (end - k + 1)){ break; }
+
+		bool add = true;
+		for (size_t i = 1; i <= last; ++i){
+			size_t expected = (i == idx) ? nBit + (i << 1) - 1 : nBit + (i << 1);	// i == idx only for the last dimer of an odd kmer
+			cursor_ptr[i] = std::lower_bound(cursor_ptr[i], cursor_end_ptr[i], (uint32_t) expected);
+			if (cursor_ptr[i] == cursor_end_ptr[i]){ return; }	// no other match is possible
+			if (*cursor_ptr[i] != expected){
+				add = false;
+				break;
 			}
 		}
-		else{	// odd kmer
-			array_dimer[kmer_dimers_ptr[0]]->init_scan_from((start - 1), bbo::NON_DESTRUCTIVE);
-			while(true){
-				bool add = true;
-				nBit=array_dimer[kmer_dimers_ptr[0]]->next_bit();
-				if((nBit==EMPTY_ELEM) || (nBit > (end - k + 1))) break;
-
-				for (size_t i = 1; i <= idx; ++i){
-					if (i != idx){
-						if (!(array_dimer[kmer_dimers_ptr[i]]->is_bit(nBit + (i << 1)))){
-							add = false;
-							break;
-						}
-					}
-					else{
-						if (!(array_dimer[kmer_dimers_ptr[i]]->is_bit(nBit + (i << 1) - 1))){
-							add = false;
-							break;
-						}
-					}
-				}
 
-				if (add){
-					//if (first){
-						kmer_ptr->indexes.push_back(nBit);
-						//first = false;
-					//}
-					//else{
-						//kmer_ptr->indexes.push_back(nBit);
-						indexes_checked_ptr->erase_bit((nBit-start));
-					//}
-				}
-			}
+		if (add){
+			kmer_ptr->indexes.push_back(nBit);
+			indexes_checked_ptr->erase_bit((nBit - start));
 		}
 	}
 }
@@ -848,11 +1145,13 @@ bool Nessie::check_mirror_symmetry(BIT_ARRAY **monomer_bitarray_ptr, size_t k, s
 
 	// Variables
 	bool mirror = false;
+	NESSIE_STATS_ADD(windows, 1);
 
 	// Checking simmetry
 	size_t mm_c = 0;	// mismatch counter
 	for(size_t i = 0; i < 4; ++i){
 		if (bit_array_get(monomer_bitarray_ptr[i], 0) && !bit_array_get(monomer_bitarray_ptr[i], k - 1)) {
+			NESSIE_STATS_ADD(quick_rejects, 1);
 			return mirror;
 		}
 		else{
@@ -887,11 +1186,13 @@ bool Nessie::check_palindrome_symmetry(BIT_ARRAY **monomer_bitarray_ptr, size_t
 
 	// Variables
 	bool palindrome = false;
+	NESSIE_STATS_ADD(windows, 1);
 
 	// Checking simmetry
 	size_t mm_c = 0;	// mismatch counter
 	for(size_t i = 0; i < 4; ++i){
 		if (bit_array_get(monomer_bitarray_ptr[i], 0) && !bit_array_get(monomer_bitarray_ptr[3 - i], k - 1)) {
+			NESSIE_STATS_ADD(quick_rejects, 1);
 			return palindrome;
 		}
 		else{
@@ -932,10 +1233,12 @@ bool Nessie::routine_check_mirror_symmetry_interval(BIT_ARRAY **monomer_bitarray
 
 	// Variables
 	bool mirror = false;
+	NESSIE_STATS_ADD(windows, 1);
 
 	// Checking simmetry
 	for(size_t i = 0; i < 4; ++i){
 		if (bit_array_get(monomer_bitarray_ptr[i], start) && !bit_array_get(monomer_bitarray_ptr[i], end)) {
+			NESSIE_STATS_ADD(quick_rejects, 1);
 			return mirror;
 		}
 		else{
@@ -976,10 +1279,12 @@ bool Nessie::routine_check_palindrome_symmetry_interval(BIT_ARRAY **monomer_bita
 
 	// Variables
 	bool palindrome = false;
+	NESSIE_STATS_ADD(windows, 1);
 
 	// Checking simmetry
 	for(size_t i = 0; i < 4; ++i){
 		if (bit_array_get(monomer_bitarray_ptr[i], start) && !bit_array_get(monomer_bitarray_ptr[3 - i], end)) {
+			NESSIE_STATS_ADD(quick_rejects, 1);
 			return palindrome;
 		}
 		else{
@@ -1004,6 +1309,7 @@ bool Nessie::routine_check_palindrome_symmetry_interval(BIT_ARRAY **monomer_bita
 //
 //	parameters:
 //		mask_kmer_ptr - ptr to a mask (uint8_t array) encoding the kmer
+//		alignment_ptr - ptr to a kmer_alignment that receives the alignment, the operations must fit k
 //		k - length of the kmer
 //		max_mm - max number of mismatch allowed
 //		max_gap - max number of gaps allowed
@@ -1012,26 +1318,31 @@ bool Nessie::routine_check_palindrome_symmetry_interval(BIT_ARRAY **monomer_bita
 //	note: implementation of a modified Needleman-Wunsch algorithm for global alignment
 //
 /////////////////////////////////////////////////////////////////////////////////////
-bool Nessie::routine_check_global_alignment(uint8_t *mask_kmer_ptr, std::vector<bool> *align_vector_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, int type){
+bool Nessie::routine_check_global_alignment(uint8_t *mask_kmer_ptr, kmer_alignment *alignment_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, int type){
 
 	// Variables
 	bool alignment = false;
-	long scoring_matrix[k + 1][k + 1];	// scoring matrix
+	long (*scoring_matrix)[k + 1] = (long (*)[k + 1]) workspace.get_scoring_matrix(k);	// scoring matrix
 	int m = 1, mm = -1, indls = -1; // m = match, mm = mismatch, indls = gap
 	size_t mm_c = 0, gap_c = 0;	// counters for mm and gap
-	align_vector_ptr->clear();
+	alignment_ptr->ops_len = 0;
 
 	// Other variables
 	size_t max_i, max_j;
 	long score_diag, score_up, score_left, max;
 
 	// Check first and last bases symmetry
+	NESSIE_STATS_ADD(windows, 1);
 	if ((0 == type) && (mm == Nessie::routine_compare_bases(mask_kmer_ptr, 0, k - 1, m, mm))){
+			NESSIE_STATS_ADD(quick_rejects, 1);
 			return alignment;
 	}
 	else if ((1 == type) && (mm == Nessie::routine_compare_bases_complement(mask_kmer_ptr, 0, k - 1, m, mm))){
+			NESSIE_STATS_ADD(quick_rejects, 1);
 			return alignment;
 	}
+	NESSIE_STATS_PHASE(STATS_PHASE_DP);
+	NESSIE_STATS_ADD(dp_cells, (k * (k - 1)) >> 1);	// cells with i + j <= k
 
 	// Initializing scoring_matrix
 	for(size_t i = 0; i <= k; ++i){
@@ -1073,9 +1384,12 @@ bool Nessie::routine_check_global_alignment(uint8_t *mask_kmer_ptr, std::vector<
 	long min_score = (max_gapmm) ? (std::max((max_i), (max_j)) - (max_gapmm << 1)) : (std::max((max_i), (max_j)) - ((max_mm + max_gap) << 1));
 	if (max < min_score){ return alignment; }
 
-	// Retrieving best alignment
+	// Retrieving best alignment, operations are collected in traceback order and packed reversed
+	NESSIE_STATS_ADD(tracebacks, 1);
 	size_t i = max_i, j = max_j;
 	int comp_score;
+	uint8_t trace[max_i + max_j];
+	size_t trace_len = 0;
 	while ((i > 0) || (j > 0)){
 		if ((i > 0) && (j > 0)){
 			comp_score = (0 == type) ? Nessie::routine_compare_bases(mask_kmer_ptr, i - 1, k - j, m, mm)
@@ -1086,30 +1400,27 @@ bool Nessie::routine_check_global_alignment(uint8_t *mask_kmer_ptr, std::vector<
 			if (m == comp_score) {
 				--i;
 				--j;
-				align_vector_ptr->push_back(true); // M = 01
-				align_vector_ptr->push_back(false);
+				trace[trace_len++] = ALIGNMENT_MATCH; // M = 01
 			}
 			else{
 				++mm_c;
 				--i;
 				--j;
-				align_vector_ptr->push_back(false); // m = 10
-				align_vector_ptr->push_back(true);
+				trace[trace_len++] = ALIGNMENT_MISMATCH; // m = 10
 			}
 		}
 		else if ((i > 0) && (scoring_matrix[i][j] == (scoring_matrix[i - 1][j] + indls))){
 			++gap_c;
 			--i;
-			align_vector_ptr->push_back(false);	// u = 00
-			align_vector_ptr->push_back(false);
+			trace[trace_len++] = ALIGNMENT_UP;	// u = 00
 		}
 		else{
 			++gap_c;
 			--j;
-			align_vector_ptr->push_back(true); // l = 11
-			align_vector_ptr->push_back(true);
+			trace[trace_len++] = ALIGNMENT_LEFT; // l = 11
 		}
 	}
+	pack_alignment(alignment_ptr, trace, trace_len);
 
 	// Check gaps and mismatches
 	if (max_gapmm){
@@ -1137,6 +1448,7 @@ bool Nessie::routine_check_global_alignment(uint8_t *mask_kmer_ptr, std::vector<
 //
 //	parameters:
 //		mask_kmer_ptr - ptr to a mask (uint8_t array) encoding the kmer
+//		alignment_ptr - ptr to a kmer_alignment that receives the alignment, the operations must fit k
 //		k - length of the kmer
 //		max_mm - max number of mismatch allowed
 //		max_gap - max number of gaps allowed
@@ -1147,7 +1459,7 @@ bool Nessie::routine_check_global_alignment(uint8_t *mask_kmer_ptr, std::vector<
 //	note: implementation of a modified Needleman-Wunsch algorithm for an interval
 //
 /////////////////////////////////////////////////////////////////////////////////////
-bool Nessie::routine_check_global_alignment_interval(uint8_t *mask_kmer_ptr, std::vector<bool> *align_vector_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, int type, size_t start, size_t end){
+bool Nessie::routine_check_global_alignment_interval(uint8_t *mask_kmer_ptr, kmer_alignment *alignment_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, int type, size_t start, size_t end){
 
 	if (start > end){ throw std::invalid_argument("Alignment interval: starting index is larger than ending index"); }
 	if ((end + 1) > k){ throw std::invalid_argument("Alignment interval: ending index is larger than sequence end"); }
@@ -1155,22 +1467,27 @@ bool Nessie::routine_check_global_alignment_interval(uint8_t *mask_kmer_ptr, std
 	// Variables
 	bool alignment = false;
 	size_t l = end - start + 1;;
-	long scoring_matrix[l + 1][l + 1];	// scoring matrix
+	long (*scoring_matrix)[l + 1] = (long (*)[l + 1]) workspace.get_scoring_matrix(l);	// scoring matrix
 	int m = 1, mm = -1, indls = -1; // m = match, mm = mismatch, indls = gap
 	size_t mm_c = 0, gap_c = 0;	// counters for mm and gap
-	align_vector_ptr->clear();
+	alignment_ptr->ops_len = 0;
 
 	// Other variables
 	size_t max_i, max_j;
 	long score_diag, score_up, score_left, max;
 
 	// Check first and last bases symmetry
+	NESSIE_STATS_ADD(windows, 1);
 	if ((0 == type) && (mm == Nessie::routine_compare_bases(mask_kmer_ptr, start, end, m, mm))){
+			NESSIE_STATS_ADD(quick_rejects, 1);
 			return alignment;
 	}
 	else if ((1 == type) && (mm == Nessie::routine_compare_bases_complement(mask_kmer_ptr, start, end, m, mm))){
+			NESSIE_STATS_ADD(quick_rejects, 1);
 			return alignment;
 	}
+	NESSIE_STATS_PHASE(STATS_PHASE_DP);
+	NESSIE_STATS_ADD(dp_cells, (l * (l - 1)) >> 1);	// cells with i + j <= l
 
 	// Initializing scoring_matrix
 	for(size_t i = 0; i <= l; ++i){
@@ -1212,9 +1529,12 @@ bool Nessie::routine_check_global_alignment_interval(uint8_t *mask_kmer_ptr, std
 	long min_score = (max_gapmm) ? (std::max((max_i), (max_j)) - (max_gapmm << 1)) : (std::max((max_i), (max_j)) - ((max_mm + max_gap) << 1));
 	if (max < min_score){ return alignment; }
 
-	// Retrieving best alignment
+	// Retrieving best alignment, operations are collected in traceback order and packed reversed
+	NESSIE_STATS_ADD(tracebacks, 1);
 	size_t i = max_i, j = max_j;
 	int comp_score;
+	uint8_t trace[max_i + max_j];
+	size_t trace_len = 0;
 	while ((i > 0) || (j > 0)){
 		if ((i > 0) && (j > 0)){
 			comp_score = (0 == type) ? Nessie::routine_compare_bases(mask_kmer_ptr, start + i - 1, end + 1 - j, m, mm)
@@ -1225,30 +1545,27 @@ bool Nessie::routine_check_global_alignment_interval(uint8_t *mask_kmer_ptr, std
 			if (m == comp_score) {
 				--i;
 				--j;
-				align_vector_ptr->push_back(true); // M = 01
-				align_vector_ptr->push_back(false);
+				trace[trace_len++] = ALIGNMENT_MATCH; // M = 01
 			}
 			else{
 				++mm_c;
 				--i;
 				--j;
-				align_vector_ptr->push_back(false); // m = 10
-				align_vector_ptr->push_back(true);
+				trace[trace_len++] = ALIGNMENT_MISMATCH; // m = 10
 			}
 		}
 		else if ((i > 0) && (scoring_matrix[i][j] == (scoring_matrix[i - 1][j] + indls))){
 			++gap_c;
 			--i;
-			align_vector_ptr->push_back(false);	// u = 00
-			align_vector_ptr->push_back(false);
+			trace[trace_len++] = ALIGNMENT_UP;	// u = 00
 		}
 		else{
 			++gap_c;
 			--j;
-			align_vector_ptr->push_back(true);	// l = 11
-			align_vector_ptr->push_back(true);
+			trace[trace_len++] = ALIGNMENT_LEFT;	// l = 11
 		}
 	}
+	pack_alignment(alignment_ptr, trace, trace_len);
 
 	// Check gaps and mismatches
 	if (max_gapmm){
@@ -1331,21 +1648,37 @@ int Nessie::routine_compare_bases_complement(uint8_t *mask_kmer_ptr, size_t i, s
 //	note:
 //
 /////////////////////////////////////////////////////////////////////////////////////
-HashTable *Nessie::routine_get_kmers_k_mirror(size_t k, size_t max_mm, size_t start, size_t end){	//size_t check = 0;
+HashTable *Nessie::routine_get_kmers_k_mirror(size_t k, size_t max_mm, size_t start, size_t end){
+
+	// Collecting hits into an HashTable
+	HashTableSink sink(false);
+	Nessie::routine_scan_kmers_k_mirror(k, max_mm, start, end, sink);
+
+	return sink.release_hash_table_ptr();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_kmers_k_mirror -- delivers to sink the hits (kmers of length k with a mirror symmetry in the interval)
+//
+//	parameters:
+//		k - length of the kmers searched
+//		max_mm - maximum number of mismatch allowed
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		sink - HitSink that receives the hits
+//
+//	note:
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_kmers_k_mirror(size_t k, size_t max_mm, size_t start, size_t end, HitSink &sink){	//size_t check = 0;
 
 	// Some variables
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
 	if (k > (end - start + 1)){ throw std::invalid_argument("Get mirrors k: k is longer than the sequence interval"); }
 
-	// Initializing HashTable
-	HashTable *hash_table_ptr = new HashTable(false);
-
-	// Creating BIT_ARRAY to store monomers indexes for the mask
-	BIT_ARRAY *monomer_bitarray[4];
-	BIT_ARRAY **monomer_bitarray_ptr = monomer_bitarray;
-	for (size_t i = 0; i < 4; ++i){
-		monomer_bitarray_ptr[i] = bit_array_create(k);
-	}
+	// BIT_ARRAY to store monomers indexes for the mask, reused from the workspace
+	BIT_ARRAY **monomer_bitarray_ptr = workspace.get_monomer_bitarrays(k);
 
 	// Defining bytes necessary to store the kmer
 	size_t dna_bytes = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
@@ -1360,27 +1693,20 @@ HashTable *Nessie::routine_get_kmers_k_mirror(size_t k, size_t max_mm, size_t st
 
 	// Check mirror simmetry for the first kmer
 	if (Nessie::check_mirror_symmetry(monomer_bitarray_ptr, k, max_mm)){
-		Kmer *kmer_ptr = new Kmer(k);	// defining ptr to new Kmer object
-		copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_ptr, dna_bytes);
-		kmer_ptr->indexes.push_back(start);
-		kmer_ptr->counts += 1;
-		hash_table_ptr->insert_kmer(kmer_ptr);	// adding Kmer to the HashTable
+		sink.add_hit(start, k, mask_kmer_ptr, dna_bytes, NULL);
 	}
 
 	// Sliding by one base at each iteration to get successive kmers and checking their simmetry
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = (start + 1); i <= (end - k + 1); ++i){
+		nessie_progress.update(i);
 		Nessie::routine_shift_bitarray_and_mask(monomer_bitarray_ptr, mask_kmer_ptr, dna_bytes, k, i);
 
 		if (Nessie::check_mirror_symmetry(monomer_bitarray_ptr, k, max_mm)){		//++check;
-			Kmer *kmer_ptr = new Kmer(k);
-			copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_ptr, dna_bytes);
-			kmer_ptr->indexes.push_back(i);
-			kmer_ptr->counts += 1;
-			hash_table_ptr->insert_kmer(kmer_ptr);
+			sink.add_hit(i, k, mask_kmer_ptr, dna_bytes, NULL);
 		}
 	}
 	//std::cout << "CHECK " << check << std::endl;
-	return hash_table_ptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -1397,25 +1723,54 @@ HashTable *Nessie::routine_get_kmers_k_mirror(size_t k, size_t max_mm, size_t st
 //	note:
 //
 /////////////////////////////////////////////////////////////////////////////////////
-HashTable *Nessie::routine_get_max_kmer_mirror(size_t k_max, size_t k_min, size_t modulo, size_t start, size_t end){	//size_t check = 0;
+HashTable *Nessie::routine_get_max_kmer_mirror(size_t k_max, size_t k_min, size_t modulo, size_t start, size_t end){
+
+	// Collecting hits into an HashTable
+	HashTableSink sink(true);
+	Nessie::routine_scan_max_kmer_mirror(k_max, k_min, modulo, start, end, sink);
+
+	return sink.release_hash_table_ptr();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_max_kmer_mirror -- delivers to sink the hits (longest kmers of maximum length max_k and minimum length min_k with a mirror symmetry in the interval)
+//
+//	parameters:
+//		max_k - max length of the kmers searched
+//		min_k - min length of the kmers searched
+//		modulo - max mismatch allowed are calculated as integer division k / modulo
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		sink - HitSink that receives the hits
+//
+//	note: if no mismatches are allowed the search is done by routine_scan_max_kmer_center, max_k can be 0 (no limit on length)
+//		  if mismatches are allowed and the LCE index is built the search is done by routine_scan_max_kmer_lce
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_max_kmer_mirror(size_t k_max, size_t k_min, size_t modulo, size_t start, size_t end, HitSink &sink){	//size_t check = 0;
 
 	// Some variables
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
 	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get max mirror: max_k is longer than the sequence interval"); }
 
+	// Perfect symmetry is searched around the centers, also if max_k is not defined
+	if (!modulo){
+		Nessie::routine_scan_max_kmer_center(k_max, k_min, start, end, 0, sink);
+		return;
+	}
+
+	// Mismatches are checked on the LCE index if built
+	if (lce_forward_ptr){
+		Nessie::routine_scan_max_kmer_lce(k_max, k_min, modulo, start, end, 0, sink);
+		return;
+	}
+
 	// Variables
-	bool added;
 	size_t added_end = 0;
 
-	// Initializing HashTable
-	HashTable *hash_table_ptr = new HashTable(false);
-
-	// Creating BIT_ARRAY to store monomers indexes for the mask
-	BIT_ARRAY *monomer_bitarray[4];
-	BIT_ARRAY **monomer_bitarray_ptr = monomer_bitarray;
-	for (size_t i = 0; i < 4; ++i){
-		monomer_bitarray_ptr[i] = bit_array_create(k_max);
-	}
+	// BIT_ARRAY to store monomers indexes for the mask, reused from the workspace
+	BIT_ARRAY **monomer_bitarray_ptr = workspace.get_monomer_bitarrays(k_max);
 
 	// Defining bytes necessary to store the kmer
 	size_t dna_bytes = (k_max >> 2) + (0 != (k_max & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
@@ -1433,7 +1788,6 @@ HashTable *Nessie::routine_get_max_kmer_mirror(size_t k_max, size_t k_min, size_
 	while (k >= k_min){
 		size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
 		if (Nessie::routine_check_mirror_symmetry_interval(monomer_bitarray_ptr, k_max, max_mm, 0, k - 1)){	//++check;
-			Kmer *kmer_ptr = new Kmer(k);
 			added_end = end_i;
 
 			// Defining bytes necessary to store the kmer k
@@ -1447,10 +1801,7 @@ HashTable *Nessie::routine_get_max_kmer_mirror(size_t k_max, size_t k_min, size_
 			// Initializing mask for the first kmer of length k in the interval
 			Nessie::routine_init_mask(mask_kmer_k_ptr, k, start);
 
-			copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-			kmer_ptr->indexes.push_back(start);
-			kmer_ptr->counts += 1;
-			hash_table_ptr->insert_kmer_var_len(kmer_ptr);
+			sink.add_hit(start, k, mask_kmer_k_ptr, dna_bytes_k, NULL);
 			break;
 		}
 	--k;
@@ -1459,7 +1810,9 @@ HashTable *Nessie::routine_get_max_kmer_mirror(size_t k_max, size_t k_min, size_
 
 	// Sliding by one base at each iteration to get successive kmers and checking their simmetry
 	size_t last_i = start + 1;
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = (start + 1); i <= (end - k_max + 1); ++i){
+		nessie_progress.update(i);
 		Nessie::routine_shift_bitarray_and_mask(monomer_bitarray_ptr, mask_kmer_ptr, dna_bytes, k_max, i);
 
 		size_t k = k_max;
@@ -1467,7 +1820,6 @@ HashTable *Nessie::routine_get_max_kmer_mirror(size_t k_max, size_t k_min, size_
 		while ((k >= k_min) && (end_i > added_end)){
 			size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
 			if (Nessie::routine_check_mirror_symmetry_interval(monomer_bitarray_ptr, k_max, max_mm, 0, k - 1)){	//++check;
-				Kmer *kmer_ptr = new Kmer(k);
 				added_end = end_i;
 
 				// Defining bytes necessary to store the kmer k
@@ -1481,10 +1833,7 @@ HashTable *Nessie::routine_get_max_kmer_mirror(size_t k_max, size_t k_min, size_
 				// Initializing mask for the first kmer of length k in the interval
 				Nessie::routine_init_mask(mask_kmer_k_ptr, k, i);
 
-				copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-				kmer_ptr->indexes.push_back(i);
-				kmer_ptr->counts += 1;
-				hash_table_ptr->insert_kmer_var_len(kmer_ptr);
+				sink.add_hit(i, k, mask_kmer_k_ptr, dna_bytes_k, NULL);
 				break;
 			}
 		--k;
@@ -1500,12 +1849,8 @@ HashTable *Nessie::routine_get_max_kmer_mirror(size_t k_max, size_t k_min, size_
 		// Defining bytes necessary to store the last interval kmer
 		size_t dna_bytes_l = (last_interval_length >> 2) + (0 != (last_interval_length & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
 
-		// Creating BIT_ARRAY to store monomers indexes for the mask
-		BIT_ARRAY *monomer_bitarray_l[4];
-		BIT_ARRAY **monomer_bitarray_l_ptr = monomer_bitarray_l;
-		for (size_t i = 0; i < 4; ++i){
-			monomer_bitarray_l_ptr[i] = bit_array_create(last_interval_length);
-		}
+		// BIT_ARRAY to store monomers indexes for the mask, reused from the workspace
+		BIT_ARRAY **monomer_bitarray_l_ptr = workspace.get_monomer_bitarrays(last_interval_length, 1);
 
 		// Defining the mask to encode the last interval kmer
 		uint8_t mask_kmer_l[dna_bytes_l];
@@ -1522,7 +1867,6 @@ HashTable *Nessie::routine_get_max_kmer_mirror(size_t k_max, size_t k_min, size_
 			while ((k >= k_min) && ((last_i + 1 + i + k - 1) > added_end)){ //std::cout << "- " << i << " " << end_i << " " << k << std::endl;
 				size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
 				if (Nessie::routine_check_mirror_symmetry_interval(monomer_bitarray_l_ptr, last_interval_length, max_mm, i, end_i)){	//++check;
-					Kmer *kmer_ptr = new Kmer(k);
 					added_end = last_i + 1 + i + k - 1;
 
 					// Defining bytes necessary to store the kmer k
@@ -1536,10 +1880,7 @@ HashTable *Nessie::routine_get_max_kmer_mirror(size_t k_max, size_t k_min, size_
 					// Initializing mask for the first kmer of length k in the interval
 					Nessie::routine_init_mask(mask_kmer_k_ptr, k, last_i + 1 + i);
 
-					copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-					kmer_ptr->indexes.push_back(last_i + 1 + i);
-					kmer_ptr->counts += 1;
-					hash_table_ptr->insert_kmer_var_len(kmer_ptr);
+					sink.add_hit(last_i + 1 + i, k, mask_kmer_k_ptr, dna_bytes_k, NULL);
 					break;
 				}
 			--k;
@@ -1549,7 +1890,6 @@ HashTable *Nessie::routine_get_max_kmer_mirror(size_t k_max, size_t k_min, size_
 	}
 
 	//std::cout << "CHECK " << check << std::endl;
-	return hash_table_ptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -1568,15 +1908,38 @@ HashTable *Nessie::routine_get_max_kmer_mirror(size_t k_max, size_t k_min, size_
 //	note:
 //
 /////////////////////////////////////////////////////////////////////////////////////
-HashTable *Nessie::routine_get_kmers_k_gap(size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t start, size_t end, int type){	//size_t check = 0;
+HashTable *Nessie::routine_get_kmers_k_gap(size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t start, size_t end, int type){
+
+	// Collecting hits into an HashTable
+	HashTableSink sink(false);
+	Nessie::routine_scan_kmers_k_gap(k, max_mm, max_gap, max_gapmm, start, end, type, sink);
+
+	return sink.release_hash_table_ptr();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_kmers_k_gap -- delivers to sink the hits (kmers of length k with a specific symmetry in the interval),
+//							   allows gap presence
+//
+//	parameters:
+//		k - length of the kmers searched
+//		max_mm - maximum number of mismatch allowed
+//		max_gap - max number of gaps allowed
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		type - symmetry checked: 0 = mirror, 1 = palindrome
+//		sink - HitSink that receives the hits
+//
+//	note:
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_kmers_k_gap(size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t start, size_t end, int type, HitSink &sink){	//size_t check = 0;
 
 	// Some variables
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
 	if (k > (end - start + 1)){ throw std::invalid_argument("Get kmers k gap: k is longer than the sequence interval"); }
 
-	// Initializing HashTable
-	HashTable *hash_table_ptr = new HashTable(false);
-
 	// Defining bytes necessary to store the kmer
 	size_t dna_bytes = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
 
@@ -1585,42 +1948,28 @@ HashTable *Nessie::routine_get_kmers_k_gap(size_t k, size_t max_mm, size_t max_g
 	uint8_t *mask_kmer_ptr = mask_kmer;
 	std::memset(mask_kmer, 0, dna_bytes);
 
+	// Defining the alignment, reused for every window
+	kmer_alignment *alignment_ptr = workspace.get_alignment(k);
+
 	// Initializing mask for the first kmer of length k in the interval
 	Nessie::routine_init_mask(mask_kmer_ptr, k, start);
-	std::vector<bool> *align_vector_ptr = new std::vector<bool>;
 
 	// Check mirror simmetry for the first kmer
-	if (Nessie::routine_check_global_alignment(mask_kmer_ptr, align_vector_ptr, k, max_mm, max_gap, max_gapmm, type)){
-		Kmer *kmer_ptr = new Kmer(k);	// defining ptr to new Kmer object
-		copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_ptr, dna_bytes);
-		kmer_ptr->indexes.push_back(start);
-		kmer_ptr->counts += 1;
-		kmer_ptr->alignment_ptr = align_vector_ptr;
-		hash_table_ptr->insert_kmer(kmer_ptr);	// adding Kmer to the HashTable
-	}
-	else{
-		delete align_vector_ptr;
+	if (Nessie::routine_check_global_alignment(mask_kmer_ptr, alignment_ptr, k, max_mm, max_gap, max_gapmm, type)){
+		sink.add_hit(start, k, mask_kmer_ptr, dna_bytes, alignment_ptr);
 	}
 
 	// Sliding by one base at each iteration to get successive kmers and checking their simmetry
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = (start + 1); i <= (end - k + 1); ++i){
+		nessie_progress.update(i);
 		Nessie::routine_shift_mask(mask_kmer_ptr, dna_bytes, k, i);
-		std::vector<bool> *align_vector_ptr_i = new std::vector<bool>;
-
-		if (Nessie::routine_check_global_alignment(mask_kmer_ptr, align_vector_ptr_i, k, max_mm, max_gap, max_gapmm, type)){		//++check;
-			Kmer *kmer_ptr = new Kmer(k);
-			copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_ptr, dna_bytes);
-			kmer_ptr->indexes.push_back(i);
-			kmer_ptr->counts += 1;
-			kmer_ptr->alignment_ptr = align_vector_ptr_i;
-			hash_table_ptr->insert_kmer(kmer_ptr);
-		}
-		else{
-			delete align_vector_ptr_i;
+
+		if (Nessie::routine_check_global_alignment(mask_kmer_ptr, alignment_ptr, k, max_mm, max_gap, max_gapmm, type)){		//++check;
+			sink.add_hit(i, k, mask_kmer_ptr, dna_bytes, alignment_ptr);
 		}
 	}
 	//std::cout << "CHECK " << check << std::endl;
-	return hash_table_ptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -1640,19 +1989,42 @@ HashTable *Nessie::routine_get_kmers_k_gap(size_t k, size_t max_mm, size_t max_g
 //	note:
 //
 /////////////////////////////////////////////////////////////////////////////////////
-HashTable *Nessie::routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end, int type){	//size_t check = 0;
+HashTable *Nessie::routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end, int type){
+
+	// Collecting hits into an HashTable
+	HashTableSink sink(true);
+	Nessie::routine_scan_max_kmer_gap(k_max, k_min, modulo, modulo_gap, modulo_gapmm, start, end, type, sink);
+
+	return sink.release_hash_table_ptr();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_max_kmer_gap -- delivers to sink the hits (longest kmers of maximum length max_k and minimum length min_k with a specific symmetry in the interval),
+//							    allows gap presence
+//
+//	parameters:
+//		max_k - max length of the kmers searched
+//		min_k - min length of the kmers searched
+//		modulo - max mismatch allowed are calculated as integer division k / modulo
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		type - symmetry checked: 0 = mirror, 1 = palindrome
+//		sink - HitSink that receives the hits
+//
+//	note:
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_max_kmer_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end, int type, HitSink &sink){	//size_t check = 0;
 
 	// Some variables
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
 	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get max kmer gap: max_k is longer than the sequence interval"); }
 
 	// Variables
-	bool added;
 	size_t added_end = 0;
 
-	// Initializing HashTable
-	HashTable *hash_table_ptr = new HashTable(false);
-
 	// Defining bytes necessary to store the kmer
 	size_t dna_bytes = (k_max >> 2) + (0 != (k_max & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
 
@@ -1661,10 +2033,11 @@ HashTable *Nessie::routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t m
 	uint8_t *mask_kmer_ptr = mask_kmer;
 	std::memset(mask_kmer, 0, dna_bytes);
 
+	// Defining the alignment, reused for every window
+	kmer_alignment *alignment_ptr = workspace.get_alignment(k_max);
+
 	// Initializing mask for the first kmer of length max_k in the interval
 	Nessie::routine_init_mask(mask_kmer_ptr, k_max, start);
-	std::vector<bool> *align_vector_ptr = new std::vector<bool>;
-	added = false;
 
 	size_t k = k_max;
 	size_t end_i = start + k - 1;
@@ -1672,8 +2045,7 @@ HashTable *Nessie::routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t m
 		size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
 		size_t max_gap = (modulo_gap) ? (k * modulo_gap) / 100 : 0;
 		size_t max_gapmm = (modulo_gapmm) ? (k * modulo_gapmm) / 100 : 0;
-		if (Nessie::routine_check_global_alignment_interval(mask_kmer_ptr, align_vector_ptr, k_max, max_mm, max_gap, max_gapmm, type, 0, k - 1)){	//++check;
-			Kmer *kmer_ptr = new Kmer(k);
+		if (Nessie::routine_check_global_alignment_interval(mask_kmer_ptr, alignment_ptr, k_max, max_mm, max_gap, max_gapmm, type, 0, k - 1)){	//++check;
 			added_end = end_i;
 
 			// Defining bytes necessary to store the kmer k
@@ -1687,28 +2059,19 @@ HashTable *Nessie::routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t m
 			// Initializing mask for the first kmer of length k in the interval
 			Nessie::routine_init_mask(mask_kmer_k_ptr, k, start);
 
-			copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-			kmer_ptr->indexes.push_back(start);
-			kmer_ptr->counts += 1;
-			kmer_ptr->alignment_ptr = align_vector_ptr;
-			added = true;
-			hash_table_ptr->insert_kmer_var_len(kmer_ptr);
+			sink.add_hit(start, k, mask_kmer_k_ptr, dna_bytes_k, alignment_ptr);
 			break;
 		}
 	--k;
 	--end_i;
 	}
 
-	if (!added){
-		delete align_vector_ptr;
-	}
-
 	// Sliding by one base at each iteration to get successive kmers and checking their simmetry
 	size_t last_i = start + 1;
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = (start + 1); i <= (end - k_max + 1); ++i){
+		nessie_progress.update(i);
 		Nessie::routine_shift_mask(mask_kmer_ptr, dna_bytes, k_max, i);
-		std::vector<bool> *align_vector_ptr_i = new std::vector<bool>;
-		added = false;
 
 		size_t k = k_max;
 		size_t end_i = i + k - 1;
@@ -1716,8 +2079,7 @@ HashTable *Nessie::routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t m
 			size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
 			size_t max_gap = (modulo_gap) ? (k * modulo_gap) / 100 : 0;
 			size_t max_gapmm = (modulo_gapmm) ? (k * modulo_gapmm) / 100 : 0;
-			if (Nessie::routine_check_global_alignment_interval(mask_kmer_ptr, align_vector_ptr_i, k_max, max_mm, max_gap, max_gapmm, type, 0, k - 1)){	//++check;
-				Kmer *kmer_ptr = new Kmer(k);
+			if (Nessie::routine_check_global_alignment_interval(mask_kmer_ptr, alignment_ptr, k_max, max_mm, max_gap, max_gapmm, type, 0, k - 1)){	//++check;
 				added_end = end_i;
 
 				// Defining bytes necessary to store the kmer k
@@ -1731,12 +2093,7 @@ HashTable *Nessie::routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t m
 				// Initializing mask for the first kmer of length k in the interval
 				Nessie::routine_init_mask(mask_kmer_k_ptr, k, i);
 
-				copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-				kmer_ptr->indexes.push_back(i);
-				kmer_ptr->counts += 1;
-				kmer_ptr->alignment_ptr = align_vector_ptr_i;
-				added = true;
-				hash_table_ptr->insert_kmer_var_len(kmer_ptr);
+				sink.add_hit(i, k, mask_kmer_k_ptr, dna_bytes_k, alignment_ptr);
 				break;
 			}
 		--k;
@@ -1744,9 +2101,6 @@ HashTable *Nessie::routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t m
 		}
 		last_i = i;
 
-		if (!added){
-			delete align_vector_ptr_i;
-		}
 	}
 
 	// Check last interval that may be shorter than k_max and skipped in previous for loop
@@ -1765,8 +2119,6 @@ HashTable *Nessie::routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t m
 		Nessie::routine_init_mask(mask_kmer_l_ptr, last_interval_length, last_i + 1);
 
 		for (size_t i = 0; i <= (last_interval_length - k_min); ++i){
-			std::vector<bool> *align_vector_ptr_l = new std::vector<bool>;
-			added = false;
 
 			size_t k = last_interval_length - i;
 			size_t end_i = last_interval_length - 1; //std::cout << i << " " << k << std::endl;
@@ -1774,8 +2126,7 @@ HashTable *Nessie::routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t m
 				size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
 				size_t max_gap = (modulo_gap) ? (k * modulo_gap) / 100 : 0;
 				size_t max_gapmm = (modulo_gapmm) ? (k * modulo_gapmm) / 100 : 0;
-				if (Nessie::routine_check_global_alignment_interval(mask_kmer_l_ptr, align_vector_ptr_l, last_interval_length, max_mm, max_gap, max_gapmm, type, i, end_i)){	//++check;
-					Kmer *kmer_ptr = new Kmer(k);
+				if (Nessie::routine_check_global_alignment_interval(mask_kmer_l_ptr, alignment_ptr, last_interval_length, max_mm, max_gap, max_gapmm, type, i, end_i)){	//++check;
 					added_end = last_i + 1 + i + k - 1;
 
 					// Defining bytes necessary to store the kmer k
@@ -1789,26 +2140,17 @@ HashTable *Nessie::routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t m
 					// Initializing mask for the first kmer of length k in the interval
 					Nessie::routine_init_mask(mask_kmer_k_ptr, k, last_i + 1 + i);
 
-					copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-					kmer_ptr->indexes.push_back(last_i + 1 + i);
-					kmer_ptr->counts += 1;
-					kmer_ptr->alignment_ptr = align_vector_ptr_l;
-					added = true;
-					hash_table_ptr->insert_kmer_var_len(kmer_ptr);
+					sink.add_hit(last_i + 1 + i, k, mask_kmer_k_ptr, dna_bytes_k, alignment_ptr);
 					break;
 				}
 			--k;
 			--end_i;
 			}
 
-			if (!added){
-				delete align_vector_ptr_l;
-			}
 		}
 	}
 
 	//std::cout << "CHECK " << check << std::endl;
-	return hash_table_ptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -1824,21 +2166,37 @@ HashTable *Nessie::routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t m
 //	note:
 //
 /////////////////////////////////////////////////////////////////////////////////////
-HashTable *Nessie::routine_get_kmers_k_palindrome(size_t k, size_t max_mm, size_t start, size_t end){	//size_t check = 0;
+HashTable *Nessie::routine_get_kmers_k_palindrome(size_t k, size_t max_mm, size_t start, size_t end){
+
+	// Collecting hits into an HashTable
+	HashTableSink sink(false);
+	Nessie::routine_scan_kmers_k_palindrome(k, max_mm, start, end, sink);
+
+	return sink.release_hash_table_ptr();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_kmers_k_palindrome -- delivers to sink the hits (kmers of length k with a palindrome symmetry in the interval)
+//
+//	parameters:
+//		k - length of the kmers searched
+//		max_mm - maximum number of mismatch allowed
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		sink - HitSink that receives the hits
+//
+//	note:
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_kmers_k_palindrome(size_t k, size_t max_mm, size_t start, size_t end, HitSink &sink){	//size_t check = 0;
 
 	// Some variables
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
 	if (k > (end - start + 1)){ throw std::invalid_argument("Get palindromes k: k is longer than the sequence interval"); }
 
-	// Initializing HashTable
-	HashTable *hash_table_ptr = new HashTable(false);
-
-	// Creating BIT_ARRAY to store monomers indexes for the mask
-	BIT_ARRAY *monomer_bitarray[4];
-	BIT_ARRAY **monomer_bitarray_ptr = monomer_bitarray;
-	for (size_t i = 0; i < 4; ++i){
-		monomer_bitarray_ptr[i] = bit_array_create(k);
-	}
+	// BIT_ARRAY to store monomers indexes for the mask, reused from the workspace
+	BIT_ARRAY **monomer_bitarray_ptr = workspace.get_monomer_bitarrays(k);
 
 	// Defining bytes necessary to store the kmer
 	size_t dna_bytes = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
@@ -1853,27 +2211,20 @@ HashTable *Nessie::routine_get_kmers_k_palindrome(size_t k, size_t max_mm, size_
 
 	// Check palindrome simmetry for the first kmer
 	if (Nessie::check_palindrome_symmetry(monomer_bitarray_ptr, k, max_mm)){
-		Kmer *kmer_ptr = new Kmer(k);	// defining ptr to new Kmer object
-		copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_ptr, dna_bytes);
-		kmer_ptr->indexes.push_back(start);
-		kmer_ptr->counts += 1;
-		hash_table_ptr->insert_kmer(kmer_ptr);	// adding Kmer to the HashTable
+		sink.add_hit(start, k, mask_kmer_ptr, dna_bytes, NULL);
 	}
 
 	// Sliding by one base at each iteration to get successive kmers and checking their simmetry
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = (start + 1); i <= (end - k + 1); ++i){
+		nessie_progress.update(i);
 		Nessie::routine_shift_bitarray_and_mask(monomer_bitarray_ptr, mask_kmer_ptr, dna_bytes, k, i);
 
 		if (Nessie::check_palindrome_symmetry(monomer_bitarray_ptr, k, max_mm)){	//++check;
-			Kmer *kmer_ptr = new Kmer(k);
-			copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_ptr, dna_bytes);
-			kmer_ptr->indexes.push_back(i);
-			kmer_ptr->counts += 1;
-			hash_table_ptr->insert_kmer(kmer_ptr);
+			sink.add_hit(i, k, mask_kmer_ptr, dna_bytes, NULL);
 		}
 	}
 	//std::cout << "CHECK " << check << std::endl;
-	return hash_table_ptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -1890,25 +2241,54 @@ HashTable *Nessie::routine_get_kmers_k_palindrome(size_t k, size_t max_mm, size_
 //	note:
 //
 /////////////////////////////////////////////////////////////////////////////////////
-HashTable *Nessie::routine_get_max_kmer_palindrome(size_t k_max, size_t k_min, size_t modulo, size_t start, size_t end){	//size_t check = 0;
+HashTable *Nessie::routine_get_max_kmer_palindrome(size_t k_max, size_t k_min, size_t modulo, size_t start, size_t end){
+
+	// Collecting hits into an HashTable
+	HashTableSink sink(true);
+	Nessie::routine_scan_max_kmer_palindrome(k_max, k_min, modulo, start, end, sink);
+
+	return sink.release_hash_table_ptr();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_max_kmer_palindrome -- delivers to sink the hits (longest kmers of maximum length max_k and minimum length min_k with a palindrome symmetry in the interval)
+//
+//	parameters:
+//		max_k - max length of the kmers searched
+//		min_k - min length of the kmers searched
+//		modulo - max mismatch allowed are calculated as integer division k / modulo
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		sink - HitSink that receives the hits
+//
+//	note: if no mismatches are allowed the search is done by routine_scan_max_kmer_center, max_k can be 0 (no limit on length)
+//		  if mismatches are allowed and the LCE index is built the search is done by routine_scan_max_kmer_lce
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_max_kmer_palindrome(size_t k_max, size_t k_min, size_t modulo, size_t start, size_t end, HitSink &sink){	//size_t check = 0;
 
 	// Some variables
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
 	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get max palindrome: max_k is longer than the sequence interval"); }
 
+	// Perfect symmetry is searched around the centers, also if max_k is not defined
+	if (!modulo){
+		Nessie::routine_scan_max_kmer_center(k_max, k_min, start, end, 1, sink);
+		return;
+	}
+
+	// Mismatches are checked on the LCE index if built
+	if (lce_forward_ptr){
+		Nessie::routine_scan_max_kmer_lce(k_max, k_min, modulo, start, end, 1, sink);
+		return;
+	}
+
 	// Variables
-	bool added;
 	size_t added_end = 0;
 
-	// Initializing HashTable
-	HashTable *hash_table_ptr = new HashTable(false);
-
-	// Creating BIT_ARRAY to store monomers indexes for the mask
-	BIT_ARRAY *monomer_bitarray[4];
-	BIT_ARRAY **monomer_bitarray_ptr = monomer_bitarray;
-	for (size_t i = 0; i < 4; ++i){
-		monomer_bitarray_ptr[i] = bit_array_create(k_max);
-	}
+	// BIT_ARRAY to store monomers indexes for the mask, reused from the workspace
+	BIT_ARRAY **monomer_bitarray_ptr = workspace.get_monomer_bitarrays(k_max);
 
 	// Defining bytes necessary to store the kmer
 	size_t dna_bytes = (k_max >> 2) + (0 != (k_max & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
@@ -1926,7 +2306,6 @@ HashTable *Nessie::routine_get_max_kmer_palindrome(size_t k_max, size_t k_min, s
 	while (k >= k_min){
 		size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
 		if (Nessie::routine_check_palindrome_symmetry_interval(monomer_bitarray_ptr, k_max, max_mm, 0, k - 1)){	//++check;
-			Kmer *kmer_ptr = new Kmer(k);
 			added_end = end_i;
 
 			// Defining bytes necessary to store the kmer k
@@ -1940,10 +2319,7 @@ HashTable *Nessie::routine_get_max_kmer_palindrome(size_t k_max, size_t k_min, s
 			// Initializing mask for the first kmer of length k in the interval
 			Nessie::routine_init_mask(mask_kmer_k_ptr, k, start);
 
-			copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-			kmer_ptr->indexes.push_back(start);
-			kmer_ptr->counts += 1;
-			hash_table_ptr->insert_kmer_var_len(kmer_ptr);
+			sink.add_hit(start, k, mask_kmer_k_ptr, dna_bytes_k, NULL);
 			break;
 		}
 	--k;
@@ -1952,7 +2328,9 @@ HashTable *Nessie::routine_get_max_kmer_palindrome(size_t k_max, size_t k_min, s
 
 	// Sliding by one base at each iteration to get successive kmers and checking their simmetry
 	size_t last_i = start + 1;
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = (start + 1); i <= (end - k_max + 1); ++i){
+		nessie_progress.update(i);
 		Nessie::routine_shift_bitarray_and_mask(monomer_bitarray_ptr, mask_kmer_ptr, dna_bytes, k_max, i);
 
 		size_t k = k_max;
@@ -1960,7 +2338,6 @@ HashTable *Nessie::routine_get_max_kmer_palindrome(size_t k_max, size_t k_min, s
 		while ((k >= k_min) && (end_i > added_end)){
 			size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
 			if (Nessie::routine_check_palindrome_symmetry_interval(monomer_bitarray_ptr, k_max, max_mm, 0, k - 1)){	//++check;
-				Kmer *kmer_ptr = new Kmer(k);
 				added_end = end_i;
 
 				// Defining bytes necessary to store the kmer k
@@ -1974,10 +2351,7 @@ HashTable *Nessie::routine_get_max_kmer_palindrome(size_t k_max, size_t k_min, s
 				// Initializing mask for the first kmer of length k in the interval
 				Nessie::routine_init_mask(mask_kmer_k_ptr, k, i);
 
-				copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-				kmer_ptr->indexes.push_back(i);
-				kmer_ptr->counts += 1;
-				hash_table_ptr->insert_kmer_var_len(kmer_ptr);
+				sink.add_hit(i, k, mask_kmer_k_ptr, dna_bytes_k, NULL);
 				break;
 			}
 		--k;
@@ -1993,12 +2367,8 @@ HashTable *Nessie::routine_get_max_kmer_palindrome(size_t k_max, size_t k_min, s
 		// Defining bytes necessary to store the last interval kmer
 		size_t dna_bytes_l = (last_interval_length >> 2) + (0 != (last_interval_length & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
 
-		// Creating BIT_ARRAY to store monomers indexes for the mask
-		BIT_ARRAY *monomer_bitarray_l[4];
-		BIT_ARRAY **monomer_bitarray_l_ptr = monomer_bitarray_l;
-		for (size_t i = 0; i < 4; ++i){
-			monomer_bitarray_l_ptr[i] = bit_array_create(last_interval_length);
-		}
+		// BIT_ARRAY to store monomers indexes for the mask, reused from the workspace
+		BIT_ARRAY **monomer_bitarray_l_ptr = workspace.get_monomer_bitarrays(last_interval_length, 1);
 
 		// Defining the mask to encode the last interval kmer
 		uint8_t mask_kmer_l[dna_bytes_l];
@@ -2015,7 +2385,6 @@ HashTable *Nessie::routine_get_max_kmer_palindrome(size_t k_max, size_t k_min, s
 			while ((k >= k_min) && ((last_i + 1 + i + k - 1) > added_end)){ //std::cout << "- " << i << " " << end_i << " " << k << std::endl;
 				size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
 				if (Nessie::routine_check_palindrome_symmetry_interval(monomer_bitarray_l_ptr, last_interval_length, max_mm, i, end_i)){ //++check;
-					Kmer *kmer_ptr = new Kmer(k);
 					added_end = last_i + 1 + i + k - 1;
 
 					// Defining bytes necessary to store the kmer k
@@ -2029,10 +2398,7 @@ HashTable *Nessie::routine_get_max_kmer_palindrome(size_t k_max, size_t k_min, s
 					// Initializing mask for the first kmer of length k in the interval
 					Nessie::routine_init_mask(mask_kmer_k_ptr, k, last_i + 1 + i);
 
-					copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-					kmer_ptr->indexes.push_back(last_i + 1 + i);
-					kmer_ptr->counts += 1;
-					hash_table_ptr->insert_kmer_var_len(kmer_ptr);
+					sink.add_hit(last_i + 1 + i, k, mask_kmer_k_ptr, dna_bytes_k, NULL);
 					break;
 				}
 			--k;
@@ -2042,7 +2408,6 @@ HashTable *Nessie::routine_get_max_kmer_palindrome(size_t k_max, size_t k_min, s
 	}
 
 	//std::cout << "CHECK " << check << std::endl;
-	return hash_table_ptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -2097,63 +2462,563 @@ void Nessie::routine_init_mask(uint8_t *mask_kmer_ptr, size_t k, size_t start){
 
 /////////////////////////////////////////////////////////////////////////////////////
 //
-//	routine_shift_bitarray_and_mask -- shifts the BIT_ARRAY and the mask by one base
+//	routine_shift_bitarray_and_mask -- shifts the BIT_ARRAY and the mask by one base
+//
+//	parameters:
+//		monomer_bitarray_ptr - ptr to a *BIT_ARRAY[4]
+//		mask_kmer_ptr - ptr to a uint8_t array that encodes a kmer
+//		mask_kmer_len - length of the uint8_t array that encodes the kmer
+//		k - length of the kmer searched
+//		i - index from the loop step
+//
+//	note:
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_shift_bitarray_and_mask(BIT_ARRAY **monomer_bitarray_ptr, uint8_t *mask_kmer_ptr, size_t mask_kmer_len, size_t k, size_t i){
+
+	// Variables
+	size_t last_index = k - 1;
+	uint8_t shift_mask = (last_index & ((1 << 2) - 1)) << 1;
+
+	// Shift
+	uint8_t shift_DNA = ((i + last_index) & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
+	uint8_t base = (string_bit_ptr->data_ptr[(i + last_index) >> 2] & (BASE_MASK << shift_DNA)) >> shift_DNA;	// retrieving the ENCODING
+	shift_2_right(mask_kmer_ptr, mask_kmer_len);	// shift the uint8_t array encoding the kmer (removes the first base)
+	mask_kmer_ptr[last_index >> 2] |= base << shift_mask;	// adding the new base to mask_kmer
+	for(size_t i = 0; i < 4; ++i){	//shift monomer_bitarray by one
+		if (i == base) {
+			bit_array_shift_right(monomer_bitarray_ptr[i], 1, 1);	// set bit in the monomer_bitarray corresponding to the new base index
+		}
+		else{
+			bit_array_shift_right(monomer_bitarray_ptr[i], 1, 0);
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_shift_mask -- shifts the mask by one base
+//
+//	parameters:
+//		mask_kmer_ptr - ptr to a uint8_t array that encodes a kmer
+//		mask_kmer_len - length of the uint8_t array that encodes the kmer
+//		k - length of the kmer searched
+//		i - index from the loop step
+//
+//	note:
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_shift_mask(uint8_t *mask_kmer_ptr, size_t mask_kmer_len, size_t k, size_t i){
+
+	// Variables
+	size_t last_index = k - 1;
+	uint8_t shift_mask = (last_index & ((1 << 2) - 1)) << 1;
+
+	// Shift
+	uint8_t shift_DNA = ((i + last_index) & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
+	uint8_t base = (string_bit_ptr->data_ptr[(i + last_index) >> 2] & (BASE_MASK << shift_DNA)) >> shift_DNA;	// retrieving the ENCODING
+	shift_2_right(mask_kmer_ptr, mask_kmer_len);	// shift the uint8_t array encoding the kmer (removes the first base)
+	mask_kmer_ptr[last_index >> 2] |= base << shift_mask;	// adding the new base to mask_kmer
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_sorted_kmers -- delivers to sink the hits (kmers of length [k_min..k_max] with a specific symmetry in the interval)
+//								 in ascending order of index, for each index the hits are delivered in ascending order of length
+//
+//	parameters:
+//		k_min - min length of the kmers searched
+//		k_max - max length of the kmers searched
+//		modulo - max mismatch allowed are calculated as integer division k / modulo
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap
+//		modulo_gapmm - max gaps and mismatches allowed in total are calculated as integer division k / modulo_gapmm
+//		modulo_purine - max number on non-purines allowed are calculated as integer division k / modulo_purine, used only for triplex
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		type - symmetry checked: 0 = mirror, 1 = palindrome, 2 = triplex
+//		sink - HitSink that receives the hits
+//
+//	note: the interval is scanned only once and all the lengths are checked at each index.
+//		  Kmers with the same center share the inner pairs of bases, kmer (i, k) is kmer (i + 1, k - 2) plus its outer pair.
+//		  The mismatches of every center are counted once from the innermost pair outwards (center_mm),
+//		  so that the symmetry of any kmer without gaps is checked in constant time.
+//		  Centers are in doubled coordinates (2 * i + k - 1) and stored in a circular buffer, since only k_max - k_min + 1 are alive at each index.
+//		  Kmers allowing for gaps are aligned on a window of length k_max sliding by one base,
+//		  once the window reaches the end of the interval it stops and the remaining indexes are checked as sub-intervals of the last window.
+//		  For each k the check (with or without gaps) gives the same result of the routines for a single k.
+//		  For triplex only the seeds are checked (routine_get_triplex_seeds)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_sorted_kmers(size_t k_min, size_t k_max, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, size_t start, size_t end, int type, HitSink &sink){	//size_t check = 0;
+
+	// Some variables
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get sorted kmers: max_k is longer than the sequence interval"); }
+	if (!k_min){ throw std::invalid_argument("Get sorted kmers: min_k must be larger than 0"); }
+	if (type < 0 || type > 2){ throw std::invalid_argument("Get sorted kmers: type is not valid"); }
+
+	// Variables
+	uint8_t *data_ptr = string_bit_ptr->data_ptr;
+	uint8_t match = (1 == type) ? 3 : 0;	// xor of two matching bases, complement for palindrome (A^T = C^G = 3)
+	size_t h_max = k_max >> 1;	// max number of pairs in a kmer
+	size_t center_len = k_max + 2;	// length of the circular buffer for the centers
+	size_t next_center = (start << 1) + k_min - 1;	// first center not yet counted
+
+	// Creating the circular buffer to store the mismatches cumulated for each center, center_mm[c][t] = mismatches in the t innermost pairs
+	size_t *center_mm_ptr = new size_t[center_len * (h_max + 1)];
+
+	// Defining bytes necessary to store the kmer
+	size_t dna_bytes = (k_max >> 2) + (0 != (k_max & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
+
+	// Defining the mask to encode the kmer
+	uint8_t mask_kmer[dna_bytes];
+	uint8_t *mask_kmer_ptr = mask_kmer;
+	std::memset(mask_kmer, 0, dna_bytes);
+
+	// Defining the alignment, reused for every window
+	kmer_alignment *alignment_ptr = workspace.get_alignment(k_max);
+
+	// Initializing mask for the first window of length k_max in the interval
+	Nessie::routine_init_mask(mask_kmer_ptr, k_max, start);
+
+	// Getting the indexes that can start a kmer with the composition for triplex, the other indexes are skipped
+	BIT_ARRAY *seeds_ptr = (2 == type) ? Nessie::routine_get_triplex_seeds(k_min, k_max, modulo_purine, start, end) : NULL;
+
+	// Sliding by one base at each iteration, the window stops at the last index with k_max bases available
+	size_t last_window = end - k_max + 1;
+	nessie_progress.begin_pass(offset, start, end);
+	for (size_t i = start; i <= (end - k_min + 1); ++i){
+		nessie_progress.update(i);
+		if ((i > start) && (i <= last_window)){
+			Nessie::routine_shift_mask(mask_kmer_ptr, dna_bytes, k_max, i);
+		}
+
+		if (seeds_ptr && !bit_array_get_bit(seeds_ptr, i - start)){
+			continue;
+		}
+
+		size_t window_offset = (i > last_window) ? i - last_window : 0;	// starting index of the kmers in the window
+
+		// Counting purines for the first k_min - 1 bases, the other bases are added one by one with k
+		size_t purine_c = 0;
+		for (size_t j = i; j < (i + k_min - 1); ++j){
+			purine_c += Nessie::routine_is_purine(j);
+		}
+
+		for (size_t k = k_min; k <= (k_max - window_offset); ++k){
+			size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
+			size_t max_gap = (modulo_gap) ? (k * modulo_gap) / 100 : 0;
+			size_t max_gapmm = (modulo_gapmm) ? (k * modulo_gapmm) / 100 : 0;
+			size_t max_purine = (modulo_purine) ? (k * modulo_purine) / 100 : 0;
+			bool gap = (max_gap || max_gapmm);
+			bool found = false;
+
+			// Adding last base to purine counts
+			purine_c += Nessie::routine_is_purine(i + k - 1);
+
+			// Counting mismatches for a new center, from the innermost pair to the outer pair of kmer (i, k)
+			size_t center = (i << 1) + k - 1;
+			size_t h = k >> 1;	// number of pairs in kmer (i, k)
+			size_t *center_mm = center_mm_ptr + (center % center_len) * (h_max + 1);
+			if (center >= next_center){
+				size_t left = (center - 1) >> 1, right = (center >> 1) + 1;	// innermost pair
+				center_mm[0] = 0;
+				for (size_t t = 0; t < h; ++t){
+					uint8_t shift_left = ((left - t) & ((1 << 2) - 1)) << 1;
+					uint8_t shift_right = ((right + t) & ((1 << 2) - 1)) << 1;
+					uint8_t base_left = (data_ptr[(left - t) >> 2] >> shift_left) & BASE_MASK;
+					uint8_t base_right = (data_ptr[(right + t) >> 2] >> shift_right) & BASE_MASK;
+					center_mm[t + 1] = center_mm[t] + ((base_left ^ base_right) != match);
+				}
+				next_center = center + 1;
+			}
+
+			// Check composition for triplex
+			if ((2 == type) && !Nessie::routine_check_purine(purine_c, k, max_purine)){
+				continue;
+			}
+
+			// Check if gaps allowed or not
+			if (gap && (2 == type)){
+				found = Nessie::routine_check_triplex_forming_gap_interval(mask_kmer_ptr, alignment_ptr, k_max, max_mm, max_gap, max_gapmm, max_purine, window_offset, window_offset + k - 1);
+			}
+			else if (gap){
+				found = Nessie::routine_check_global_alignment_interval(mask_kmer_ptr, alignment_ptr, k_max, max_mm, max_gap, max_gapmm, type, window_offset, window_offset + k - 1);
+			}
+			else if (!h){	// single base, it is compared with itself
+				found = (0 == match);
+			}
+			else{	// outer pair must match, mismatches are allowed only in the inner pairs
+				found = (center_mm[h] == center_mm[h - 1]) && (center_mm[h - 1] <= max_mm);
+			}
+
+			if (found){	//++check;
+				// Defining bytes necessary to store the kmer k
+				size_t dna_bytes_k = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
+
+				// Defining the mask to encode the kmer k
+				uint8_t mask_kmer_k[dna_bytes_k];
+				uint8_t *mask_kmer_k_ptr = mask_kmer_k;
+				std::memset(mask_kmer_k, 0, dna_bytes_k);
+
+				// Initializing mask for the kmer of length k at index i
+				Nessie::routine_init_mask(mask_kmer_k_ptr, k, i);
+
+				sink.add_hit(i, k, mask_kmer_k_ptr, dna_bytes_k, (gap) ? alignment_ptr : NULL);
+			}
+		}
+	}
+
+	delete[] center_mm_ptr;
+	if (seeds_ptr){
+		bit_array_free(seeds_ptr);
+	}
+	//std::cout << "CHECK " << check << std::endl;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_get_center_arms -- fills arm_ptr with the number of matching pairs around each center of the interval (arms of the longest perfect symmetry)
+//
+//	parameters:
+//		arm_ptr - ptr to the array to fill, length 2 * (end - start + 1) - 1, center c is stored at arm_ptr[c - 2 * start]
+//		start - starting index of the interval
+//		end - ending index of the interval
+//		type - symmetry checked: 0 = mirror, 1 = palindrome
+//
+//	note: centers are in doubled coordinates (2 * i + k - 1 for kmer (i, k)), the pairs of center c are (l - t, r + t) with r = c / 2 + 1 and l = c - r.
+//		  Even centers have a middle base that is not paired, odd centers do not.
+//		  The arms are computed as in Manacher algorithm, the arm of a center inside the longest arm found so far (box)
+//		  is initialized with the arm of its reflection in the box and then extended base by base.
+//		  For mirrors any center can be used as box, for palindromes only odd centers,
+//		  since the middle base of an even center is not the complement of itself and the reflection does not hold across it.
+//		  The arms of mirrors and of even palindromes are computed in linear time,
+//		  odd palindromes may extend inside the box of an even one without moving it
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_get_center_arms(size_t *arm_ptr, size_t start, size_t end, int type){
+
+	// Variables
+	uint8_t *data_ptr = string_bit_ptr->data_ptr;
+	uint8_t match = (1 == type) ? 3 : 0;	// xor of two matching bases, complement for palindrome (A^T = C^G = 3)
+	size_t box_center = 0, box_right = 0;	// center and rightmost paired base of the box
+	bool box = false;
+
+	for (size_t c = (start << 1); c <= (end << 1); ++c){
+		size_t right = (c >> 1) + 1;	// innermost pair
+		size_t left = c - right;
+		size_t arm = 0;
+
+		// Initializing the arm with its reflection inside the box
+		if (box && (right <= box_right)){
+			size_t reflection = (box_center << 1) - c;
+			arm = arm_ptr[reflection - (start << 1)];
+			if (arm > (box_right - right + 1)){ arm = box_right - right + 1; }
+		}
+
+		// Extending the arm base by base, c = 2 * start has no pairs
+		if (c > (start << 1)){
+			while ((arm <= (left - start)) && ((right + arm) <= end)){
+				uint8_t shift_left = ((left - arm) & ((1 << 2) - 1)) << 1;
+				uint8_t shift_right = ((right + arm) & ((1 << 2) - 1)) << 1;
+				uint8_t base_left = (data_ptr[(left - arm) >> 2] >> shift_left) & BASE_MASK;
+				uint8_t base_right = (data_ptr[(right + arm) >> 2] >> shift_right) & BASE_MASK;
+				if ((base_left ^ base_right) != match){ break; }
+				++arm;
+			}
+		}
+		arm_ptr[c - (start << 1)] = arm;
+
+		// Moving the box
+		if (arm && ((right + arm - 1) > box_right || !box) && ((c & 1) || (0 == type))){
+			box_center = c;
+			box_right = right + arm - 1;
+			box = true;
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_max_kmer_center -- delivers to sink the hits (longest kmers of maximum length max_k and minimum length min_k with a perfect symmetry in the interval),
+//									the symmetry is searched around each center instead of checking each length at each index
+//
+//	parameters:
+//		max_k - max length of the kmers searched, if 0 the length of the kmers is not limited
+//		min_k - min length of the kmers searched
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		type - symmetry checked: 0 = mirror, 1 = palindrome
+//		sink - HitSink that receives the hits
+//
+//	note: the hits are the same of routine_scan_max_kmer_mirror and routine_scan_max_kmer_palindrome without mismatches.
+//		  A kmer (i, k) has a perfect symmetry if the arm of its center 2 * i + k - 1 reaches index i,
+//		  then the longest kmer at index i is given by the largest center whose arm reaches i (and that is not further than max_k).
+//		  Each center is assigned to the first index from which it can be used (last), and the largest center is kept while sliding,
+//		  the kmer is added if it ends after the last kmer added (added_end) so that kmers contained in a previous one are skipped.
+//		  Time is linear in the interval length, the arms and the centers take 3 size_t for each base of the interval
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_max_kmer_center(size_t k_max, size_t k_min, size_t start, size_t end, int type, HitSink &sink){	//size_t check = 0;
+
+	// Some variables
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get max center: max_k is longer than the sequence interval"); }
+	if (!k_min){ throw std::invalid_argument("Get max center: min_k must be larger than 0"); }
+	if (type < 0 || type > 1){ throw std::invalid_argument("Get max center: type is not valid"); }
+
+	// Variables
+	size_t interval_len = end - start + 1;
+	size_t added_end = 0;
+	bool added = false;
+
+	// Computing the arms for each center of the interval
+	size_t *arm_ptr = new size_t[(interval_len << 1) - 1];
+	Nessie::routine_get_center_arms(arm_ptr, start, end, type);
+
+	// Assigning the centers to the first index from which they can be used, last_center[i] = largest center usable from i plus one, 0 if none
+	size_t *last_center_ptr = new size_t[interval_len];
+	std::memset(last_center_ptr, 0, interval_len * sizeof(size_t));
+
+	for (size_t c = (start << 1); c <= (end << 1); ++c){
+		size_t arm = arm_ptr[c - (start << 1)];
+		if (!arm && ((c & 1) || (1 == type))){ continue; }	// no kmer with this center, a single base is a mirror but not a palindrome
+		size_t first = (c >> 1) + 1 - arm - !(c & 1);	// first index of the longest kmer with center c, (c / 2 - arm) if even, (c / 2 + 1 - arm) if odd
+		if (k_max && ((c - (first << 1) + 1) > k_max)){	// kmer longer than max_k, the center is used from (c - k_max + 1) / 2 (rounded up)
+			first = (c - k_max + 2) >> 1;
+		}
+		if ((c + 1) > last_center_ptr[first - start]){ last_center_ptr[first - start] = c + 1; }
+	}
+	delete[] arm_ptr;
+
+	// Sliding by one base at each iteration and keeping the largest center usable
+	size_t max_center = 0;	// largest center usable plus one, 0 if none
+	nessie_progress.begin_pass(offset, start, end);
+	for (size_t i = start; i <= end; ++i){
+		nessie_progress.update(i);
+		if (last_center_ptr[i - start] > max_center){ max_center = last_center_ptr[i - start]; }
+		if (max_center < ((i << 1) + 1)){ continue; }	// no center to the right of i can be used
+
+		size_t k = max_center - (i << 1);
+		size_t end_i = i + k - 1;
+		if ((1 == type) && (1 == k)){ continue; }	// a single base is not a palindrome
+		if ((k >= k_min) && (!added || (end_i > added_end))){	//++check;
+			added_end = end_i;
+			added = true;
+
+			// Defining bytes necessary to store the kmer k
+			size_t dna_bytes_k = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
+
+			// Defining the mask to encode the kmer k
+			uint8_t mask_kmer_k[dna_bytes_k];
+			uint8_t *mask_kmer_k_ptr = mask_kmer_k;
+			std::memset(mask_kmer_k, 0, dna_bytes_k);
+
+			// Initializing mask for the kmer of length k at index i
+			Nessie::routine_init_mask(mask_kmer_k_ptr, k, i);
+
+			sink.add_hit(i, k, mask_kmer_k_ptr, dna_bytes_k, NULL);
+		}
+	}
+
+	delete[] last_center_ptr;
+	//std::cout << "CHECK " << check << std::endl;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	build_lce_index -- builds the index used to check mirrors, palindromes and triplexes with mismatches by longest common extensions (LCE)
+//
+//	note: the DNA string and its reverse are packed 32 bases per uint64_t (4 bits per base in total),
+//		  the reverse complement is not stored since it is the reverse with every bit flipped.
+//		  Once built, the index is used by the MAX searches of mirrors, palindromes and triplexes with mismatches (routine_scan_max_kmer_lce, routine_scan_max_kmer_triplex_seed),
+//		  a kmer with up to max_mm mismatches is checked with max_mm + 1 extensions that compare 32 pairs of bases at a time
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::build_lce_index(){
+
+	if (!string_bit_ptr->data_ptr){ throw std::invalid_argument("Build LCE index: the DNA string is not stored"); }
+	if (lce_forward_ptr){ return; }	// already built
+
+	// Variables
+	uint8_t *data_ptr = string_bit_ptr->data_ptr;
+	size_t dna_len = string_bit_ptr->data_len;
+	size_t words = (dna_len >> 5) + 3;	// words are read two at a time, up to 31 bases after the end of the string
+
+	lce_forward_ptr = new uint64_t[words]();
+	lce_reverse_ptr = new uint64_t[words]();
+
+	for (size_t i = 0; i < dna_len; ++i){
+		uint8_t shift_DNA = (i & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
+		uint64_t base = (data_ptr[i >> 2] >> shift_DNA) & BASE_MASK;
+		size_t j = dna_len - 1 - i;	// index of the base in the reversed string
+		lce_forward_ptr[i >> 5] |= base << ((i & 31) << 1);
+		lce_reverse_ptr[j >> 5] |= base << ((j & 31) << 1);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_get_lce_word -- returns the 32 bases starting at index i of a packed string as uint64_t
+//
+//	parameters:
+//		words_ptr - ptr to the packed string (lce_forward_ptr or lce_reverse_ptr)
+//		i - index of the first base
+//
+/////////////////////////////////////////////////////////////////////////////////////
+uint64_t Nessie::routine_get_lce_word(uint64_t *words_ptr, size_t i){
+
+	size_t shift = (i & 31) << 1;
+
+	if (!shift){
+		return words_ptr[i >> 5];
+	}
+
+	return (words_ptr[i >> 5] >> shift) | (words_ptr[(i >> 5) + 1] << (64 - shift));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_lce -- returns the number of consecutive matching pairs (forward + t, backward - t) for t in [0..limit)
+//
+//	parameters:
+//		forward - index of the base that is extended forward
+//		backward - index of the base that is extended backward
+//		limit - max number of pairs compared
+//		type - symmetry checked: 0 = mirror, 1 = palindrome
+//
+//	note: bases going backward are read forward on the reversed string, for palindromes the bits are flipped (complement)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+size_t Nessie::routine_lce(size_t forward, size_t backward, size_t limit, int type){
+
+	// Variables
+	uint64_t match = (1 == type) ? ~((uint64_t) 0) : 0;	// xor of 32 matching pairs
+	size_t reverse = string_bit_ptr->data_len - 1 - backward;	// index of backward in the reversed string
+	size_t lce = 0;
+
+	while (lce < limit){
+		uint64_t diff = routine_get_lce_word(lce_forward_ptr, forward + lce) ^ routine_get_lce_word(lce_reverse_ptr, reverse + lce) ^ match;
+		if (diff){
+			lce += BitBoard::lsb64_intrinsic(diff) >> 1;	// first mismatching pair
+			break;
+		}
+		lce += 32;
+	}
+
+	return (lce < limit) ? lce : limit;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_check_symmetry_lce -- check the kmer (i, k) for the symmetry using the LCE index
 //
 //	parameters:
-//		monomer_bitarray_ptr - ptr to a *BIT_ARRAY[4]
-//		mask_kmer_ptr - ptr to a uint8_t array that encodes a kmer
-//		mask_kmer_len - length of the uint8_t array that encodes the kmer
-//		k - length of the kmer searched
-//		i - index from the loop step
+//		i - starting index of the kmer
+//		k - length of the kmer
+//		max_mm - max number of mismatch allowed
+//		type - symmetry checked: 0 = mirror, 1 = palindrome
 //
-//	note:
+//	note: same result of routine_check_mirror_symmetry_interval and routine_check_palindrome_symmetry_interval,
+//		  the outer pair must match and up to max_mm mismatches are allowed in the inner pairs
 //
 /////////////////////////////////////////////////////////////////////////////////////
-void Nessie::routine_shift_bitarray_and_mask(BIT_ARRAY **monomer_bitarray_ptr, uint8_t *mask_kmer_ptr, size_t mask_kmer_len, size_t k, size_t i){
+bool Nessie::routine_check_symmetry_lce(size_t i, size_t k, size_t max_mm, int type){
+
+	if (!lce_forward_ptr){ throw std::invalid_argument("Symmetry LCE: the LCE index is not built"); }
 
 	// Variables
-	size_t last_index = k - 1;
-	uint8_t shift_mask = (last_index & ((1 << 2) - 1)) << 1;
+	size_t h = k >> 1;	// number of pairs in the kmer
+	size_t mm_c = 0;
 
-	// Shift
-	uint8_t shift_DNA = ((i + last_index) & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
-	uint8_t base = (string_bit_ptr->data_ptr[(i + last_index) >> 2] & (BASE_MASK << shift_DNA)) >> shift_DNA;	// retrieving the ENCODING
-	shift_2_right(mask_kmer_ptr, mask_kmer_len);	// shift the uint8_t array encoding the kmer (removes the first base)
-	mask_kmer_ptr[last_index >> 2] |= base << shift_mask;	// adding the new base to mask_kmer
-	for(size_t i = 0; i < 4; ++i){	//shift monomer_bitarray by one
-		if (i == base) {
-			bit_array_shift_right(monomer_bitarray_ptr[i], 1, 1);	// set bit in the monomer_bitarray corresponding to the new base index
-		}
-		else{
-			bit_array_shift_right(monomer_bitarray_ptr[i], 1, 0);
+	// Single base, it is compared with itself
+	if (!h){
+		return (0 == type);
+	}
+
+	// Outer pair must match
+	NESSIE_STATS_ADD(windows, 1);
+	if (!Nessie::routine_lce(i, i + k - 1, 1, type)){
+		NESSIE_STATS_ADD(quick_rejects, 1);
+		return false;
+	}
+
+	// Jumping from a mismatch to the next one in the inner pairs
+	size_t t = 1;
+	while (t < h){
+		t += Nessie::routine_lce(i + t, i + k - 1 - t, h - t, type);
+		if (t < h){
+			if (++mm_c > max_mm){
+				return false;
+			}
+			++t;
 		}
 	}
+
+	return true;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
 //
-//	routine_shift_mask -- shifts the mask by one base
+//	routine_scan_max_kmer_lce -- delivers to sink the hits (longest kmers of maximum length max_k and minimum length min_k with a specific symmetry in the interval),
+//								 the kmers are checked using the LCE index
 //
 //	parameters:
-//		mask_kmer_ptr - ptr to a uint8_t array that encodes a kmer
-//		mask_kmer_len - length of the uint8_t array that encodes the kmer
-//		k - length of the kmer searched
-//		i - index from the loop step
+//		max_k - max length of the kmers searched
+//		min_k - min length of the kmers searched
+//		modulo - max mismatch allowed are calculated as integer division k / modulo
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		type - symmetry checked: 0 = mirror, 1 = palindrome
+//		sink - HitSink that receives the hits
 //
-//	note:
+//	note: the hits are the same of routine_scan_max_kmer_mirror and routine_scan_max_kmer_palindrome,
+//		  each kmer is checked in max_mm + 1 extensions instead of comparing all its pairs
 //
 /////////////////////////////////////////////////////////////////////////////////////
-void Nessie::routine_shift_mask(uint8_t *mask_kmer_ptr, size_t mask_kmer_len, size_t k, size_t i){
+void Nessie::routine_scan_max_kmer_lce(size_t k_max, size_t k_min, size_t modulo, size_t start, size_t end, int type, HitSink &sink){	//size_t check = 0;
+
+	// Some variables
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get max LCE: max_k is longer than the sequence interval"); }
+	if (!k_min){ throw std::invalid_argument("Get max LCE: min_k must be larger than 0"); }
+	if (type < 0 || type > 1){ throw std::invalid_argument("Get max LCE: type is not valid"); }
 
 	// Variables
-	size_t last_index = k - 1;
-	uint8_t shift_mask = (last_index & ((1 << 2) - 1)) << 1;
+	size_t added_end = 0;
+	bool added = false;
 
-	// Shift
-	uint8_t shift_DNA = ((i + last_index) & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
-	uint8_t base = (string_bit_ptr->data_ptr[(i + last_index) >> 2] & (BASE_MASK << shift_DNA)) >> shift_DNA;	// retrieving the ENCODING
-	shift_2_right(mask_kmer_ptr, mask_kmer_len);	// shift the uint8_t array encoding the kmer (removes the first base)
-	mask_kmer_ptr[last_index >> 2] |= base << shift_mask;	// adding the new base to mask_kmer
+	nessie_progress.begin_pass(offset, start, end);
+	for (size_t i = start; i <= (end - k_min + 1); ++i){
+		nessie_progress.update(i);
+		size_t k = (k_max < (end - i + 1)) ? k_max : (end - i + 1);	// kmers at the end of the interval are shorter than max_k
+		size_t end_i = i + k - 1;
+		while ((k >= k_min) && (!added || (end_i > added_end))){
+			size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
+			if (Nessie::routine_check_symmetry_lce(i, k, max_mm, type)){	//++check;
+				added_end = end_i;
+				added = true;
+
+				// Defining bytes necessary to store the kmer k
+				size_t dna_bytes_k = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
+
+				// Defining the mask to encode the kmer k
+				uint8_t mask_kmer_k[dna_bytes_k];
+				uint8_t *mask_kmer_k_ptr = mask_kmer_k;
+				std::memset(mask_kmer_k, 0, dna_bytes_k);
+
+				// Initializing mask for the kmer of length k at index i
+				Nessie::routine_init_mask(mask_kmer_k_ptr, k, i);
+
+				sink.add_hit(i, k, mask_kmer_k_ptr, dna_bytes_k, NULL);
+				break;
+			}
+		--k;
+		--end_i;
+		}
+	}
+
+	//std::cout << "CHECK " << check << std::endl;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -2181,18 +3046,13 @@ LinkedlistKmer *Nessie::get_kmers_mirror(size_t k_min, size_t k_max, size_t modu
 	// Initializing LinkedlistKmer
 	LinkedlistKmer *ll_kmer_ptr = new LinkedlistKmer;
 
-	// Check range k_min..k_max
-	for (size_t i = k_min; i <= k_max; ++i){
-		size_t max_mm;
-		if (!modulo){
-			max_mm = 0;
-		}
-		else{
-			max_mm = (i * modulo) / 100;
-		}
-		HashTable *hash_table_ptr = Nessie::routine_get_kmers_k_mirror(i, max_mm, start, end);
-		hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
-	}
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	HashTableSink sink(true);
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, 0, 0, 0, start, end, 0, sink);
+
+	// Add to LinkedlistKmer
+	HashTable *hash_table_ptr = sink.release_hash_table_ptr();
+	hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
 
 	return ll_kmer_ptr;
 }
@@ -2223,25 +3083,14 @@ LinkedlistKmer *Nessie::get_kmers_mirror_gap(size_t k_min, size_t k_max, size_t
 
 	// Initializing LinkedlistKmer
 	LinkedlistKmer *ll_kmer_ptr = new LinkedlistKmer;
-	HashTable *hash_table_ptr;
 
-	// Check range k_min..k_max
-	for (size_t i = k_min; i <= k_max; ++i){
-		size_t max_mm = (modulo) ? (i * modulo) / 100 : 0;
-		size_t max_gap = (modulo_gap) ? (i * modulo_gap) / 100 : 0;
-		size_t max_gapmm = (modulo_gapmm) ? (i * modulo_gapmm) / 100 : 0;
-
-		// Check if gaps allowed or not
-		if (max_gap || max_gapmm){
-			hash_table_ptr = Nessie::routine_get_kmers_k_gap(i, max_mm, max_gap, max_gapmm, start, end, 0);
-		}
-		else{
-			hash_table_ptr = Nessie::routine_get_kmers_k_mirror(i, max_mm, start, end);
-		}
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	HashTableSink sink(true);
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, modulo_gap, modulo_gapmm, 0, start, end, 0, sink);
 
-		// Add to LinkedlistKmer
-		hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
-	}
+	// Add to LinkedlistKmer
+	HashTable *hash_table_ptr = sink.release_hash_table_ptr();
+	hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
 
 	return ll_kmer_ptr;
 }
@@ -2252,7 +3101,7 @@ LinkedlistKmer *Nessie::get_kmers_mirror_gap(size_t k_min, size_t k_max, size_t
 //								allows for gaps
 //
 //	parameters:
-//		max_k - max length of the kmers searched
+//		max_k - max length of the kmers searched, if 0 the length is not limited (only if mismatches and gaps are not allowed)
 //		min_k - min length of the kmers searched [0]
 //		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
 //		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
@@ -2266,8 +3115,10 @@ LinkedlistKmer *Nessie::get_max_kmers_mirror_gap(size_t k_max, size_t k_min, siz
 
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
 	if (start > end){ throw std::invalid_argument("Get max mirrors: starting index is larger than ending index"); }
+	if (!k_max && (modulo || modulo_gap || modulo_gapmm)){ throw std::invalid_argument("Get max mirrors: max_k is needed if mismatches or gaps are allowed"); }
 	if (!k_min){ k_min = k_max; }	// if min_k is not defined it is set to default as max_k, only kmers of length max_k are searched
-	if (k_min > k_max){ throw std::invalid_argument("Get max mirrors: min_k is larger than max_k"); }
+	if (!k_min){ throw std::invalid_argument("Get max mirrors: min_k or max_k must be defined"); }
+	if (k_max && (k_min > k_max)){ throw std::invalid_argument("Get max mirrors: min_k is larger than max_k"); }
 	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get max mirrors: max_k is longer than the sequence interval"); }
 
 	// Initializing LinkedlistKmer
@@ -2313,18 +3164,13 @@ LinkedlistKmer *Nessie::get_kmers_palindrome(size_t k_min, size_t k_max, size_t
 	// Initializing LinkedlistKmer
 	LinkedlistKmer *ll_kmer_ptr = new LinkedlistKmer;
 
-	// Check range k_min..k_max
-	for (size_t i = k_min; i <= k_max; ++i){
-		size_t max_mm;
-		if (!modulo){
-			max_mm = 0;
-		}
-		else{
-			max_mm = (i * modulo) / 100;
-		}
-		HashTable *hash_table_ptr = Nessie::routine_get_kmers_k_palindrome(i, max_mm, start, end);
-		hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
-	}
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	HashTableSink sink(true);
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, 0, 0, 0, start, end, 1, sink);
+
+	// Add to LinkedlistKmer
+	HashTable *hash_table_ptr = sink.release_hash_table_ptr();
+	hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
 
 	return ll_kmer_ptr;
 }
@@ -2353,71 +3199,252 @@ LinkedlistKmer *Nessie::get_kmers_palindrome_gap(size_t k_min, size_t k_max, siz
 	if (k_min > k_max){ throw std::invalid_argument("Get palindromes: k_min is larger than k_max"); }
 	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get palindromes: k_max is longer than the sequence interval"); }
 
+	// Initializing LinkedlistKmer
+	LinkedlistKmer *ll_kmer_ptr = new LinkedlistKmer;
+
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	HashTableSink sink(true);
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, modulo_gap, modulo_gapmm, 0, start, end, 1, sink);
+
+	// Add to LinkedlistKmer
+	HashTable *hash_table_ptr = sink.release_hash_table_ptr();
+	hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
+
+	return ll_kmer_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_max_kmers_palindrome_gap -- returns a ptr to a LinkedlistKmer that stores all the maximum Kmers with palindrome symmetry (maximum length max_k and minimum length min_k) in the interval,
+//									allows for gaps
+//
+//	parameters:
+//		max_k - max length of the kmers searched, if 0 the length is not limited (only if mismatches and gaps are not allowed)
+//		min_k - min length of the kmers searched [0]
+//		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+//	note:
+//
+/////////////////////////////////////////////////////////////////////////////////////
+LinkedlistKmer *Nessie::get_max_kmers_palindrome_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Get max palindromes: starting index is larger than ending index"); }
+	if (!k_max && (modulo || modulo_gap || modulo_gapmm)){ throw std::invalid_argument("Get max palindromes: max_k is needed if mismatches or gaps are allowed"); }
+	if (!k_min){ k_min = k_max; }	// if min_k is not defined it is set to default as max_k, only kmers of length max_k are searched
+	if (!k_min){ throw std::invalid_argument("Get max palindromes: min_k or max_k must be defined"); }
+	if (k_max && (k_min > k_max)){ throw std::invalid_argument("Get max palindromes: min_k is larger than max_k"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get max palindromes: max_k is longer than the sequence interval"); }
+
 	// Initializing LinkedlistKmer
 	LinkedlistKmer *ll_kmer_ptr = new LinkedlistKmer;
 	HashTable *hash_table_ptr;
 
-	// Check range k_min..k_max
-	for (size_t i = k_min; i <= k_max; ++i){
-		size_t max_mm = (modulo) ? (i * modulo) / 100 : 0;
-		size_t max_gap = (modulo_gap) ? (i * modulo_gap) / 100 : 0;
-		size_t max_gapmm = (modulo_gapmm) ? (i * modulo_gapmm) / 100 : 0;
+	// Check if gaps allowed or not
+	if (modulo_gap || modulo_gapmm){
+		hash_table_ptr = Nessie::routine_get_max_kmer_gap(k_max, k_min, modulo, modulo_gap, modulo_gapmm, start, end, 1);
+	}
+	else{
+		hash_table_ptr = Nessie::routine_get_max_kmer_palindrome(k_max, k_min, modulo, start, end);
+	}
 
-		// Check if gaps allowed or not
-		if (max_gap || max_gapmm){
-			hash_table_ptr = Nessie::routine_get_kmers_k_gap(i, max_mm, max_gap, max_gapmm, start, end, 1);
-		}
-		else{
-			hash_table_ptr = Nessie::routine_get_kmers_k_palindrome(i, max_mm, start, end);
-		}
+	// Add to LinkedlistKmer
+	hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
+
+	return ll_kmer_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	scan_kmers_mirror_gap -- delivers to sink all the Kmers with mirror symmetry of length [k_min..k_max] in the interval as they are found,
+//							  allows for gaps
+//
+//	parameters:
+//		sink - HitSink that receives the hits
+//		k_min - minimum length of the kmers searched
+//		k_max - maximum length of the kmers searched [0]
+//		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+//	note: hits are not aggregated, the same kmer is delivered once for every index it is found at,
+//		  the interval is scanned only once for all the lengths
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::scan_kmers_mirror_gap(HitSink &sink, size_t k_min, size_t k_max, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Scan mirrors gap: starting index is larger than ending index"); }
+	if (!k_max){ k_max = k_min; }	// if k_max is not defined it is set to default as k_min, only kmers of length k_min are searched
+	if (k_min > k_max){ throw std::invalid_argument("Scan mirrors gap: k_min is larger than k_max"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Scan mirrors gap: k_max is longer than the sequence interval"); }
+
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, modulo_gap, modulo_gapmm, 0, start, end, 0, sink);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	scan_max_kmers_mirror_gap -- delivers to sink all the maximum Kmers with mirror symmetry (maximum length max_k and minimum length min_k) in the interval as they are found,
+//								  allows for gaps
+//
+//	parameters:
+//		sink - HitSink that receives the hits
+//		max_k - max length of the kmers searched, if 0 the length is not limited (only if mismatches and gaps are not allowed)
+//		min_k - min length of the kmers searched [0]
+//		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+//	note: hits are delivered in ascending order of index
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::scan_max_kmers_mirror_gap(HitSink &sink, size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Scan max mirrors gap: starting index is larger than ending index"); }
+	if (!k_max && (modulo || modulo_gap || modulo_gapmm)){ throw std::invalid_argument("Scan max mirrors gap: max_k is needed if mismatches or gaps are allowed"); }
+	if (!k_min){ k_min = k_max; }	// if min_k is not defined it is set to default as max_k, only kmers of length max_k are searched
+	if (!k_min){ throw std::invalid_argument("Scan max mirrors gap: min_k or max_k must be defined"); }
+	if (k_max && (k_min > k_max)){ throw std::invalid_argument("Scan max mirrors gap: min_k is larger than max_k"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Scan max mirrors gap: max_k is longer than the sequence interval"); }
+
+	// Check if gaps allowed or not
+	if (modulo_gap || modulo_gapmm){
+		Nessie::routine_scan_max_kmer_gap(k_max, k_min, modulo, modulo_gap, modulo_gapmm, start, end, 0, sink);
+	}
+	else{
+		Nessie::routine_scan_max_kmer_mirror(k_max, k_min, modulo, start, end, sink);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	scan_kmers_palindrome_gap -- delivers to sink all the Kmers with palindrome symmetry of length [k_min..k_max] in the interval as they are found,
+//							  allows for gaps
+//
+//	parameters:
+//		sink - HitSink that receives the hits
+//		k_min - minimum length of the kmers searched
+//		k_max - maximum length of the kmers searched [0]
+//		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+//	note: hits are not aggregated, the same kmer is delivered once for every index it is found at,
+//		  the interval is scanned only once for all the lengths
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::scan_kmers_palindrome_gap(HitSink &sink, size_t k_min, size_t k_max, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Scan palindromes gap: starting index is larger than ending index"); }
+	if (!k_max){ k_max = k_min; }	// if k_max is not defined it is set to default as k_min, only kmers of length k_min are searched
+	if (k_min > k_max){ throw std::invalid_argument("Scan palindromes gap: k_min is larger than k_max"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Scan palindromes gap: k_max is longer than the sequence interval"); }
+
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, modulo_gap, modulo_gapmm, 0, start, end, 1, sink);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	scan_max_kmers_palindrome_gap -- delivers to sink all the maximum Kmers with palindrome symmetry (maximum length max_k and minimum length min_k) in the interval as they are found,
+//								  allows for gaps
+//
+//	parameters:
+//		sink - HitSink that receives the hits
+//		max_k - max length of the kmers searched, if 0 the length is not limited (only if mismatches and gaps are not allowed)
+//		min_k - min length of the kmers searched [0]
+//		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+//	note: hits are delivered in ascending order of index
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::scan_max_kmers_palindrome_gap(HitSink &sink, size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Scan max palindromes gap: starting index is larger than ending index"); }
+	if (!k_max && (modulo || modulo_gap || modulo_gapmm)){ throw std::invalid_argument("Scan max palindromes gap: max_k is needed if mismatches or gaps are allowed"); }
+	if (!k_min){ k_min = k_max; }	// if min_k is not defined it is set to default as max_k, only kmers of length max_k are searched
+	if (!k_min){ throw std::invalid_argument("Scan max palindromes gap: min_k or max_k must be defined"); }
+	if (k_max && (k_min > k_max)){ throw std::invalid_argument("Scan max palindromes gap: min_k is larger than max_k"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Scan max palindromes gap: max_k is longer than the sequence interval"); }
+
+	// Check if gaps allowed or not
+	if (modulo_gap || modulo_gapmm){
+		Nessie::routine_scan_max_kmer_gap(k_max, k_min, modulo, modulo_gap, modulo_gapmm, start, end, 1, sink);
+	}
+	else{
+		Nessie::routine_scan_max_kmer_palindrome(k_max, k_min, modulo, start, end, sink);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	scan_sorted_kmers_mirror_gap -- delivers to sink all the Kmers with mirror symmetry of length [k_min..k_max] in the interval in ascending order of index,
+//									 allows for gaps
+//
+//	parameters:
+//		sink - HitSink that receives the hits
+//		k_min - minimum length of the kmers searched
+//		k_max - maximum length of the kmers searched [0]
+//		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+//	note: same hits and order of scan_kmers_mirror_gap, the order is part of the contract of this function,
+//		  hits for the same index are delivered in ascending order of length
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::scan_sorted_kmers_mirror_gap(HitSink &sink, size_t k_min, size_t k_max, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end){
 
-		// Add to LinkedlistKmer
-		hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
-	}
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Scan sorted mirrors gap: starting index is larger than ending index"); }
+	if (!k_max){ k_max = k_min; }	// if k_max is not defined it is set to default as k_min, only kmers of length k_min are searched
+	if (k_min > k_max){ throw std::invalid_argument("Scan sorted mirrors gap: k_min is larger than k_max"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Scan sorted mirrors gap: k_max is longer than the sequence interval"); }
 
-	return ll_kmer_ptr;
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, modulo_gap, modulo_gapmm, 0, start, end, 0, sink);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
 //
-//	get_max_kmers_palindrome_gap -- returns a ptr to a LinkedlistKmer that stores all the maximum Kmers with palindrome symmetry (maximum length max_k and minimum length min_k) in the interval,
-//									allows for gaps
+//	scan_sorted_kmers_palindrome_gap -- delivers to sink all the Kmers with palindrome symmetry of length [k_min..k_max] in the interval in ascending order of index,
+//									 allows for gaps
 //
 //	parameters:
-//		max_k - max length of the kmers searched
-//		min_k - min length of the kmers searched [0]
+//		sink - HitSink that receives the hits
+//		k_min - minimum length of the kmers searched
+//		k_max - maximum length of the kmers searched [0]
 //		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
 //		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
 //		start - starting index of the interval to search [0]
 //		end - ending index of the interval to search [0]
 //
-//	note:
+//	note: same hits and order of scan_kmers_palindrome_gap, the order is part of the contract of this function,
+//		  hits for the same index are delivered in ascending order of length
 //
 /////////////////////////////////////////////////////////////////////////////////////
-LinkedlistKmer *Nessie::get_max_kmers_palindrome_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end){
+void Nessie::scan_sorted_kmers_palindrome_gap(HitSink &sink, size_t k_min, size_t k_max, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end){
 
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
-	if (start > end){ throw std::invalid_argument("Get max palindromes: starting index is larger than ending index"); }
-	if (!k_min){ k_min = k_max; }	// if min_k is not defined it is set to default as max_k, only kmers of length max_k are searched
-	if (k_min > k_max){ throw std::invalid_argument("Get max palindromes: min_k is larger than max_k"); }
-	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get max palindromes: max_k is longer than the sequence interval"); }
-
-	// Initializing LinkedlistKmer
-	LinkedlistKmer *ll_kmer_ptr = new LinkedlistKmer;
-	HashTable *hash_table_ptr;
-
-	// Check if gaps allowed or not
-	if (modulo_gap || modulo_gapmm){
-		hash_table_ptr = Nessie::routine_get_max_kmer_gap(k_max, k_min, modulo, modulo_gap, modulo_gapmm, start, end, 1);
-	}
-	else{
-		hash_table_ptr = Nessie::routine_get_max_kmer_palindrome(k_max, k_min, modulo, start, end);
-	}
-
-	// Add to LinkedlistKmer
-	hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
+	if (start > end){ throw std::invalid_argument("Scan sorted palindromes gap: starting index is larger than ending index"); }
+	if (!k_max){ k_max = k_min; }	// if k_max is not defined it is set to default as k_min, only kmers of length k_min are searched
+	if (k_min > k_max){ throw std::invalid_argument("Scan sorted palindromes gap: k_min is larger than k_max"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Scan sorted palindromes gap: k_max is longer than the sequence interval"); }
 
-	return ll_kmer_ptr;
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, modulo_gap, modulo_gapmm, 0, start, end, 1, sink);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -2447,23 +3474,16 @@ void Nessie::print_kmers_mirror(size_t k_min, size_t k_max, size_t modulo, size_
 	if (k_min > k_max){ throw std::invalid_argument("Print mirrors: k_min is larger than k_max"); }
 	if (k_max > (end - start + 1)){ throw std::invalid_argument("Print mirrors: k_max is longer than the sequence interval"); }
 
-	// Check range k_min..k_max
-	for (size_t i = k_min; i <= k_max; ++i){
-		size_t max_mm;
-		if (!modulo){
-			max_mm = 0;
-		}
-		else{
-			max_mm = (i * modulo) / 100;
-		}
-		HashTable *hash_table_ptr = Nessie::routine_get_kmers_k_mirror(i, max_mm, start, end);
-		if (!start_idx){
-			hash_table_ptr->print_table(fout, counts, indexes);
-		}
-		else{
-			hash_table_ptr->print_table_shifted_indexes(start_idx, fout, counts, indexes);
-		}
-		delete hash_table_ptr;
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	HashTableSink sink(true);
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, 0, 0, 0, start, end, 0, sink);
+
+	// Printing
+	if (!start_idx){
+		sink.get_hash_table_ptr()->print_table(fout, counts, indexes);
+	}
+	else{
+		sink.get_hash_table_ptr()->print_table_shifted_indexes(start_idx, fout, counts, indexes);
 	}
 }
 
@@ -2495,31 +3515,16 @@ void Nessie::print_kmers_mirror_gap(size_t k_min, size_t k_max, size_t modulo, s
 	if (k_min > k_max){ throw std::invalid_argument("Print mirrors gap: k_min is larger than k_max"); }
 	if (k_max > (end - start + 1)){ throw std::invalid_argument("Print mirrors gap: k_max is longer than the sequence interval"); }
 
-	// Variables
-	HashTable *hash_table_ptr;
-
-	// Check range k_min..k_max
-	for (size_t i = k_min; i <= k_max; ++i){
-		size_t max_mm = (modulo) ? (i * modulo) / 100 : 0;
-		size_t max_gap = (modulo_gap) ? (i * modulo_gap) / 100 : 0;
-		size_t max_gapmm = (modulo_gapmm) ? (i * modulo_gapmm) / 100 : 0;
-
-		// Check if gaps allowed or not
-		if (max_gap || max_gapmm){
-			hash_table_ptr = Nessie::routine_get_kmers_k_gap(i, max_mm, max_gap, max_gapmm, start, end, 0);
-		}
-		else{
-			hash_table_ptr = Nessie::routine_get_kmers_k_mirror(i, max_mm, start, end);
-		}
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	HashTableSink sink(true);
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, modulo_gap, modulo_gapmm, 0, start, end, 0, sink);
 
-		// Printing
-		if (!start_idx){
-			hash_table_ptr->print_table(fout, counts, indexes);
-		}
-		else{
-			hash_table_ptr->print_table_shifted_indexes(start_idx, fout, counts, indexes);
-		}
-		delete hash_table_ptr;	// need to delete the HashTable at each iteration otherwise too much memory is used
+	// Printing
+	if (!start_idx){
+		sink.get_hash_table_ptr()->print_table(fout, counts, indexes);
+	}
+	else{
+		sink.get_hash_table_ptr()->print_table_shifted_indexes(start_idx, fout, counts, indexes);
 	}
 }
 
@@ -2529,7 +3534,7 @@ void Nessie::print_kmers_mirror_gap(size_t k_min, size_t k_max, size_t modulo, s
 //								  allows for gaps
 //
 //	parameters:
-//		max_k - max length of the kmers searched
+//		max_k - max length of the kmers searched, if 0 the length is not limited (only if mismatches and gaps are not allowed)
 //		min_k - min length of the kmers searched [0]
 //		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
 //		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
@@ -2547,8 +3552,10 @@ void Nessie::print_max_kmers_mirror_gap(size_t k_max, size_t k_min, size_t modul
 
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
 	if (start > end){ throw std::invalid_argument("Print max mirrors gap: starting index is larger than ending index"); }
+	if (!k_max && (modulo || modulo_gap || modulo_gapmm)){ throw std::invalid_argument("Print max mirrors gap: max_k is needed if mismatches or gaps are allowed"); }
 	if (!k_min){ k_min = k_max; }	// if min_k is not defined it is set to default as max_k, only kmers of length max_k are searched
-	if (k_min > k_max){ throw std::invalid_argument("Print max mirrors gap: min_k is larger than max_k"); }
+	if (!k_min){ throw std::invalid_argument("Print max mirrors gap: min_k or max_k must be defined"); }
+	if (k_max && (k_min > k_max)){ throw std::invalid_argument("Print max mirrors gap: min_k is larger than max_k"); }
 	if (k_max > (end - start + 1)){ throw std::invalid_argument("Print max mirrors gap: max_k is longer than the sequence interval"); }
 
 	// Variables
@@ -2598,23 +3605,16 @@ void Nessie::print_kmers_palindrome(size_t k_min, size_t k_max, size_t modulo, s
 	if (k_min > k_max){ throw std::invalid_argument("Print palindromes: k_min is larger than k_max"); }
 	if (k_max > (end - start + 1)){ throw std::invalid_argument("Print palindromes: k_max is longer than the sequence interval"); }
 
-	// Check range k_min..k_max
-	for (size_t i = k_min; i <= k_max; ++i){
-		size_t max_mm;
-		if (!modulo){
-			max_mm = 0;
-		}
-		else{
-			max_mm = (i * modulo) / 100;
-		}
-		HashTable *hash_table_ptr = Nessie::routine_get_kmers_k_palindrome(i, max_mm, start, end);
-		if (!start_idx){
-			hash_table_ptr->print_table(fout, counts, indexes);
-		}
-		else{
-			hash_table_ptr->print_table_shifted_indexes(start_idx, fout, counts, indexes);
-		}
-		delete hash_table_ptr;
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	HashTableSink sink(true);
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, 0, 0, 0, start, end, 1, sink);
+
+	// Printing
+	if (!start_idx){
+		sink.get_hash_table_ptr()->print_table(fout, counts, indexes);
+	}
+	else{
+		sink.get_hash_table_ptr()->print_table_shifted_indexes(start_idx, fout, counts, indexes);
 	}
 }
 
@@ -2646,31 +3646,16 @@ void Nessie::print_kmers_palindrome_gap(size_t k_min, size_t k_max, size_t modul
 	if (k_min > k_max){ throw std::invalid_argument("Print palindromes gap: k_min is larger than k_max"); }
 	if (k_max > (end - start + 1)){ throw std::invalid_argument("Print palindromes gap: k_max is longer than the sequence interval"); }
 
-	// Variables
-	HashTable *hash_table_ptr;
-
-	// Check range k_min..k_max
-	for (size_t i = k_min; i <= k_max; ++i){
-		size_t max_mm = (modulo) ? (i * modulo) / 100 : 0;
-		size_t max_gap = (modulo_gap) ? (i * modulo_gap) / 100 : 0;
-		size_t max_gapmm = (modulo_gapmm) ? (i * modulo_gapmm) / 100 : 0;
-
-		// Check if gaps allowed or not
-		if (max_gap || max_gapmm){
-			hash_table_ptr = Nessie::routine_get_kmers_k_gap(i, max_mm, max_gap, max_gapmm, start, end, 1);
-		}
-		else{
-			hash_table_ptr = Nessie::routine_get_kmers_k_palindrome(i, max_mm, start, end);
-		}
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	HashTableSink sink(true);
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, modulo_gap, modulo_gapmm, 0, start, end, 1, sink);
 
-		// Printing
-		if (!start_idx){
-			hash_table_ptr->print_table(fout, counts, indexes);
-		}
-		else{
-			hash_table_ptr->print_table_shifted_indexes(start_idx, fout, counts, indexes);
-		}
-		delete hash_table_ptr;	// need to delete the HashTable at each iteration otherwise too much memory is used
+	// Printing
+	if (!start_idx){
+		sink.get_hash_table_ptr()->print_table(fout, counts, indexes);
+	}
+	else{
+		sink.get_hash_table_ptr()->print_table_shifted_indexes(start_idx, fout, counts, indexes);
 	}
 }
 
@@ -2680,7 +3665,7 @@ void Nessie::print_kmers_palindrome_gap(size_t k_min, size_t k_max, size_t modul
 //								  allows for gaps
 //
 //	parameters:
-//		max_k - max length of the kmers searched
+//		max_k - max length of the kmers searched, if 0 the length is not limited (only if mismatches and gaps are not allowed)
 //		min_k - min length of the kmers searched [0]
 //		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
 //		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
@@ -2694,105 +3679,257 @@ void Nessie::print_kmers_palindrome_gap(size_t k_min, size_t k_max, size_t modul
 //	note:
 //
 /////////////////////////////////////////////////////////////////////////////////////
-void Nessie::print_max_kmers_palindrome_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end, std::ostream &fout, bool counts, bool indexes, size_t start_idx){
+void Nessie::print_max_kmers_palindrome_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end, std::ostream &fout, bool counts, bool indexes, size_t start_idx){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Print max palindromes gap: starting index is larger than ending index"); }
+	if (!k_max && (modulo || modulo_gap || modulo_gapmm)){ throw std::invalid_argument("Print max palindromes gap: max_k is needed if mismatches or gaps are allowed"); }
+	if (!k_min){ k_min = k_max; }	// if min_k is not defined it is set to default as max_k, only kmers of length max_k are searched
+	if (!k_min){ throw std::invalid_argument("Print max palindromes gap: min_k or max_k must be defined"); }
+	if (k_max && (k_min > k_max)){ throw std::invalid_argument("Print max palindromes gap: min_k is larger than max_k"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Print max palindromes gap: max_k is longer than the sequence interval"); }
+
+	// Variables
+	HashTable *hash_table_ptr;
+
+	// Check if gaps allowed or not
+	if (modulo_gap || modulo_gapmm){
+		hash_table_ptr = Nessie::routine_get_max_kmer_gap(k_max, k_min, modulo, modulo_gap, modulo_gapmm, start, end, 1);
+	}
+	else{
+		hash_table_ptr = Nessie::routine_get_max_kmer_palindrome(k_max, k_min, modulo, start, end);
+	}
+
+	// Printing
+	if (!start_idx){
+		hash_table_ptr->print_table(fout, counts, indexes);
+	}
+	else{
+		hash_table_ptr->print_table_shifted_indexes(start_idx, fout, counts, indexes);
+	}
+	delete hash_table_ptr;	// need to delete the HashTable at each iteration otherwise too much memory is used
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_get_kmers_k -- returns a ptr to an HashTable containing Kmer objects (kmers of length k in the interval)
+//
+//	parameters:
+//		k - length of the kmers searched
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//
+//	note: this function works well with sequences of length up to ten thousands of bp,
+//		  but it becomes inefficient (both in space and time) with strings of hundred thousands of bp
+//
+/////////////////////////////////////////////////////////////////////////////////////
+HashTable *Nessie::routine_get_kmers_k(size_t k, size_t start, size_t end){
+
+	// Collecting hits into an HashTable
+	HashTableSink sink(false);
+	Nessie::routine_scan_kmers_k(k, start, end, sink);
+
+	return sink.release_hash_table_ptr();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_kmers_k -- delivers to sink the hits (kmers of length k in the interval)
+//
+//	parameters:
+//		k - length of the kmers searched
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		sink - HitSink that receives the hits
+//
+//	note: this function works well with sequences of length up to ten thousands of bp,
+//		  but it becomes inefficient (both in space and time) with strings of hundred thousands of bp
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_kmers_k(size_t k, size_t start, size_t end, HitSink &sink){
+
+	// Some variables
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (k > (end - start + 1)){ throw std::invalid_argument("Get kmers k: k is longer than the sequence interval"); }
+
+	// Defining bytes necessary to store the kmer
+	size_t dna_bytes = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
+
+	// Defining the mask to encode the kmer
+	uint8_t mask_kmer[dna_bytes];
+	uint8_t *mask_kmer_ptr = mask_kmer;
+	std::memset(mask_kmer, 0, dna_bytes);
+
+	// Initializing mask for the first kmer of length k in the interval
+	size_t c = 0;	// counter for the mask_kmer creation
+	for (size_t i = start; i < (start + k); ++i){
+		uint8_t shift_DNA = (i & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
+		uint8_t shift_mask = (c & ((1 << 2) - 1)) << 1;	// shift to move from one base to the next one in the kmer_mask (uint8_t array)
+		uint8_t base = (string_bit_ptr->data_ptr[i >> 2] & (BASE_MASK << shift_DNA)) >> shift_DNA;	// retrieving the ENCODING
+		mask_kmer_ptr[c >> 2] |= (base << shift_mask);	// insert base in the mask_kmer
+		++c;
+	}
+
+	// Adding first kmer
+	sink.add_hit(start, k, mask_kmer_ptr, dna_bytes, NULL);
+
+	// Sliding by one base at each iteration to get successive kmers
+	size_t last_index = k - 1;
+	uint8_t shift_mask = (last_index & ((1 << 2) - 1)) << 1;
+	nessie_progress.begin_pass(offset, start, end);
+	for (size_t i = (start + 1); i <= (end - k + 1); ++i){	//std::cout << i << std::endl;
+		nessie_progress.update(i);
+		uint8_t shift_DNA = ((i + last_index) & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
+		uint8_t base = (string_bit_ptr->data_ptr[(i + last_index) >> 2] & (BASE_MASK << shift_DNA)) >> shift_DNA;	// retrieving the ENCODING
+		shift_2_right(mask_kmer_ptr, dna_bytes);	// shift the uint8_t array encoding the kmer (removes the first base)
+		mask_kmer_ptr[last_index >> 2] |= base << shift_mask;	// adding the new base to mask_kmer
+
+		// Adding i-th kmer
+		sink.add_hit(i, k, mask_kmer_ptr, dna_bytes, NULL);
+	}
+
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	print_kmers -- prints all the Kmers of length [k_min..k_max] in the interval
+//
+//	parameters:
+//		k_min - minimum length of the kmers searched
+//		k_max - maximum length of the kmers searched [0]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//		fout - ostream element to be used for printing [cout]
+//		counts - bool value, if true print the counts information for the Kmer [true]
+//		indexes - bool value, if true print the indexes list for the Kmer [true]
+//		start_idx - starting index used to shift all other printed indexes [0]
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::print_kmers(size_t k_min, size_t k_max, size_t start, size_t end, std::ostream &fout, bool counts, bool indexes, size_t start_idx){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Print kmers: starting index is larger than ending index"); }
+	if (!k_max){ k_max = k_min; }	// if k_max is not defined it is set to default as k_min, only kmers of length k_min are searched
+	if (k_min > k_max){ throw std::invalid_argument("Print kmers: k_min is larger than k_max"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Print kmers: k_max is longer than the sequence interval"); }
+
+	// Check range k_min..k_max
+	for (size_t i = k_min; i <= k_max; ++i){
+		HashTable *hash_table_ptr = Nessie::routine_get_kmers_k(i, start, end);
+		if (!start_idx){
+			hash_table_ptr->print_table(fout, counts, indexes);
+		}
+		else{
+			hash_table_ptr->print_table_shifted_indexes(start_idx, fout, counts, indexes);
+		}
+		delete hash_table_ptr;	// need to delete the HashTable at each iteration otherwise too much memory is used
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	scan_kmers -- delivers to sink all the Kmers of length [k_min..k_max] in the interval as they are found
+//
+//	parameters:
+//		sink - HitSink that receives the hits
+//		k_min - minimum length of the kmers searched
+//		k_max - maximum length of the kmers searched [0]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::scan_kmers(HitSink &sink, size_t k_min, size_t k_max, size_t start, size_t end){
 
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
-	if (start > end){ throw std::invalid_argument("Print max palindromes gap: starting index is larger than ending index"); }
-	if (!k_min){ k_min = k_max; }	// if min_k is not defined it is set to default as max_k, only kmers of length max_k are searched
-	if (k_min > k_max){ throw std::invalid_argument("Print max palindromes gap: min_k is larger than max_k"); }
-	if (k_max > (end - start + 1)){ throw std::invalid_argument("Print max palindromes gap: max_k is longer than the sequence interval"); }
-
-	// Variables
-	HashTable *hash_table_ptr;
+	if (start > end){ throw std::invalid_argument("Scan kmers: starting index is larger than ending index"); }
+	if (!k_max){ k_max = k_min; }	// if k_max is not defined it is set to default as k_min, only kmers of length k_min are searched
+	if (k_min > k_max){ throw std::invalid_argument("Scan kmers: k_min is larger than k_max"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Scan kmers: k_max is longer than the sequence interval"); }
 
-	// Check if gaps allowed or not
-	if (modulo_gap || modulo_gapmm){
-		hash_table_ptr = Nessie::routine_get_max_kmer_gap(k_max, k_min, modulo, modulo_gap, modulo_gapmm, start, end, 1);
-	}
-	else{
-		hash_table_ptr = Nessie::routine_get_max_kmer_palindrome(k_max, k_min, modulo, start, end);
+	// Check range k_min..k_max
+	for (size_t i = k_min; i <= k_max; ++i){
+		Nessie::routine_scan_kmers_k(i, start, end, sink);
 	}
+}
 
-	// Printing
-	if (!start_idx){
-		hash_table_ptr->print_table(fout, counts, indexes);
-	}
-	else{
-		hash_table_ptr->print_table_shifted_indexes(start_idx, fout, counts, indexes);
-	}
-	delete hash_table_ptr;	// need to delete the HashTable at each iteration otherwise too much memory is used
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_get_kmers_k_canonical -- returns a ptr to an HashTable containing Kmer objects (canonical kmers of length k on both strands in the interval)
+//
+//	parameters:
+//		k - length of the kmers searched
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//
+/////////////////////////////////////////////////////////////////////////////////////
+HashTable *Nessie::routine_get_kmers_k_canonical(size_t k, size_t start, size_t end){
+
+	// Collecting hits into an HashTable
+	HashTableSink sink(false);
+	Nessie::routine_scan_kmers_k_canonical(k, start, end, sink);
+
+	return sink.release_hash_table_ptr();
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
 //
-//	routine_get_kmers_k -- returns a ptr to an HashTable containing Kmer objects (kmers of length k in the interval)
+//	routine_scan_kmers_k_canonical -- delivers to sink the hits (canonical kmers of length k on both strands in the interval)
 //
 //	parameters:
 //		k - length of the kmers searched
 //		start - starting index of the interval to search
 //		end - ending index of the interval to search
+//		sink - HitSink that receives the hits
 //
-//	note: this function works well with sequences of length up to ten thousands of bp,
-//		  but it becomes inefficient (both in space and time) with strings of hundred thousands of bp
+//	note: the canonical kmer is the lower in lexicographic order between the kmer and its reverse complement,
+//		  the reverse complement is derived from the mask of the kmer so the string is encoded and scanned only once.
+//		  A kmer and its reverse complement start and end at the same indexes on the two strands,
+//		  hits are reported with the starting index on the stored strand
 //
 /////////////////////////////////////////////////////////////////////////////////////
-HashTable *Nessie::routine_get_kmers_k(size_t k, size_t start, size_t end){
+void Nessie::routine_scan_kmers_k_canonical(size_t k, size_t start, size_t end, HitSink &sink){
 
 	// Some variables
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
-	if (k > (end - start + 1)){ throw std::invalid_argument("Get kmers k: k is longer than the sequence interval"); }
-
-	// Initializing HashTable
-	HashTable *hash_table_ptr = new HashTable(false);	// bigger HashTable is used for faster look up
+	if (k > (end - start + 1)){ throw std::invalid_argument("Get kmers k canonical: k is longer than the sequence interval"); }
 
 	// Defining bytes necessary to store the kmer
 	size_t dna_bytes = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
 
-	// Defining the mask to encode the kmer
+	// Defining the mask to encode the kmer and the mask to encode its reverse complement
 	uint8_t mask_kmer[dna_bytes];
 	uint8_t *mask_kmer_ptr = mask_kmer;
 	std::memset(mask_kmer, 0, dna_bytes);
+	uint8_t mask_rc[dna_bytes];
+	uint8_t *mask_rc_ptr = mask_rc;
 
 	// Initializing mask for the first kmer of length k in the interval
-	size_t c = 0;	// counter for the mask_kmer creation
-	for (size_t i = start; i < (start + k); ++i){
-		uint8_t shift_DNA = (i & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
-		uint8_t shift_mask = (c & ((1 << 2) - 1)) << 1;	// shift to move from one base to the next one in the kmer_mask (uint8_t array)
-		uint8_t base = (string_bit_ptr->data_ptr[i >> 2] & (BASE_MASK << shift_DNA)) >> shift_DNA;	// retrieving the ENCODING
-		mask_kmer_ptr[c >> 2] |= (base << shift_mask);	// insert base in the mask_kmer
-		++c;
-	}
+	Nessie::routine_init_mask(mask_kmer_ptr, k, start);
 
-	// Creating and adding first Kmer to the HashTable
-	Kmer *kmer_ptr = new Kmer(k);	// defining ptr to new Kmer object
-	copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_ptr, dna_bytes);
-	kmer_ptr->indexes.push_back(start);
-	kmer_ptr->counts += 1;
-	hash_table_ptr->insert_kmer(kmer_ptr);	// adding Kmer to the HashTable
+	// Adding first kmer
+	reverse_complement_dna(mask_rc_ptr, mask_kmer_ptr, dna_bytes, k);
+	sink.add_hit(start, k, (is_lower_dna(mask_rc_ptr, mask_kmer_ptr, dna_bytes)) ? mask_rc_ptr : mask_kmer_ptr, dna_bytes, NULL);
 
 	// Sliding by one base at each iteration to get successive kmers
 	size_t last_index = k - 1;
 	uint8_t shift_mask = (last_index & ((1 << 2) - 1)) << 1;
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = (start + 1); i <= (end - k + 1); ++i){	//std::cout << i << std::endl;
+		nessie_progress.update(i);
 		uint8_t shift_DNA = ((i + last_index) & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
 		uint8_t base = (string_bit_ptr->data_ptr[(i + last_index) >> 2] & (BASE_MASK << shift_DNA)) >> shift_DNA;	// retrieving the ENCODING
 		shift_2_right(mask_kmer_ptr, dna_bytes);	// shift the uint8_t array encoding the kmer (removes the first base)
 		mask_kmer_ptr[last_index >> 2] |= base << shift_mask;	// adding the new base to mask_kmer
 
-		// Creating and adding i-th Kmer to the HashTable
-		Kmer *kmer_ptr = new Kmer(k);
-		copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_ptr, dna_bytes);
-		kmer_ptr->indexes.push_back(i);
-		kmer_ptr->counts += 1;
-		hash_table_ptr->insert_kmer(kmer_ptr);
+		// Adding i-th kmer, the lower between the kmer and its reverse complement
+		reverse_complement_dna(mask_rc_ptr, mask_kmer_ptr, dna_bytes, k);
+		sink.add_hit(i, k, (is_lower_dna(mask_rc_ptr, mask_kmer_ptr, dna_bytes)) ? mask_rc_ptr : mask_kmer_ptr, dna_bytes, NULL);
 	}
-
-	return hash_table_ptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
 //
-//	print_kmers -- prints all the Kmers of length [k_min..k_max] in the interval
+//	print_kmers_canonical -- prints all the canonical Kmers of length [k_min..k_max] on both strands in the interval
 //
 //	parameters:
 //		k_min - minimum length of the kmers searched
@@ -2805,17 +3942,17 @@ HashTable *Nessie::routine_get_kmers_k(size_t k, size_t start, size_t end){
 //		start_idx - starting index used to shift all other printed indexes [0]
 //
 /////////////////////////////////////////////////////////////////////////////////////
-void Nessie::print_kmers(size_t k_min, size_t k_max, size_t start, size_t end, std::ostream &fout, bool counts, bool indexes, size_t start_idx){
+void Nessie::print_kmers_canonical(size_t k_min, size_t k_max, size_t start, size_t end, std::ostream &fout, bool counts, bool indexes, size_t start_idx){
 
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
-	if (start > end){ throw std::invalid_argument("Print kmers: starting index is larger than ending index"); }
+	if (start > end){ throw std::invalid_argument("Print kmers canonical: starting index is larger than ending index"); }
 	if (!k_max){ k_max = k_min; }	// if k_max is not defined it is set to default as k_min, only kmers of length k_min are searched
-	if (k_min > k_max){ throw std::invalid_argument("Print kmers: k_min is larger than k_max"); }
-	if (k_max > (end - start + 1)){ throw std::invalid_argument("Print kmers: k_max is longer than the sequence interval"); }
+	if (k_min > k_max){ throw std::invalid_argument("Print kmers canonical: k_min is larger than k_max"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Print kmers canonical: k_max is longer than the sequence interval"); }
 
 	// Check range k_min..k_max
 	for (size_t i = k_min; i <= k_max; ++i){
-		HashTable *hash_table_ptr = Nessie::routine_get_kmers_k(i, start, end);
+		HashTable *hash_table_ptr = Nessie::routine_get_kmers_k_canonical(i, start, end);
 		if (!start_idx){
 			hash_table_ptr->print_table(fout, counts, indexes);
 		}
@@ -2826,6 +3963,73 @@ void Nessie::print_kmers(size_t k_min, size_t k_max, size_t start, size_t end, s
 	}
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	scan_kmers_canonical -- delivers to sink all the canonical Kmers of length [k_min..k_max] on both strands in the interval as they are found
+//
+//	parameters:
+//		sink - HitSink that receives the hits
+//		k_min - minimum length of the kmers searched
+//		k_max - maximum length of the kmers searched [0]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::scan_kmers_canonical(HitSink &sink, size_t k_min, size_t k_max, size_t start, size_t end){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Scan kmers canonical: starting index is larger than ending index"); }
+	if (!k_max){ k_max = k_min; }	// if k_max is not defined it is set to default as k_min, only kmers of length k_min are searched
+	if (k_min > k_max){ throw std::invalid_argument("Scan kmers canonical: k_min is larger than k_max"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Scan kmers canonical: k_max is longer than the sequence interval"); }
+
+	// Check range k_min..k_max
+	for (size_t i = k_min; i <= k_max; ++i){
+		Nessie::routine_scan_kmers_k_canonical(i, start, end, sink);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	scan_kmers_keys -- adds to a KmerCounter the keys for all the kmers in the interval, no positions are stored
+//
+//	parameters:
+//		counter - KmerCounter that receives the keys, sets the length of the kmers and if they are canonical
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+//	note: the key is updated with a shift at each base, for canonical kmers also the key of the reverse complement
+//		  is updated (the complement of the new base enters from the highest bits) and the lower of the two is added
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::scan_kmers_keys(KmerCounter &counter, size_t start, size_t end){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Scan kmers keys: starting index is larger than ending index"); }
+	if (counter.get_k() > (end - start + 1)){ throw std::invalid_argument("Scan kmers keys: k is longer than the sequence interval"); }
+
+	// Variables
+	size_t k = counter.get_k();
+	bool canonical = counter.get_canonical();
+	uint64_t mask_key = (32 == k) ? ~((uint64_t) 0) : ((((uint64_t) 1) << (k << 1)) - 1);	// 2 * k bits used by the keys
+	uint8_t shift_rc = (k - 1) << 1;	// shift to add a base as first base of the reverse complement
+	uint64_t key = 0, key_rc = 0;
+	size_t first_end = start + k - 1;	// ending index of the first kmer
+
+	nessie_progress.begin_pass(offset, start, end);
+	for (size_t i = start; i <= end; ++i){
+		nessie_progress.update(i);
+		uint8_t shift_DNA = (i & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
+		uint64_t base = (string_bit_ptr->data_ptr[i >> 2] >> shift_DNA) & BASE_MASK;	// retrieving the ENCODING
+		key = ((key << 2) | base) & mask_key;
+		key_rc = (key_rc >> 2) | ((base ^ BASE_MASK) << shift_rc);
+
+		if (i >= first_end){
+			counter.add_key((canonical && (key_rc < key)) ? key_rc : key);
+		}
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 //
 //	routine_init_counts
@@ -2952,10 +4156,12 @@ std::vector<double> *Nessie::shannon_entropy_sliding(size_t interval_len, size_t
 	Nessie::routine_init_counts(array_counts_ptr, start, end_0);
 
 	// Shifting interval and calculating entropy
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = start; i <= end - interval_len + 1; i += shift){	//std::cout << i << " - " << end - interval_len + 1 << std::endl;
+		nessie_progress.update(i);
 		entropy = Nessie::routine_shannon_entropy(array_counts_ptr, interval_len);
 		entropy_vector_ptr->push_back(entropy);
-		Nessie::routine_shift_counts(array_counts_ptr, interval_len, shift, i);
+		if (i + shift <= end - interval_len + 1){ Nessie::routine_shift_counts(array_counts_ptr, interval_len, shift, i); }	// the last window is not shifted past the end
 	}
 
 	return entropy_vector_ptr;
@@ -2992,7 +4198,9 @@ void Nessie::print_shannon_entropy_sliding(size_t interval_len, size_t shift, st
 	Nessie::routine_init_counts(array_counts_ptr, start, end_0);
 
 	// Shifting interval and calculating entropy
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = start; i <= end - interval_len + 1; i += shift){	//std::cout << i << " - " << end - interval_len + 1 << std::endl;
+		nessie_progress.update(i);
 		entropy = Nessie::routine_shannon_entropy(array_counts_ptr, interval_len);
 		fout << i << "\t" << std::setprecision (16) << entropy;
 		fout << "\tA:" << array_counts_ptr[0];
@@ -3000,7 +4208,7 @@ void Nessie::print_shannon_entropy_sliding(size_t interval_len, size_t shift, st
 		fout << "\tG:" << array_counts_ptr[2];
 		fout << "\tT:" << array_counts_ptr[3];
 		fout << std::endl;
-		Nessie::routine_shift_counts(array_counts_ptr, interval_len, shift, i);
+		if (i + shift <= end - interval_len + 1){ Nessie::routine_shift_counts(array_counts_ptr, interval_len, shift, i); }	// the last window is not shifted past the end
 	}
 }
 
@@ -3168,6 +4376,7 @@ void Nessie::print_linguistic_complexity_interval(std::ostream &fout, size_t sta
 		Vmaxk_tot += (possible_kmers < possible_kmers_sequence) ? possible_kmers : possible_kmers_sequence;
 
 		// Real kmers counts
+		nessie_progress.begin_pass(offset, start, end);	// one pass over the interval for each k
 		std::list<uint64_t> *list_ptr = routine_get_kmers_k_unique(i, start, end);
 		Vk_tot += list_ptr->size();
 		delete list_ptr;
@@ -3211,7 +4420,9 @@ std::vector<double> *Nessie::linguistic_complexity_sliding(size_t interval_len,
 	std::vector<double> *linguistic_vector_ptr = new std::vector<double>;
 
 	// Calculating complexity
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = start; i <= end - interval_len + 1; i += shift){	//std::cout << i << " - " << end - interval_len + 1 << std::endl;
+		nessie_progress.update(i);
 		size_t end_i = i + interval_len - 1;
 		complexity = Nessie::linguistic_complexity_interval(i, end_i, k_min, k_max);
 		linguistic_vector_ptr->push_back(complexity);
@@ -3252,7 +4463,9 @@ void Nessie::print_linguistic_complexity_sliding(size_t interval_len, size_t shi
 	double complexity;
 
 	// Calculating complexity
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = start; i <= end - interval_len + 1; i += shift){	//std::cout << i << " - " << end - interval_len + 1 << std::endl;
+		nessie_progress.update(i);
 		size_t end_i = i + interval_len - 1;
 		complexity = Nessie::linguistic_complexity_interval(i, end_i, k_min, k_max);
 		fout << i << "\t" << std::setprecision (16) << complexity << std::endl;
@@ -3273,7 +4486,7 @@ uint64_t Nessie::routine_convert_to_uint64(uint8_t *mask_kmer_ptr, size_t mask_k
 	uint64_t idx = 0;
 
 	for (size_t i = 0; i < mask_kmer_len; ++i){
-		idx |= mask_kmer_ptr[i] << (i * 8);
+		idx |= ((uint64_t) mask_kmer_ptr[i]) << (i * 8);
 	}
 
 	return idx;
@@ -3319,29 +4532,377 @@ std::list<uint64_t> *Nessie::routine_get_kmers_k_unique(size_t k, size_t start,
 		++c;
 	}
 
-	// Adding first kmer
-	idx = routine_convert_to_uint64(mask_kmer_ptr, dna_bytes);
-	list_ptr->push_back(idx);
+	// Adding first kmer
+	idx = routine_convert_to_uint64(mask_kmer_ptr, dna_bytes);
+	list_ptr->push_back(idx);
+
+	// Sliding by one base at each iteration to get successive kmers
+	size_t last_index = k - 1;
+	uint8_t shift_mask = (last_index & ((1 << 2) - 1)) << 1;
+	for (size_t i = (start + 1); i <= (end - k + 1); ++i){	//std::cout << i << std::endl;
+		nessie_progress.update(i);	// the pass is started by the caller, inside a sliding window the index stays close to the window
+		uint8_t shift_DNA = ((i + last_index) & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
+		uint8_t base = (string_bit_ptr->data_ptr[(i + last_index) >> 2] & (BASE_MASK << shift_DNA)) >> shift_DNA;	// retrieving the ENCODING
+		shift_2_right(mask_kmer_ptr, dna_bytes);	// shift the uint8_t array encoding the kmer (removes the first base)
+		mask_kmer_ptr[last_index >> 2] |= base << shift_mask;	// adding the new base to mask_kmer
+
+		// Adding i-th kmer
+		idx = routine_convert_to_uint64(mask_kmer_ptr, dna_bytes);
+		list_ptr->push_back(idx);
+	}
+
+	// Removing duplicates
+	list_ptr->sort();
+	list_ptr->unique();
+
+	return list_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_get_base_word -- returns the 32 bases starting at index i of the DNA string as uint64_t (2 bits per base),
+//							 bases after the end of the string are set to 0
+//
+//	parameters:
+//		i - index of the first base
+//
+/////////////////////////////////////////////////////////////////////////////////////
+uint64_t Nessie::routine_get_base_word(size_t i){
+
+	// Variables
+	uint8_t *data_ptr = string_bit_ptr->data_ptr;
+	size_t dna_bytes = (string_bit_ptr->data_len >> 2) + (0 != (string_bit_ptr->data_len & ((1 << 2) - 1)));	// (n / 4) + (0 != (n % 4))
+	size_t byte_i = i >> 2;
+	size_t shift = (i & ((1 << 2) - 1)) << 1;
+	uint64_t word = 0;
+
+	// Reading up to 9 bytes, the first base can be anywhere in the first byte
+	for (size_t b = 0; (b < 9) && ((byte_i + b) < dna_bytes); ++b){
+		if (b < 8){
+			word |= ((uint64_t) data_ptr[byte_i + b]) << (b << 3);
+		}
+		else if (shift){
+			word = (word >> shift) | (((uint64_t) data_ptr[byte_i + b]) << (64 - shift));
+			return word;
+		}
+	}
+
+	return word >> shift;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_find_base -- returns the first index in [i..end] where the base is (or is not) equal to base, end + 1 if none
+//
+//	parameters:
+//		i - index where to start the search
+//		end - ending index of the search
+//		base - encoding of the base (ENCODING_A, ENCODING_C, ENCODING_G or ENCODING_T)
+//		equal - if true the first index with base is returned, otherwise the first index with a different base
+//
+//	note: 32 bases are compared at a time, a run of bases is skipped in a number of steps that depends on its length / 32
+//
+/////////////////////////////////////////////////////////////////////////////////////
+size_t Nessie::routine_find_base(size_t i, size_t end, uint8_t base, bool equal){
+
+	// Variables
+	uint64_t low_bits = 0x5555555555555555ULL;	// lower bit of each base
+	uint64_t pattern = low_bits * base;	// base repeated 32 times
+
+	while (i <= end){
+		uint64_t diff = routine_get_base_word(i) ^ pattern;
+		uint64_t match = ~(diff | (diff >> 1)) & low_bits;	// lower bit is set for the bases equal to base
+		if (!equal){
+			match ^= low_bits;
+		}
+		if (match){
+			size_t j = i + (BitBoard::lsb64_intrinsic(match) >> 1);
+			return (j <= end) ? j : end + 1;
+		}
+		i += 32;
+	}
+
+	return end + 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_chain_quadruplex_runs -- adds to tract_vector the tracts in a cluster of runs of base, as pairs of starting index and length
+//
+//	parameters:
+//		tract_vector - vector where to add the tracts
+//		block_vector - maximal runs of base of length >= run_min in the cluster, as pairs of first and last index
+//		run_min - min length of the runs
+//		loop_min - min length of the loops between two runs
+//		loop_max - max length of the loops between two runs
+//		end_vector - vector used as buffer for the longest ends
+//
+//	note: a run is any stretch of run_min or more bases inside a block, a block can host several runs
+//		  separated by loops of base. end_vector stores for each index a and m in [1..4] 1 + the longest end
+//		  of a chain of m or more runs with the first run starting at a (0 if none), it is filled from the end
+//		  of the cluster as the max over the window of the indexes where the next run can start, kept in a monotonic queue.
+//		  The tracts are then taken from the start of the cluster as the leftmost longest chains of four or more runs
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_chain_quadruplex_runs(std::vector<size_t> &tract_vector, const std::vector<size_t> &block_vector, size_t run_min, size_t loop_min, size_t loop_max, std::vector<size_t> &end_vector){
+
+	// Variables
+	size_t cluster_start = block_vector.front(), cluster_end = block_vector.back();
+	size_t cluster_len = cluster_end - cluster_start + 1;
+	size_t *end_ptr[4], *queue_ptr[4];	// longest ends and monotonic queue of the window for chains of m + 1 or more runs
+	size_t queue_back[4], queue_front[4];	// queue in [back..front), indexes decreasing and ends increasing from front to back
+	size_t b = block_vector.size() >> 1;	// the current block is b - 1, the last block starting at or before a
+
+	end_vector.assign(8 * cluster_len, 0);
+	for (size_t m = 0; m < 4; ++m){
+		end_ptr[m] = &end_vector[m * cluster_len];
+		queue_ptr[m] = &end_vector[(4 + m) * cluster_len];
+		queue_back[m] = queue_front[m] = 0;
+	}
+
+	for (size_t a = cluster_end + 1; a-- > cluster_start; ){
+		// Adding to the windows the index a + run_min + loop_min, the first where the next run can start
+		size_t next = a + run_min + loop_min;
+		if (next <= cluster_end){
+			for (size_t m = 0; m < 4; ++m){
+				size_t *src_ptr = end_ptr[m ? m - 1 : 0];	// chains of m or more runs follow a run for chains of m + 1, chains of 1 or more follow a run for chains of 1 or more
+				while ((queue_front[m] > queue_back[m]) && (src_ptr[queue_ptr[m][queue_front[m] - 1] - cluster_start] <= src_ptr[next - cluster_start])){ --queue_front[m]; }
+				queue_ptr[m][queue_front[m]++] = next;
+			}
+		}
+
+		// Checking that a run can start at a
+		while (b && (block_vector[(b - 1) << 1] > a)){ --b; }
+		if (!b){ continue; }
+		size_t block_end = block_vector[((b - 1) << 1) + 1];
+		if ((a > block_end) || ((block_end - a + 1) < run_min)){ continue; }
+
+		// Removing from the windows the indexes after the last where the next run can start
+		size_t last = block_end + 1 + loop_max;
+		for (size_t m = 0; m < 4; ++m){
+			size_t *src_ptr = end_ptr[m ? m - 1 : 0];
+			while ((queue_front[m] > queue_back[m]) && (queue_ptr[m][queue_back[m]] > last)){ ++queue_back[m]; }
+			size_t best = (queue_front[m] > queue_back[m]) ? src_ptr[queue_ptr[m][queue_back[m]] - cluster_start] : 0;
+			if (!m){ best = std::max(best, block_end + 1); }	// a single run can extend to the end of the block
+			end_ptr[m][a - cluster_start] = best;
+		}
+	}
+
+	// Leftmost longest chains of four or more runs
+	size_t a = cluster_start;
+	while (a <= cluster_end){
+		size_t chain_end = end_ptr[3][a - cluster_start];
+		if (chain_end){
+			tract_vector.push_back(a);
+			tract_vector.push_back(chain_end - a);
+			a = chain_end;
+		}
+		else { ++a; }
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_get_quadruplex_tracts -- adds to tract_vector the tracts of four or more runs of base in the interval, as pairs of starting index and length
+//
+//	parameters:
+//		tract_vector - vector where to add the tracts
+//		base - encoding of the base of the runs, ENCODING_G (G4 on this strand) or ENCODING_C (G4 on the opposite strand)
+//		run_min - min length of the runs
+//		loop_min - min length of the loops between two runs
+//		loop_max - max length of the loops between two runs
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//
+//	note: the tracts are the matches of (G{run_min,}N{loop_min,loop_max}){3,}G{run_min,} searched as a POSIX regex,
+//		  leftmost longest and not overlapping, loops can contain G and a long run can be split into several runs.
+//		  Maximal runs of base of length >= run_min closer than loop_max are grouped in clusters, a tract never spans two clusters,
+//		  clusters that cannot host four runs are skipped and the others are chained (routine_chain_quadruplex_runs)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_get_quadruplex_tracts(std::vector<size_t> &tract_vector, uint8_t base, size_t run_min, size_t loop_min, size_t loop_max, size_t start, size_t end){
+
+	// Variables
+	std::vector<size_t> block_vector;	// maximal runs of base in the current cluster, as pairs of first and last index
+	std::vector<size_t> end_vector;	// buffer for routine_chain_quadruplex_runs
+	size_t capacity = 0;	// max number of runs the blocks of the cluster can host
+
+	size_t i = start;
+	while (i <= end){
+		// Next run of base
+		size_t run_start = Nessie::routine_find_base(i, end, base, true);
+		if (run_start > end){ break; }
+		size_t run_end = Nessie::routine_find_base(run_start, end, base, false) - 1;
+		i = run_end + 1;
+
+		if ((run_end - run_start + 1) < run_min){ continue; }	// too short, part of a loop
+
+		// Closing the cluster if the run is too far from the previous one
+		if (!block_vector.empty() && ((run_start - block_vector.back() - 1) > loop_max)){
+			if (capacity >= 4){ Nessie::routine_chain_quadruplex_runs(tract_vector, block_vector, run_min, loop_min, loop_max, end_vector); }
+			block_vector.clear();
+			capacity = 0;
+		}
+		block_vector.push_back(run_start);
+		block_vector.push_back(run_end);
+		capacity += (run_end - run_start + 1 + loop_min) / (run_min + loop_min);
+	}
+
+	if (capacity >= 4){ Nessie::routine_chain_quadruplex_runs(tract_vector, block_vector, run_min, loop_min, loop_max, end_vector); }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_quadruplexes -- delivers to sink the hits (tracts with G4-DNA forming potential on both strands in the interval) in ascending order of index
+//
+//	parameters:
+//		run_min - min length of the G-runs (C-runs for the opposite strand)
+//		loop_min - min length of the loops
+//		loop_max - max length of the loops
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		sink - HitSink that receives the hits
+//
+//	note: the tracts of G-runs and C-runs are found separately (routine_get_quadruplex_tracts) and merged by index,
+//		  for the same index the G tract is delivered first
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_quadruplexes(size_t run_min, size_t loop_min, size_t loop_max, size_t start, size_t end, HitSink &sink){
+
+	// Variables
+	std::vector<size_t> tract_g, tract_c;
+	size_t g = 0, c = 0;
+
+	// Finding the tracts on both strands
+	Nessie::routine_get_quadruplex_tracts(tract_g, ENCODING_G, run_min, loop_min, loop_max, start, end);
+	Nessie::routine_get_quadruplex_tracts(tract_c, ENCODING_C, run_min, loop_min, loop_max, start, end);
+
+	// Merging by index
+	while ((g < tract_g.size()) || (c < tract_c.size())){
+		std::vector<size_t> *tract_ptr;
+		size_t *t_ptr;
+		if ((c >= tract_c.size()) || ((g < tract_g.size()) && (tract_g[g] <= tract_c[c]))){
+			tract_ptr = &tract_g;
+			t_ptr = &g;
+		}
+		else{
+			tract_ptr = &tract_c;
+			t_ptr = &c;
+		}
+		size_t i = (*tract_ptr)[*t_ptr], k = (*tract_ptr)[*t_ptr + 1];
+		*t_ptr += 2;
+
+		// Defining bytes necessary to store the tract
+		size_t dna_bytes_k = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
+
+		// Defining the mask to encode the tract
+		uint8_t mask_kmer_k[dna_bytes_k];
+		uint8_t *mask_kmer_k_ptr = mask_kmer_k;
+		std::memset(mask_kmer_k, 0, dna_bytes_k);
+
+		// Initializing mask for the tract of length k at index i
+		Nessie::routine_init_mask(mask_kmer_k_ptr, k, i);
+
+		sink.add_hit(i, k, mask_kmer_k_ptr, dna_bytes_k, NULL);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	get_quadruplexes -- returns a ptr to a LinkedlistKmer that stores all the tracts with G4-DNA forming potential on both strands in the interval
+//
+//	parameters:
+//		run_min - min length of the G-runs (C-runs for the opposite strand) [3]
+//		loop_min - min length of the loops [1]
+//		loop_max - max length of the loops [7]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+//	note: a tract is made of four or more runs separated by loops (routine_get_quadruplex_tracts)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+LinkedlistKmer *Nessie::get_quadruplexes(size_t run_min, size_t loop_min, size_t loop_max, size_t start, size_t end){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Get quadruplexes: starting index is larger than ending index"); }
+	if (!run_min){ throw std::invalid_argument("Get quadruplexes: run_min must be larger than 0"); }
+	if (loop_min > loop_max){ throw std::invalid_argument("Get quadruplexes: loop_min is larger than loop_max"); }
+
+	// Initializing LinkedlistKmer
+	LinkedlistKmer *ll_kmer_ptr = new LinkedlistKmer;
+
+	// Collecting hits into an HashTable
+	HashTableSink sink(true);
+	Nessie::routine_scan_quadruplexes(run_min, loop_min, loop_max, start, end, sink);
+
+	// Add to LinkedlistKmer
+	HashTable *hash_table_ptr = sink.release_hash_table_ptr();
+	hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
+
+	return ll_kmer_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	scan_quadruplexes -- delivers to sink all the tracts with G4-DNA forming potential on both strands in the interval in ascending order of index
+//
+//	parameters:
+//		sink - HitSink that receives the hits
+//		run_min - min length of the G-runs (C-runs for the opposite strand) [3]
+//		loop_min - min length of the loops [1]
+//		loop_max - max length of the loops [7]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+//	note: a tract is made of four or more runs separated by loops (routine_get_quadruplex_tracts)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::scan_quadruplexes(HitSink &sink, size_t run_min, size_t loop_min, size_t loop_max, size_t start, size_t end){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Scan quadruplexes: starting index is larger than ending index"); }
+	if (!run_min){ throw std::invalid_argument("Scan quadruplexes: run_min must be larger than 0"); }
+	if (loop_min > loop_max){ throw std::invalid_argument("Scan quadruplexes: loop_min is larger than loop_max"); }
+
+	Nessie::routine_scan_quadruplexes(run_min, loop_min, loop_max, start, end, sink);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	print_quadruplexes -- prints all the tracts with G4-DNA forming potential on both strands in the interval
+//
+//	parameters:
+//		run_min - min length of the G-runs (C-runs for the opposite strand) [3]
+//		loop_min - min length of the loops [1]
+//		loop_max - max length of the loops [7]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//		fout - ostream element to be used for printing [cout]
+//		counts - bool value, if true print the counts information for the Kmer [true]
+//		indexes - bool value, if true print the indexes list for the Kmer [true]
+//		start_idx - starting index used to shift all other printed indexes [0]
+//
+//	note: a tract is made of four or more runs separated by loops (routine_get_quadruplex_tracts)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::print_quadruplexes(size_t run_min, size_t loop_min, size_t loop_max, size_t start, size_t end, std::ostream &fout, bool counts, bool indexes, size_t start_idx){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Print quadruplexes: starting index is larger than ending index"); }
+	if (!run_min){ throw std::invalid_argument("Print quadruplexes: run_min must be larger than 0"); }
+	if (loop_min > loop_max){ throw std::invalid_argument("Print quadruplexes: loop_min is larger than loop_max"); }
 
-	// Sliding by one base at each iteration to get successive kmers
-	size_t last_index = k - 1;
-	uint8_t shift_mask = (last_index & ((1 << 2) - 1)) << 1;
-	for (size_t i = (start + 1); i <= (end - k + 1); ++i){	//std::cout << i << std::endl;
-		uint8_t shift_DNA = ((i + last_index) & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
-		uint8_t base = (string_bit_ptr->data_ptr[(i + last_index) >> 2] & (BASE_MASK << shift_DNA)) >> shift_DNA;	// retrieving the ENCODING
-		shift_2_right(mask_kmer_ptr, dna_bytes);	// shift the uint8_t array encoding the kmer (removes the first base)
-		mask_kmer_ptr[last_index >> 2] |= base << shift_mask;	// adding the new base to mask_kmer
+	// Collecting hits into an HashTable
+	HashTableSink sink(true);
+	Nessie::routine_scan_quadruplexes(run_min, loop_min, loop_max, start, end, sink);
 
-		// Adding i-th kmer
-		idx = routine_convert_to_uint64(mask_kmer_ptr, dna_bytes);
-		list_ptr->push_back(idx);
+	// Printing
+	if (!start_idx){
+		sink.get_hash_table_ptr()->print_table(fout, counts, indexes);
+	}
+	else{
+		sink.get_hash_table_ptr()->print_table_shifted_indexes(start_idx, fout, counts, indexes);
 	}
-
-	// Removing duplicates
-	list_ptr->sort();
-	list_ptr->unique();
-
-	return list_ptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -3419,13 +4980,14 @@ bool Nessie::routine_check_triplex_forming_interval(BIT_ARRAY **monomer_bitarray
 //
 //	parameters:
 //		mask_kmer_ptr - ptr to a mask (uint8_t array) encoding the kmer
+//		alignment_ptr - ptr to a kmer_alignment that receives the alignment, the operations must fit k
 //		k - length of the kmer
 //		max_mm - max number of mismatch allowed
 //		max_gap - max number of gaps allowed
 //		max_purine - max number of non-purines allowed
 //
 /////////////////////////////////////////////////////////////////////////////////////
-bool Nessie::routine_check_triplex_forming_gap(uint8_t *mask_kmer_ptr, std::vector<bool> *align_vector_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine){
+bool Nessie::routine_check_triplex_forming_gap(uint8_t *mask_kmer_ptr, kmer_alignment *alignment_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine){
 
 	// Variables
 	size_t array_counts[4] = {0};
@@ -3442,7 +5004,7 @@ bool Nessie::routine_check_triplex_forming_gap(uint8_t *mask_kmer_ptr, std::vect
 		return triplex;
 	}
 
-	return routine_check_global_alignment(mask_kmer_ptr, align_vector_ptr, k, max_mm, max_gap, max_gapmm, 0);
+	return routine_check_global_alignment(mask_kmer_ptr, alignment_ptr, k, max_mm, max_gap, max_gapmm, 0);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -3451,6 +5013,7 @@ bool Nessie::routine_check_triplex_forming_gap(uint8_t *mask_kmer_ptr, std::vect
 //
 //	parameters:
 //		mask_kmer_ptr - ptr to a mask (uint8_t array) encoding the kmer
+//		alignment_ptr - ptr to a kmer_alignment that receives the alignment, the operations must fit k
 //		k - length of the kmer
 //		max_mm - max number of mismatch allowed
 //		max_gap - max number of gaps allowed
@@ -3459,7 +5022,7 @@ bool Nessie::routine_check_triplex_forming_gap(uint8_t *mask_kmer_ptr, std::vect
 //		end - ending index of the interval to check
 //
 /////////////////////////////////////////////////////////////////////////////////////
-bool Nessie::routine_check_triplex_forming_gap_interval(uint8_t *mask_kmer_ptr, std::vector<bool> *align_vector_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine, size_t start, size_t end){
+bool Nessie::routine_check_triplex_forming_gap_interval(uint8_t *mask_kmer_ptr, kmer_alignment *alignment_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine, size_t start, size_t end){
 
 	if (start > end){ throw std::invalid_argument("Triplex forming gap interval: starting index is larger than ending index"); }
 	if ((end + 1) > k){ throw std::invalid_argument("Triplex forming gap interval: ending index is larger than sequence end"); }
@@ -3479,7 +5042,159 @@ bool Nessie::routine_check_triplex_forming_gap_interval(uint8_t *mask_kmer_ptr,
 		return triplex;
 	}
 
-	return Nessie::routine_check_global_alignment_interval(mask_kmer_ptr, align_vector_ptr, k, max_mm, max_gap, max_gapmm, 0, start, end);
+	return Nessie::routine_check_global_alignment_interval(mask_kmer_ptr, alignment_ptr, k, max_mm, max_gap, max_gapmm, 0, start, end);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_is_purine -- returns true if the base at index i is a purine (A or G)
+//
+//	parameters:
+//		i - index of the base
+//
+/////////////////////////////////////////////////////////////////////////////////////
+bool Nessie::routine_is_purine(size_t i){
+
+	uint8_t shift_DNA = (i & ((1 << 2) - 1)) << 1;	// shift from 0 to 6 with a step of two to move from one base to the next one in the uint8_t array
+
+	return !(((string_bit_ptr->data_ptr[i >> 2] >> shift_DNA) & BASE_MASK) & 1);	// A = 00 and G = 10 are purines
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_check_purine -- check the composition of a kmer for the triplex forming potential given its purine counts
+//
+//	parameters:
+//		purine_c - number of purines in the kmer
+//		k - length of the kmer
+//		max_purine - max number of non-purines allowed
+//
+//	note: same composition check of routine_check_triplex_forming, either purines or pyrimidines must be at most max_purine.
+//		  The triplex routines keep the purine counts sliding with the kmer, so that most kmers are rejected
+//		  in constant time before checking the symmetry
+//
+/////////////////////////////////////////////////////////////////////////////////////
+bool Nessie::routine_check_purine(size_t purine_c, size_t k, size_t max_purine){
+
+	return (purine_c <= max_purine) || ((k - purine_c) <= max_purine);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_get_triplex_seeds -- returns a ptr to a BIT_ARRAY marking the indexes of the interval that start at least a kmer
+//								 of length [k_min..k_max] with the composition for the triplex forming potential
+//
+//	parameters:
+//		k_min - min length of the kmers searched
+//		k_max - max length of the kmers searched
+//		modulo_purine - max number on non-purines allowed are calculated as integer division k / modulo_purine
+//		start - starting index of the interval
+//		end - ending index of the interval
+//
+//	note: bit j is set for index start + j, the BIT_ARRAY must be freed by the caller.
+//		  Kmer (i, k) is purine-rich if 100 * pyrimidines <= k * modulo_purine, that is when the sum of the weights (100 * pyrimidine - modulo_purine)
+//		  over the kmer is not positive. With S the prefix sums of the weights, index i is a seed if min(S[i + k]) <= S[i] for k in [k_min..k_max],
+//		  the same holds for pyrimidine-rich kmers with the weights of the purines.
+//		  The minimum is kept with a sliding window over the prefix sums (monotone queue), seeds are exact and found in a single pass
+//
+/////////////////////////////////////////////////////////////////////////////////////
+BIT_ARRAY *Nessie::routine_get_triplex_seeds(size_t k_min, size_t k_max, size_t modulo_purine, size_t start, size_t end){
+
+	if (!k_min || (k_min > k_max)){ throw std::invalid_argument("Get triplex seeds: min_k and max_k are not valid"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get triplex seeds: max_k is longer than the sequence interval"); }
+
+	// Variables
+	BIT_ARRAY *seeds_ptr = bit_array_create(end - start + 1);
+	size_t sum_len = k_max + 1;	// length of the circular buffers, prefix sums from S[i] to S[i + k_max] are alive at each index
+	int64_t weight_purine = 100 - (int64_t) modulo_purine, weight_other = - (int64_t) modulo_purine;
+	int64_t running[2] = {0, 0};	// 0 = weights of pyrimidines (purine-rich kmers), 1 = weights of purines (pyrimidine-rich kmers)
+	size_t next_sum = start, next_push = start + k_min;	// first prefix sum not computed, first prefix sum not in the queues
+
+	// Creating the circular buffers for the prefix sums and the monotone queues
+	int64_t *sum_ptr[2];
+	size_t *queue_ptr[2];
+	size_t head[2] = {0, 0}, tail[2] = {0, 0};	// queues are [head..tail)
+	for (size_t s = 0; s < 2; ++s){
+		sum_ptr[s] = new int64_t[sum_len];
+		queue_ptr[s] = new size_t[sum_len];
+	}
+
+	for (size_t i = start; i <= (end - k_min + 1); ++i){
+		size_t right = (k_max < (end - i + 1)) ? i + k_max : end + 1;	// last prefix sum of the kmers starting at i
+
+		// Computing the prefix sums up to right
+		while (next_sum <= right){
+			sum_ptr[0][next_sum % sum_len] = running[0];
+			sum_ptr[1][next_sum % sum_len] = running[1];
+			if (next_sum <= end){
+				bool purine = Nessie::routine_is_purine(next_sum);
+				running[0] += (purine) ? weight_other : weight_purine;
+				running[1] += (purine) ? weight_purine : weight_other;
+			}
+			++next_sum;
+		}
+
+		for (size_t s = 0; s < 2; ++s){
+			// Pushing the prefix sums of the new kmers, the queue keeps increasing sums
+			for (size_t r = next_push; r <= right; ++r){
+				while ((head[s] != tail[s]) && (sum_ptr[s][queue_ptr[s][(tail[s] + sum_len - 1) % sum_len] % sum_len] >= sum_ptr[s][r % sum_len])){
+					tail[s] = (tail[s] + sum_len - 1) % sum_len;
+				}
+				queue_ptr[s][tail[s]] = r;
+				tail[s] = (tail[s] + 1) % sum_len;
+			}
+
+			// Popping the prefix sums of kmers shorter than k_min
+			while (queue_ptr[s][head[s]] < (i + k_min)){
+				head[s] = (head[s] + 1) % sum_len;
+			}
+
+			if (sum_ptr[s][queue_ptr[s][head[s]] % sum_len] <= sum_ptr[s][i % sum_len]){
+				bit_array_set_bit(seeds_ptr, i - start);
+			}
+		}
+		next_push = right + 1;
+	}
+
+	for (size_t s = 0; s < 2; ++s){
+		delete[] sum_ptr[s];
+		delete[] queue_ptr[s];
+	}
+
+	return seeds_ptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_check_mirror_symmetry_string -- check the kmer (i, k) for the mirror symmetry reading the bases from the DNA string
+//
+//	parameters:
+//		i - starting index of the kmer
+//		k - length of the kmer
+//		max_mm - max number of mismatch allowed
+//
+//	note: same result of routine_check_mirror_symmetry_interval, the outer pair must match and up to max_mm mismatches
+//		  are allowed in the inner pairs. The check stops at the first mismatch over max_mm
+//
+/////////////////////////////////////////////////////////////////////////////////////
+bool Nessie::routine_check_mirror_symmetry_string(size_t i, size_t k, size_t max_mm){
+
+	// Variables
+	uint8_t *data_ptr = string_bit_ptr->data_ptr;
+	size_t mm_c = 0;
+	NESSIE_STATS_ADD(windows, 1);
+
+	for (size_t t = 0; t < (k >> 1); ++t){
+		size_t left = i + t, right = i + k - 1 - t;
+		uint8_t base_left = (data_ptr[left >> 2] >> ((left & ((1 << 2) - 1)) << 1)) & BASE_MASK;
+		uint8_t base_right = (data_ptr[right >> 2] >> ((right & ((1 << 2) - 1)) << 1)) & BASE_MASK;
+		if ((base_left != base_right) && (!t || (++mm_c > max_mm))){
+			if (!t){ NESSIE_STATS_ADD(quick_rejects, 1); }
+			return false;
+		}
+	}
+
+	return true;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -3496,21 +5211,38 @@ bool Nessie::routine_check_triplex_forming_gap_interval(uint8_t *mask_kmer_ptr,
 //	note:
 //
 /////////////////////////////////////////////////////////////////////////////////////
-HashTable *Nessie::routine_get_kmers_k_triplex(size_t k, size_t max_mm, size_t max_purine, size_t start, size_t end){	//size_t check = 0;
+HashTable *Nessie::routine_get_kmers_k_triplex(size_t k, size_t max_mm, size_t max_purine, size_t start, size_t end){
+
+	// Collecting hits into an HashTable
+	HashTableSink sink(false);
+	Nessie::routine_scan_kmers_k_triplex(k, max_mm, max_purine, start, end, sink);
+
+	return sink.release_hash_table_ptr();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_kmers_k_triplex -- delivers to sink the hits (kmers of length k with triplex forming potential in the interval)
+//
+//	parameters:
+//		k - length of the kmers searched
+//		max_mm - maximum number of mismatch allowed
+//		max_purine - max number of non-purines allowed
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		sink - HitSink that receives the hits
+//
+//	note:
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_kmers_k_triplex(size_t k, size_t max_mm, size_t max_purine, size_t start, size_t end, HitSink &sink){	//size_t check = 0;
 
 	// Some variables
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
 	if (k > (end - start + 1)){ throw std::invalid_argument("Get triplex k: k is longer than the sequence interval"); }
 
-	// Initializing HashTable
-	HashTable *hash_table_ptr = new HashTable(false);
-
-	// Creating BIT_ARRAY to store monomers indexes for the mask
-	BIT_ARRAY *monomer_bitarray[4];
-	BIT_ARRAY **monomer_bitarray_ptr = monomer_bitarray;
-	for (size_t i = 0; i < 4; ++i){
-		monomer_bitarray_ptr[i] = bit_array_create(k);
-	}
+	// BIT_ARRAY to store monomers indexes for the mask, reused from the workspace
+	BIT_ARRAY **monomer_bitarray_ptr = workspace.get_monomer_bitarrays(k);
 
 	// Defining bytes necessary to store the kmer
 	size_t dna_bytes = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
@@ -3523,29 +5255,30 @@ HashTable *Nessie::routine_get_kmers_k_triplex(size_t k, size_t max_mm, size_t m
 	// Initializing bit_array and mask for the first kmer of length k in the interval
 	Nessie::routine_init_bitarray_and_mask(monomer_bitarray_ptr, mask_kmer_ptr, k, start);
 
-	// Check mirror simmetry for the first kmer
-	if (Nessie::routine_check_triplex_forming(monomer_bitarray_ptr, k, max_mm, max_purine)){
-		Kmer *kmer_ptr = new Kmer(k);	// defining ptr to new Kmer object
-		copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_ptr, dna_bytes);
-		kmer_ptr->indexes.push_back(start);
-		kmer_ptr->counts += 1;
-		hash_table_ptr->insert_kmer(kmer_ptr);	// adding Kmer to the HashTable
+	// Counting purines for the first kmer, the counts then slide with the kmer
+	size_t purine_c = 0;
+	for (size_t j = start; j < (start + k); ++j){
+		purine_c += Nessie::routine_is_purine(j);
+	}
+
+	// Check mirror simmetry for the first kmer, composition is checked first
+	if (Nessie::routine_check_purine(purine_c, k, max_purine) && Nessie::check_mirror_symmetry(monomer_bitarray_ptr, k, max_mm)){
+		sink.add_hit(start, k, mask_kmer_ptr, dna_bytes, NULL);
 	}
 
 	// Sliding by one base at each iteration to get successive kmers and checking their simmetry
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = (start + 1); i <= (end - k + 1); ++i){
+		nessie_progress.update(i);
 		Nessie::routine_shift_bitarray_and_mask(monomer_bitarray_ptr, mask_kmer_ptr, dna_bytes, k, i);
+		purine_c += Nessie::routine_is_purine(i + k - 1);
+		purine_c -= Nessie::routine_is_purine(i - 1);
 
-		if (Nessie::routine_check_triplex_forming(monomer_bitarray_ptr, k, max_mm, max_purine)){		//++check;
-			Kmer *kmer_ptr = new Kmer(k);
-			copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_ptr, dna_bytes);
-			kmer_ptr->indexes.push_back(i);
-			kmer_ptr->counts += 1;
-			hash_table_ptr->insert_kmer(kmer_ptr);
+		if (Nessie::routine_check_purine(purine_c, k, max_purine) && Nessie::check_mirror_symmetry(monomer_bitarray_ptr, k, max_mm)){		//++check;
+			sink.add_hit(i, k, mask_kmer_ptr, dna_bytes, NULL);
 		}
 	}
 	//std::cout << "CHECK " << check << std::endl;
-	return hash_table_ptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -3564,15 +5297,38 @@ HashTable *Nessie::routine_get_kmers_k_triplex(size_t k, size_t max_mm, size_t m
 //	note:
 //
 /////////////////////////////////////////////////////////////////////////////////////
-HashTable *Nessie::routine_get_kmers_k_triplex_gap(size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine, size_t start, size_t end){	//size_t check = 0;
+HashTable *Nessie::routine_get_kmers_k_triplex_gap(size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine, size_t start, size_t end){
+
+	// Collecting hits into an HashTable
+	HashTableSink sink(false);
+	Nessie::routine_scan_kmers_k_triplex_gap(k, max_mm, max_gap, max_gapmm, max_purine, start, end, sink);
+
+	return sink.release_hash_table_ptr();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_kmers_k_triplex_gap -- delivers to sink the hits (kmers of length k with with triplex forming potential in the interval),
+//							   		   allows gap presence
+//
+//	parameters:
+//		k - length of the kmers searched
+//		max_mm - maximum number of mismatch allowed
+//		max_gap - max number of gaps allowed
+//		max_purine - max number of non-purines allowed
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		sink - HitSink that receives the hits
+//
+//	note:
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_kmers_k_triplex_gap(size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine, size_t start, size_t end, HitSink &sink){	//size_t check = 0;
 
 	// Some variables
 	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
 	if (k > (end - start + 1)){ throw std::invalid_argument("Get triplex k gap: k is longer than the sequence interval"); }
 
-	// Initializing HashTable
-	HashTable *hash_table_ptr = new HashTable(false);
-
 	// Defining bytes necessary to store the kmer
 	size_t dna_bytes = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
 
@@ -3581,42 +5337,36 @@ HashTable *Nessie::routine_get_kmers_k_triplex_gap(size_t k, size_t max_mm, size
 	uint8_t *mask_kmer_ptr = mask_kmer;
 	std::memset(mask_kmer, 0, dna_bytes);
 
+	// Defining the alignment, reused for every window
+	kmer_alignment *alignment_ptr = workspace.get_alignment(k);
+
 	// Initializing mask for the first kmer of length k in the interval
 	Nessie::routine_init_mask(mask_kmer_ptr, k, start);
-	std::vector<bool> *align_vector_ptr = new std::vector<bool>;
 
-	// Check mirror simmetry for the first kmer
-	if (Nessie::routine_check_triplex_forming_gap(mask_kmer_ptr, align_vector_ptr, k, max_mm, max_gap, max_gapmm, max_purine)){
-		Kmer *kmer_ptr = new Kmer(k);	// defining ptr to new Kmer object
-		copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_ptr, dna_bytes);
-		kmer_ptr->indexes.push_back(start);
-		kmer_ptr->counts += 1;
-		kmer_ptr->alignment_ptr = align_vector_ptr;
-		hash_table_ptr->insert_kmer(kmer_ptr);	// adding Kmer to the HashTable
+	// Counting purines for the first kmer, the counts then slide with the kmer
+	size_t purine_c = 0;
+	for (size_t j = start; j < (start + k); ++j){
+		purine_c += Nessie::routine_is_purine(j);
 	}
-	else{
-		delete align_vector_ptr;
+
+	// Check mirror simmetry for the first kmer, composition is checked first
+	if (Nessie::routine_check_purine(purine_c, k, max_purine) && Nessie::routine_check_global_alignment(mask_kmer_ptr, alignment_ptr, k, max_mm, max_gap, max_gapmm, 0)){
+		sink.add_hit(start, k, mask_kmer_ptr, dna_bytes, alignment_ptr);
 	}
 
 	// Sliding by one base at each iteration to get successive kmers and checking their simmetry
+	nessie_progress.begin_pass(offset, start, end);
 	for (size_t i = (start + 1); i <= (end - k + 1); ++i){
+		nessie_progress.update(i);
 		Nessie::routine_shift_mask(mask_kmer_ptr, dna_bytes, k, i);
-		std::vector<bool> *align_vector_ptr_i = new std::vector<bool>;
-
-		if (Nessie::routine_check_triplex_forming_gap(mask_kmer_ptr, align_vector_ptr_i, k, max_mm, max_gap, max_gapmm, max_purine)){		//++check;
-			Kmer *kmer_ptr = new Kmer(k);
-			copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_ptr, dna_bytes);
-			kmer_ptr->indexes.push_back(i);
-			kmer_ptr->counts += 1;
-			kmer_ptr->alignment_ptr = align_vector_ptr_i;
-			hash_table_ptr->insert_kmer(kmer_ptr);
-		}
-		else {
-			delete align_vector_ptr_i;
+		purine_c += Nessie::routine_is_purine(i + k - 1);
+		purine_c -= Nessie::routine_is_purine(i - 1);
+
+		if (Nessie::routine_check_purine(purine_c, k, max_purine) && Nessie::routine_check_global_alignment(mask_kmer_ptr, alignment_ptr, k, max_mm, max_gap, max_gapmm, 0)){		//++check;
+			sink.add_hit(i, k, mask_kmer_ptr, dna_bytes, alignment_ptr);
 		}
 	}
 	//std::cout << "CHECK " << check << std::endl;
-	return hash_table_ptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -3635,162 +5385,35 @@ HashTable *Nessie::routine_get_kmers_k_triplex_gap(size_t k, size_t max_mm, size
 //	note:
 //
 /////////////////////////////////////////////////////////////////////////////////////
-HashTable *Nessie::routine_get_max_kmer_triplex(size_t k_max, size_t k_min, size_t modulo, size_t modulo_purine, size_t start, size_t end){	//size_t check = 0;
-
-	// Some variables
-	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
-	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get max triplex: max_k is longer than the sequence interval"); }
-
-	// Variables
-	bool added;
-	size_t added_end = 0;
-
-	// Initializing HashTable
-	HashTable *hash_table_ptr = new HashTable(false);
-
-	// Creating BIT_ARRAY to store monomers indexes for the mask
-	BIT_ARRAY *monomer_bitarray[4];
-	BIT_ARRAY **monomer_bitarray_ptr = monomer_bitarray;
-	for (size_t i = 0; i < 4; ++i){
-		monomer_bitarray_ptr[i] = bit_array_create(k_max);
-	}
-
-	// Defining bytes necessary to store the kmer
-	size_t dna_bytes = (k_max >> 2) + (0 != (k_max & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
-
-	// Defining the mask to encode the kmer
-	uint8_t mask_kmer[dna_bytes];
-	uint8_t *mask_kmer_ptr = mask_kmer;
-	std::memset(mask_kmer, 0, dna_bytes);
-
-	// Initializing mask for the first kmer of length max_k in the interval
-	Nessie::routine_init_bitarray_and_mask(monomer_bitarray_ptr, mask_kmer_ptr, k_max, start);
-
-	size_t k = k_max;
-	size_t end_i = start + k - 1;
-	while (k >= k_min){
-		size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
-		size_t max_purine = (modulo_purine) ? (k * modulo_purine) / 100 : 0;
-		if (Nessie::routine_check_triplex_forming_interval(monomer_bitarray_ptr, k_max, max_mm, max_purine, 0, k - 1)){	//++check;
-			Kmer *kmer_ptr = new Kmer(k);
-			added_end = end_i;
-
-			// Defining bytes necessary to store the kmer k
-			size_t dna_bytes_k = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
-
-			// Defining the mask to encode the kmer k
-			uint8_t mask_kmer_k[dna_bytes_k];
-			uint8_t *mask_kmer_k_ptr = mask_kmer_k;
-			std::memset(mask_kmer_k, 0, dna_bytes_k);
-
-			// Initializing mask for the first kmer of length k in the interval
-			Nessie::routine_init_mask(mask_kmer_k_ptr, k, start);
-
-			copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-			kmer_ptr->indexes.push_back(start);
-			kmer_ptr->counts += 1;
-			hash_table_ptr->insert_kmer_var_len(kmer_ptr);
-			break;
-		}
-	--k;
-	--end_i;
-	}
-
-	// Sliding by one base at each iteration to get successive kmers and checking their simmetry
-	size_t last_i = start + 1;
-	for (size_t i = (start + 1); i <= (end - k_max + 1); ++i){
-		Nessie::routine_shift_bitarray_and_mask(monomer_bitarray_ptr, mask_kmer_ptr, dna_bytes, k_max, i);
-
-		size_t k = k_max;
-		size_t end_i = i + k - 1;
-		while ((k >= k_min) && (end_i > added_end)){
-			size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
-			size_t max_purine = (modulo_purine) ? (k * modulo_purine) / 100 : 0;
-			if (Nessie::routine_check_triplex_forming_interval(monomer_bitarray_ptr, k_max, max_mm, max_purine, 0, k - 1)){	//++check;
-				Kmer *kmer_ptr = new Kmer(k);
-				added_end = end_i;
-
-				// Defining bytes necessary to store the kmer k
-				size_t dna_bytes_k = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
-
-				// Defining the mask to encode the kmer k
-				uint8_t mask_kmer_k[dna_bytes_k];
-				uint8_t *mask_kmer_k_ptr = mask_kmer_k;
-				std::memset(mask_kmer_k, 0, dna_bytes_k);
-
-				// Initializing mask for the first kmer of length k in the interval
-				Nessie::routine_init_mask(mask_kmer_k_ptr, k, i);
-
-				copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-				kmer_ptr->indexes.push_back(i);
-				kmer_ptr->counts += 1;
-				hash_table_ptr->insert_kmer_var_len(kmer_ptr);
-				break;
-			}
-		--k;
-		--end_i;
-		}
-		last_i = i;
-	}
-
-	// Check last interval that may be shorter than k_max and skipped in previous for loop
-	size_t last_interval_length = end - last_i;
-	if (last_interval_length >= k_min){
+HashTable *Nessie::routine_get_max_kmer_triplex(size_t k_max, size_t k_min, size_t modulo, size_t modulo_purine, size_t start, size_t end){
 
-		// Defining bytes necessary to store the last interval kmer
-		size_t dna_bytes_l = (last_interval_length >> 2) + (0 != (last_interval_length & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
-
-		// Creating BIT_ARRAY to store monomers indexes for the mask
-		BIT_ARRAY *monomer_bitarray_l[4];
-		BIT_ARRAY **monomer_bitarray_l_ptr = monomer_bitarray_l;
-		for (size_t i = 0; i < 4; ++i){
-			monomer_bitarray_l_ptr[i] = bit_array_create(last_interval_length);
-		}
-
-		// Defining the mask to encode the last interval kmer
-		uint8_t mask_kmer_l[dna_bytes_l];
-		uint8_t *mask_kmer_l_ptr = mask_kmer_l;
-		std::memset(mask_kmer_l, 0, dna_bytes_l);
-
-		// Initializing mask for the last interval kmer
-		Nessie::routine_init_bitarray_and_mask(monomer_bitarray_l_ptr, mask_kmer_l_ptr, last_interval_length, last_i + 1);
-
-		for (size_t i = 0; i <= (last_interval_length - k_min); ++i){
-
-			size_t k = last_interval_length - i;
-			size_t end_i = last_interval_length - 1; //std::cout << i << " " << k << std::endl;
-			while ((k >= k_min) && ((last_i + 1 + i + k - 1) > added_end)){ //std::cout << "- " << i << " " << end_i << " " << k << std::endl;
-				size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
-				size_t max_purine = (modulo_purine) ? (k * modulo_purine) / 100 : 0;
-				if (Nessie::routine_check_triplex_forming_interval(monomer_bitarray_l_ptr, last_interval_length, max_mm, max_purine, i, end_i)){	//++check;
-					Kmer *kmer_ptr = new Kmer(k);
-					added_end = last_i + 1 + i + k - 1;
-
-					// Defining bytes necessary to store the kmer k
-					size_t dna_bytes_k = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
+	// Collecting hits into an HashTable
+	HashTableSink sink(true);
+	Nessie::routine_scan_max_kmer_triplex(k_max, k_min, modulo, modulo_purine, start, end, sink);
 
-					// Defining the mask to encode the kmer k
-					uint8_t mask_kmer_k[dna_bytes_k];
-					uint8_t *mask_kmer_k_ptr = mask_kmer_k;
-					std::memset(mask_kmer_k, 0, dna_bytes_k);
-
-					// Initializing mask for the first kmer of length k in the interval
-					Nessie::routine_init_mask(mask_kmer_k_ptr, k, last_i + 1 + i);
+	return sink.release_hash_table_ptr();
+}
 
-					copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-					kmer_ptr->indexes.push_back(last_i + 1 + i);
-					kmer_ptr->counts += 1;
-					hash_table_ptr->insert_kmer_var_len(kmer_ptr);
-					break;
-				}
-			--k;
-			--end_i;
-			}
-		}
-	}
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_max_kmer_triplex -- delivers to sink the hits (longest kmers of maximum length max_k and minimum length min_k with triplex
+//									forming potential in the interval)
+//
+//	parameters:
+//		max_k - max length of the kmers searched
+//		min_k - min length of the kmers searched
+//		modulo - max mismatch allowed are calculated as integer division k / modulo
+//		modulo_purine - max number on non-purines allowed are calculated as integer division k / modulo_purine
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		sink - HitSink that receives the hits
+//
+//	note: the search starts only from the indexes that can start a kmer with the composition for triplex (routine_scan_max_kmer_triplex_seed)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_max_kmer_triplex(size_t k_max, size_t k_min, size_t modulo, size_t modulo_purine, size_t start, size_t end, HitSink &sink){
 
-	//std::cout << "CHECK " << check << std::endl;
-	return hash_table_ptr;
+	Nessie::routine_scan_max_kmer_triplex_seed(k_max, k_min, modulo, 0, 0, modulo_purine, start, end, sink);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -3810,88 +5433,97 @@ HashTable *Nessie::routine_get_max_kmer_triplex(size_t k_max, size_t k_min, size
 //	note:
 //
 /////////////////////////////////////////////////////////////////////////////////////
-HashTable *Nessie::routine_get_max_kmer_triplex_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, size_t start, size_t end){	//size_t check = 0;
-
-	// Some variables
-	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
-	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get max triplex gap: max_k is longer than the sequence interval"); }
+HashTable *Nessie::routine_get_max_kmer_triplex_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, size_t start, size_t end){
 
-	// Variables
-	bool added;
-	size_t added_end = 0;
+	// Collecting hits into an HashTable
+	HashTableSink sink(true);
+	Nessie::routine_scan_max_kmer_triplex_gap(k_max, k_min, modulo, modulo_gap, modulo_gapmm, modulo_purine, start, end, sink);
 
-	// Initializing HashTable
-	HashTable *hash_table_ptr = new HashTable(false);
+	return sink.release_hash_table_ptr();
+}
 
-	// Defining bytes necessary to store the kmer
-	size_t dna_bytes = (k_max >> 2) + (0 != (k_max & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_max_kmer_triplex_gap -- delivers to sink the hits (longest kmers of maximum length max_k and minimum length min_k with triplex
+//										forming potential in the interval), allows gap presence
+//
+//	parameters:
+//		max_k - max length of the kmers searched
+//		min_k - min length of the kmers searched
+//		modulo - max mismatch allowed are calculated as integer division k / modulo
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap
+//		modulo_purine - max number on non-purines allowed are calculated as integer division k / modulo_purine
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		sink - HitSink that receives the hits
+//
+//	note: the search starts only from the indexes that can start a kmer with the composition for triplex (routine_scan_max_kmer_triplex_seed)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_max_kmer_triplex_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, size_t start, size_t end, HitSink &sink){
 
-	// Defining the mask to encode the kmer
-	uint8_t mask_kmer[dna_bytes];
-	uint8_t *mask_kmer_ptr = mask_kmer;
-	std::memset(mask_kmer, 0, dna_bytes);
+	Nessie::routine_scan_max_kmer_triplex_seed(k_max, k_min, modulo, modulo_gap, modulo_gapmm, modulo_purine, start, end, sink);
+}
 
-	// Initializing mask for the first kmer of length max_k in the interval
-	Nessie::routine_init_mask(mask_kmer_ptr, k_max, start);
-	std::vector<bool> *align_vector_ptr = new std::vector<bool>;
-	added = false;
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_scan_max_kmer_triplex_seed -- delivers to sink the hits (longest kmers of maximum length max_k and minimum length min_k with triplex
+//										  forming potential in the interval), gaps are allowed if modulo_gap or modulo_gapmm are defined
+//
+//	parameters:
+//		max_k - max length of the kmers searched
+//		min_k - min length of the kmers searched
+//		modulo - max mismatch allowed are calculated as integer division k / modulo
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
+//		modulo_gapmm - max gaps and mismatches allowed in total are calculated as integer division k / modulo_gapmm [0]
+//		modulo_purine - max number on non-purines allowed are calculated as integer division k / modulo_purine
+//		start - starting index of the interval to search
+//		end - ending index of the interval to search
+//		sink - HitSink that receives the hits
+//
+//	note: only the seeds (routine_get_triplex_seeds) are searched, the other indexes can not start a kmer with the composition for triplex.
+//		  For each seed the kmers are extended from max_k down to min_k with sliding purine counts,
+//		  the mirror symmetry is checked only for the kmers with the right composition, using the LCE index if built.
+//		  Kmers allowing for gaps are aligned on their own mask, the alignment is the same of the sub-interval of a window of length max_k
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::routine_scan_max_kmer_triplex_seed(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, size_t start, size_t end, HitSink &sink){	//size_t check = 0;
 
-	size_t k = k_max;
-	size_t end_i = start + k - 1;
-	while (k >= k_min){
-		size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
-		size_t max_gap = (modulo_gap) ? (k * modulo_gap) / 100 : 0;
-		size_t max_gapmm = (modulo_gapmm) ? (k * modulo_gapmm) / 100 : 0;
-		size_t max_purine = (modulo_purine) ? (k * modulo_purine) / 100 : 0;
-		if (Nessie::routine_check_triplex_forming_gap_interval(mask_kmer_ptr, align_vector_ptr, k_max, max_mm, max_gap, max_gapmm, max_purine, 0, k - 1)){	//++check;
-			Kmer *kmer_ptr = new Kmer(k);
-			added_end = end_i;
+	// Some variables
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Get max triplex: max_k is longer than the sequence interval"); }
+	if (!k_min){ throw std::invalid_argument("Get max triplex: min_k must be larger than 0"); }
 
-			// Defining bytes necessary to store the kmer k
-			size_t dna_bytes_k = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
+	// Variables
+	bool gap = (modulo_gap || modulo_gapmm);
+	size_t added_end = 0;
+	bool added = false;
 
-			// Defining the mask to encode the kmer k
-			uint8_t mask_kmer_k[dna_bytes_k];
-			uint8_t *mask_kmer_k_ptr = mask_kmer_k;
-			std::memset(mask_kmer_k, 0, dna_bytes_k);
+	// Defining the alignment, reused for every kmer
+	kmer_alignment *alignment_ptr = workspace.get_alignment(k_max);
 
-			// Initializing mask for the first kmer of length k in the interval
-			Nessie::routine_init_mask(mask_kmer_k_ptr, k, start);
+	// Getting the indexes that can start a kmer with the composition for triplex
+	BIT_ARRAY *seeds_ptr = Nessie::routine_get_triplex_seeds(k_min, k_max, modulo_purine, start, end);
 
-			copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-			kmer_ptr->indexes.push_back(start);
-			kmer_ptr->counts += 1;
-			kmer_ptr->alignment_ptr = align_vector_ptr;
-			added = true;
-			hash_table_ptr->insert_kmer_var_len(kmer_ptr);
-			break;
-		}
-	--k;
-	--end_i;
-	}
+	bit_index_t seed = 0;
+	while ((seed < (end - start + 1)) && bit_array_find_next_set_bit(seeds_ptr, seed, &seed)){
+		size_t i = start + seed;
+		size_t k = (k_max < (end - i + 1)) ? k_max : (end - i + 1);	// kmers at the end of the interval are shorter than max_k
+		size_t end_i = i + k - 1;
+		++seed;
 
-	if (!added){
-		delete align_vector_ptr;
-	}
+		if (added && (end_i <= added_end)){ continue; }
 
-	// Sliding by one base at each iteration to get successive kmers and checking their simmetry
-	size_t last_i = start + 1;
-	for (size_t i = (start + 1); i <= (end - k_max + 1); ++i){
-		Nessie::routine_shift_mask(mask_kmer_ptr, dna_bytes, k_max, i);
-		std::vector<bool> *align_vector_ptr_i = new std::vector<bool>;
-		added = false;
+		// Counting purines for the longest kmer, the counts are then reduced with k
+		size_t purine_k = 0;
+		for (size_t j = i; j <= end_i; ++j){
+			purine_k += Nessie::routine_is_purine(j);
+		}
 
-		size_t k = k_max;
-		size_t end_i = i + k - 1;
-		while ((k >= k_min) && (end_i > added_end)){
+		while ((k >= k_min) && (!added || (end_i > added_end))){
 			size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
-			size_t max_gap = (modulo_gap) ? (k * modulo_gap) / 100 : 0;
-			size_t max_gapmm = (modulo_gapmm) ? (k * modulo_gapmm) / 100 : 0;
 			size_t max_purine = (modulo_purine) ? (k * modulo_purine) / 100 : 0;
-			if (Nessie::routine_check_triplex_forming_gap_interval(mask_kmer_ptr, align_vector_ptr_i, k_max, max_mm, max_gap, max_gapmm, max_purine, 0, k - 1)){	//++check;
-				Kmer *kmer_ptr = new Kmer(k);
-				added_end = end_i;
-
+			if (Nessie::routine_check_purine(purine_k, k, max_purine)){
 				// Defining bytes necessary to store the kmer k
 				size_t dna_bytes_k = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
 
@@ -3900,88 +5532,41 @@ HashTable *Nessie::routine_get_max_kmer_triplex_gap(size_t k_max, size_t k_min,
 				uint8_t *mask_kmer_k_ptr = mask_kmer_k;
 				std::memset(mask_kmer_k, 0, dna_bytes_k);
 
-				// Initializing mask for the first kmer of length k in the interval
-				Nessie::routine_init_mask(mask_kmer_k_ptr, k, i);
-
-				copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-				kmer_ptr->indexes.push_back(i);
-				kmer_ptr->counts += 1;
-				kmer_ptr->alignment_ptr = align_vector_ptr_i;
-				added = true;
-				hash_table_ptr->insert_kmer_var_len(kmer_ptr);
-				break;
-			}
-		--k;
-		--end_i;
-		}
-		last_i = i;
-
-		if (!added){
-			delete align_vector_ptr_i;
-		}
-	}
-
-	// Check last interval that may be shorter than k_max and skipped in previous for loop
-	size_t last_interval_length = end - last_i;
-	if (last_interval_length >= k_min){
-
-		// Defining bytes necessary to store the last interval kmer
-		size_t dna_bytes_l = (last_interval_length >> 2) + (0 != (last_interval_length & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
-
-		// Defining the mask to encode the last interval kmer
-		uint8_t mask_kmer_l[dna_bytes_l];
-		uint8_t *mask_kmer_l_ptr = mask_kmer_l;
-		std::memset(mask_kmer_l, 0, dna_bytes_l);
-
-		// Initializing mask for the last interval kmer
-		Nessie::routine_init_mask(mask_kmer_l_ptr, last_interval_length, last_i + 1);
-
-		for (size_t i = 0; i <= (last_interval_length - k_min); ++i){
-			std::vector<bool> *align_vector_ptr_l = new std::vector<bool>;
-			added = false;
-
-			size_t k = last_interval_length - i;
-			size_t end_i = last_interval_length - 1; //std::cout << i << " " << k << std::endl;
-			while ((k >= k_min) && ((last_i + 1 + i + k - 1) > added_end)){ //std::cout << "- " << i << " " << end_i << " " << k << std::endl;
-					size_t max_mm = (modulo) ? (k * modulo) / 100 : 0;
+				bool found = false;
+				if (gap){
 					size_t max_gap = (modulo_gap) ? (k * modulo_gap) / 100 : 0;
 					size_t max_gapmm = (modulo_gapmm) ? (k * modulo_gapmm) / 100 : 0;
-					size_t max_purine = (modulo_purine) ? (k * modulo_purine) / 100 : 0;
-				if (Nessie::routine_check_triplex_forming_gap_interval(mask_kmer_l_ptr, align_vector_ptr_l, last_interval_length, max_mm, max_gap, max_gapmm, max_purine, i, end_i)){	//++check;
-					Kmer *kmer_ptr = new Kmer(k);
-					added_end = last_i + 1 + i + k - 1;
-
-					// Defining bytes necessary to store the kmer k
-					size_t dna_bytes_k = (k >> 2) + (0 != (k & ((1 << 2) - 1)));	// (k / 4) + (0 != (k % 4))
+					Nessie::routine_init_mask(mask_kmer_k_ptr, k, i);
+					found = Nessie::routine_check_global_alignment_interval(mask_kmer_k_ptr, alignment_ptr, k, max_mm, max_gap, max_gapmm, 0, 0, k - 1);
+				}
+				else if (lce_forward_ptr){
+					found = Nessie::routine_check_symmetry_lce(i, k, max_mm, 0);
+				}
+				else{
+					found = Nessie::routine_check_mirror_symmetry_string(i, k, max_mm);
+				}
 
-					// Defining the mask to encode the kmer k
-					uint8_t mask_kmer_k[dna_bytes_k];
-					uint8_t *mask_kmer_k_ptr = mask_kmer_k;
-					std::memset(mask_kmer_k, 0, dna_bytes_k);
+				if (found){	//++check;
+					added_end = end_i;
+					added = true;
 
-					// Initializing mask for the first kmer of length k in the interval
-					Nessie::routine_init_mask(mask_kmer_k_ptr, k, last_i + 1 + i);
+					// Initializing mask for the kmer of length k at index i
+					if (!gap){
+						Nessie::routine_init_mask(mask_kmer_k_ptr, k, i);
+					}
 
-					copy_uint8_t_arry(kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, mask_kmer_k_ptr, dna_bytes_k);
-					kmer_ptr->indexes.push_back(last_i + 1 + i);
-					kmer_ptr->counts += 1;
-					kmer_ptr->alignment_ptr = align_vector_ptr_l;
-					added = true;
-					hash_table_ptr->insert_kmer_var_len(kmer_ptr);
+					sink.add_hit(i, k, mask_kmer_k_ptr, dna_bytes_k, (gap) ? alignment_ptr : NULL);
 					break;
 				}
-			--k;
-			--end_i;
-			}
-
-			if (!added){
-				delete align_vector_ptr_l;
 			}
+		purine_k -= Nessie::routine_is_purine(end_i);
+		--k;
+		--end_i;
 		}
 	}
 
+	bit_array_free(seeds_ptr);
 	//std::cout << "CHECK " << check << std::endl;
-	return hash_table_ptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -4011,26 +5596,14 @@ LinkedlistKmer *Nessie::get_kmers_triplex_gap(size_t k_min, size_t k_max, size_t
 
 	// Initializing LinkedlistKmer
 	LinkedlistKmer *ll_kmer_ptr = new LinkedlistKmer;
-	HashTable *hash_table_ptr;
 
-	// Check range k_min..k_max
-	for (size_t i = k_min; i <= k_max; ++i){
-		size_t max_mm = (modulo) ? (i * modulo) / 100 : 0;
-		size_t max_gap = (modulo_gap) ? (i * modulo_gap) / 100 : 0;
-		size_t max_gapmm = (modulo_gapmm) ? (i * modulo_gapmm) / 100 : 0;
-		size_t max_purine = (modulo_purine) ? (i * modulo_purine) / 100 : 0;
-
-		// Check if gaps allowed or not
-		if (max_gap || max_gapmm){
-			hash_table_ptr = Nessie::routine_get_kmers_k_triplex_gap(i, max_mm, max_gap, max_gapmm, max_purine, start, end);
-		}
-		else{
-			hash_table_ptr = Nessie::routine_get_kmers_k_triplex(i, max_mm, max_purine, start, end);
-		}
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	HashTableSink sink(true);
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, modulo_gap, modulo_gapmm, modulo_purine, start, end, 2, sink);
 
-		// Add to LinkedlistKmer
-		hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
-	}
+	// Add to LinkedlistKmer
+	HashTable *hash_table_ptr = sink.release_hash_table_ptr();
+	hash_table_ptr->append_to_LinkedlistKmer(ll_kmer_ptr);
 
 	return ll_kmer_ptr;
 }
@@ -4078,6 +5651,102 @@ LinkedlistKmer *Nessie::get_max_kmers_triplex_gap(size_t k_max, size_t k_min, si
 	return ll_kmer_ptr;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	scan_kmers_triplex_gap -- delivers to sink all the Kmers with triplex forming potential of length [k_min..k_max] in the interval as they are found,
+//							  allows for gaps
+//
+//	parameters:
+//		sink - HitSink that receives the hits
+//		k_min - minimum length of the kmers searched
+//		k_max - maximum length of the kmers searched [0]
+//		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
+//		modulo_purine - max number on non-purines allowed are calculated as integer division k / modulo_purine [0]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+//	note: hits are not aggregated, the same kmer is delivered once for every index it is found at,
+//		  the interval is scanned only once for all the lengths
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::scan_kmers_triplex_gap(HitSink &sink, size_t k_min, size_t k_max, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, size_t start, size_t end){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Scan triplexes: starting index is larger than ending index"); }
+	if (!k_max){ k_max = k_min; }	// if k_max is not defined it is set to default as k_min, only kmers of length k_min are searched
+	if (k_min > k_max){ throw std::invalid_argument("Scan triplexes: k_min is larger than k_max"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Scan triplexes: k_max is longer than the sequence interval"); }
+
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, modulo_gap, modulo_gapmm, modulo_purine, start, end, 2, sink);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	scan_max_kmers_triplex_gap -- delivers to sink all the maximum Kmers with triplex forming potential (maximum length max_k and minimum length min_k)
+//								  in the interval as they are found, allows for gaps
+//
+//	parameters:
+//		sink - HitSink that receives the hits
+//		max_k - max length of the kmers searched
+//		min_k - min length of the kmers searched [0]
+//		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
+//		modulo_purine - max number on non-purines allowed are calculated as integer division k / modulo_purine [0]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+//	note: hits are delivered in ascending order of index
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::scan_max_kmers_triplex_gap(HitSink &sink, size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, size_t start, size_t end){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Scan max triplexes: starting index is larger than ending index"); }
+	if (!k_min){ k_min = k_max; }	// if min_k is not defined it is set to default as max_k, only kmers of length max_k are searched
+	if (k_min > k_max){ throw std::invalid_argument("Scan max triplexes: min_k is larger than max_k"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Scan max triplexes: max_k is longer than the sequence interval"); }
+
+	// Check if gaps allowed or not
+	if (modulo_gap || modulo_gapmm){
+		Nessie::routine_scan_max_kmer_triplex_gap(k_max, k_min, modulo, modulo_gap, modulo_gapmm, modulo_purine, start, end, sink);
+	}
+	else{
+		Nessie::routine_scan_max_kmer_triplex(k_max, k_min, modulo, modulo_purine, start, end, sink);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	scan_sorted_kmers_triplex_gap -- delivers to sink all the Kmers with triplex forming potential of length [k_min..k_max] in the interval in ascending order of index,
+//									 allows for gaps
+//
+//	parameters:
+//		sink - HitSink that receives the hits
+//		k_min - minimum length of the kmers searched
+//		k_max - maximum length of the kmers searched [0]
+//		modulo - max mismatch are calculated as integer division k / modulo, if 0 then max_mm is set to 0 [0]
+//		modulo_gap - max gaps allowed are calculated as integer division k / modulo_gap [0]
+//		modulo_purine - max number on non-purines allowed are calculated as integer division k / modulo_purine [0]
+//		start - starting index of the interval to search [0]
+//		end - ending index of the interval to search [0]
+//
+//	note: same hits and order of scan_kmers_triplex_gap, the order is part of the contract of this function,
+//		  hits for the same index are delivered in ascending order of length
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void Nessie::scan_sorted_kmers_triplex_gap(HitSink &sink, size_t k_min, size_t k_max, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, size_t start, size_t end){
+
+	if (!end){ end = (string_bit_ptr->data_len) - 1; }	// if end is not defined it is set to default as the end of the string
+	if (start > end){ throw std::invalid_argument("Scan sorted triplexes: starting index is larger than ending index"); }
+	if (!k_max){ k_max = k_min; }	// if k_max is not defined it is set to default as k_min, only kmers of length k_min are searched
+	if (k_min > k_max){ throw std::invalid_argument("Scan sorted triplexes: k_min is larger than k_max"); }
+	if (k_max > (end - start + 1)){ throw std::invalid_argument("Scan sorted triplexes: k_max is longer than the sequence interval"); }
+
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, modulo_gap, modulo_gapmm, modulo_purine, start, end, 2, sink);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 //
 //	print_kmers_triplex_gap -- prints all the Kmers with triplex forming potential of length [k_min..k_max] in the interval,
@@ -4107,32 +5776,16 @@ void Nessie::print_kmers_triplex_gap(size_t k_min, size_t k_max, size_t modulo,
 	if (k_min > k_max){ throw std::invalid_argument("Print triplexes: k_min is larger than k_max"); }
 	if (k_max > (end - start + 1)){ throw std::invalid_argument("Print triplexes: k_max is longer than the sequence interval"); }
 
-	// Variables
-	HashTable *hash_table_ptr;
-
-	// Check range k_min..k_max
-	for (size_t i = k_min; i <= k_max; ++i){
-		size_t max_mm = (modulo) ? (i * modulo) / 100 : 0;
-		size_t max_gap = (modulo_gap) ? (i * modulo_gap) / 100 : 0;
-		size_t max_gapmm = (modulo_gapmm) ? (i * modulo_gapmm) / 100 : 0;
-		size_t max_purine = (modulo_purine) ? (i * modulo_purine) / 100 : 0;
-
-		// Check if gaps allowed or not
-		if (max_gap || max_gapmm){
-			hash_table_ptr = Nessie::routine_get_kmers_k_triplex_gap(i, max_mm, max_gap, max_gapmm, max_purine, start, end);
-		}
-		else{
-			hash_table_ptr = Nessie::routine_get_kmers_k_triplex(i, max_mm, max_purine, start, end);
-		}
+	// Scanning the interval once for all the lengths in range k_min..k_max
+	HashTableSink sink(true);
+	Nessie::routine_scan_sorted_kmers(k_min, k_max, modulo, modulo_gap, modulo_gapmm, modulo_purine, start, end, 2, sink);
 
-		// Printing
-		if (!start_idx){
-			hash_table_ptr->print_table(fout, counts, indexes);
-		}
-		else{
-			hash_table_ptr->print_table_shifted_indexes(start_idx, fout, counts, indexes);
-		}
-		delete hash_table_ptr;	// need to delete the HashTable at each iteration otherwise too much memory is used
+	// Printing
+	if (!start_idx){
+		sink.get_hash_table_ptr()->print_table(fout, counts, indexes);
+	}
+	else{
+		sink.get_hash_table_ptr()->print_table_shifted_indexes(start_idx, fout, counts, indexes);
 	}
 }
 
@@ -65,6 +65,11 @@
 #include <vector>
 #endif /* __VECTOR_H_INCLUDED */
 
+#ifndef __ALGORITHM_H_INCLUDED
+#define __ALGORITHM_H_INCLUDED
+#include <algorithm>
+#endif /* __ALGORITHM_H_INCLUDED */
+
 #ifndef __LIST_H_INCLUDED
 #define __LIST_H_INCLUDED
 #include <list>
@@ -85,6 +90,16 @@
 #include "HashTable.h"
 #endif /* __HASHTABLE_H_INCLUDED */
 
+#ifndef __HITSINK_H_INCLUDED
+#define __HITSINK_H_INCLUDED
+#include "HitSink.h"
+#endif /* __HITSINK_H_INCLUDED */
+
+#ifndef __KMERCOUNTER_H_INCLUDED
+#define __KMERCOUNTER_H_INCLUDED
+#include "KmerCounter.h"
+#endif /* __KMERCOUNTER_H_INCLUDED */
+
 #ifndef __BITSCAN_H_INCLUDED
 #define __BITSCAN_H_INCLUDED
 #include "bitscan/bitscan.h"
@@ -139,14 +154,86 @@ struct dna_bitset{
     double *array_frequencies_LOW_ptr;	// ptr to size_t array that stores counts frequencies of lower case bases, p = base count / string length
 };
 
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS EncodedSequence DEFINITION
+//		EncodedSequence -- class constructor, encodes a DNA string once, non-canonical bases are marked in a bit set
+//		~EncodedSequence -- class destructor
+//
+//		get_start -- returns the index of the first base encoded
+//		get_end -- returns the index of the last base encoded
+//		check_unknown -- returns true if there are non-canonical bases in an interval
+//		find_unknown -- returns the index of the first non-canonical base in an interval
+//		count_lower -- counts the lower case bases in an interval
+//		copy_interval -- copies the encoding of an interval into a uint8_t array, the interval starts at the first base of the array
+//
+//	note: the indexes are the indexes in the original DNA string, the sub-intervals without non-canonical bases
+//		  can be used to build any number of Nessie objects without encoding the string again
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class EncodedSequence{
+
+private:
+	uint8_t *data_ptr;	// ptr to the uint8_t array that stores the DNA string encoded as bit, non-canonical bases are encoded as A
+	uint64_t *unknown_ptr;	// ptr to a bit set of length n bit, bits are set to 1 for non-canonical bases
+	uint64_t *lower_ptr;	// ptr to a bit set of length n bit, bits are set to 1 for lower case bases
+	size_t start;	// index of the first base encoded
+	size_t data_len;	// number of bases encoded
+public:
+	EncodedSequence(const char *dna_str_ptr, size_t dna_str_len, size_t start = 0, size_t end = 0);
+	~EncodedSequence();
+	size_t get_start();
+	size_t get_end();
+	bool check_unknown(size_t start, size_t end);
+	size_t find_unknown(size_t start, size_t end);
+	void count_lower(size_t start, size_t end, size_t *counts_ptr);
+	void copy_interval(uint8_t *array_ptr, size_t start, size_t end);
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS ScanWorkspace DEFINITION
+//		ScanWorkspace -- class constructor, no buffer is allocated until requested
+//		~ScanWorkspace -- class destructor
+//
+//		get_scoring_matrix -- returns a ptr to a scoring matrix of (l + 1) * (l + 1) elements, values are not initialized
+//		get_monomer_bitarrays -- returns a ptr to a set of 4 BIT_ARRAY of length k bit set to 0
+//		get_alignment -- returns a ptr to a kmer_alignment that can store the alignment of two sequences of length l
+//
+//	note: the buffers are grown when needed and reused by every scan, so the scans do not allocate
+//		  memory for each window or length. A workspace is not shared, every Nessie owns its own
+//		  and must be scanned by a single thread at a time
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class ScanWorkspace{
+
+private:
+	long *scoring_ptr;	// ptr to the scoring matrix for the alignments
+	size_t scoring_len;	// number of elements allocated for the scoring matrix
+	BIT_ARRAY *monomer_bitarray[2][4];	// two sets of BIT_ARRAY to store the monomers indexes of a kmer, NULL until requested
+	kmer_alignment alignment;	// alignment of the last kmer checked
+	size_t alignment_bytes;	// number of uint8_t allocated for the alignment operations
+
+	ScanWorkspace(const ScanWorkspace &);	// not copyable
+	ScanWorkspace &operator=(const ScanWorkspace &);
+public:
+	ScanWorkspace();
+	~ScanWorkspace();
+	long *get_scoring_matrix(size_t l);
+	BIT_ARRAY **get_monomer_bitarrays(size_t k, size_t set = 0);
+	kmer_alignment *get_alignment(size_t l);
+};
+
 /////////////////////////////////////////////////////////////////////////////////////
 //
 //	CLASS Nessie DEFINITION
 //		Nessie -- class constructor for encoding DNA and build data structure if needed, non-canonical bases throws an error
 //		Nessie -- class constructor used only to build data structure, non-canonical bases are skipped
+//		Nessie -- class constructor for an interval of an EncodedSequence, the DNA string is not encoded again, non-canonical bases throws an error
 //		~Nessie -- class destructor
 //
 //		get_indexes_checked_ptr -- returns a ptr to the bitarray that stores indexes informations on kmers checked
+//		get_length -- returns the length of the DNA string stored
 //
 //		to_string -- converts the DNA stored as bit in the dna_bitset structure back to a upper case string, returns a ptr to the char array containing the DNA string
 //		print_interval_to_string --	prints the DNA stored as bit in the dna_bitset structure as string for an interval
@@ -167,6 +254,17 @@ struct dna_bitset{
 //		print_kmers_palindrome_gap --
 //		print_max_kmers_palindrome_gap --
 //		print_kmers -- prints all the Kmers of length [k_min..k_max] in the interval
+//		scan_kmers_mirror_gap -- delivers to a HitSink all the Kmers with mirror symmetry of length [k_min..k_max] in the interval as they are found, allows for gaps
+//		scan_max_kmers_mirror_gap -- delivers to a HitSink all the maximum Kmers with mirror symmetry (maximum length max_k and minimum length min_k) in the interval as they are found, allows for gaps
+//		scan_kmers_palindrome_gap -- delivers to a HitSink all the Kmers with palindrome symmetry of length [k_min..k_max] in the interval as they are found, allows for gaps
+//		scan_max_kmers_palindrome_gap -- delivers to a HitSink all the maximum Kmers with palindrome symmetry (maximum length max_k and minimum length min_k) in the interval as they are found, allows for gaps
+//		scan_sorted_kmers_mirror_gap -- delivers to a HitSink all the Kmers with mirror symmetry of length [k_min..k_max] in the interval in ascending order of index, allows for gaps
+//		scan_sorted_kmers_palindrome_gap -- delivers to a HitSink all the Kmers with palindrome symmetry of length [k_min..k_max] in the interval in ascending order of index, allows for gaps
+//		scan_kmers -- delivers to a HitSink all the Kmers of length [k_min..k_max] in the interval as they are found
+//		print_kmers_canonical -- prints all the canonical Kmers of length [k_min..k_max] on both strands in the interval
+//		scan_kmers_canonical -- delivers to a HitSink all the canonical Kmers of length [k_min..k_max] on both strands in the interval as they are found
+//		scan_kmers_keys -- adds to a KmerCounter the keys for all the kmers in the interval, no positions are stored
+//		build_lce_index -- builds the index used to check mirrors, palindromes and triplexes with mismatches by longest common extensions
 //
 //		shannon_entropy_interval -- returns the Shannon entropy score for an interval
 //		print_shannon_entropy_interval --
@@ -177,10 +275,17 @@ struct dna_bitset{
 //		linguistic_complexity_sliding -- returns a ptr to a std::vector<double> storing the Linguistic complexity for a sliding interval
 //		print_linguistic_complexity_sliding --
 //
+//		get_quadruplexes -- returns a ptr to a LinkedlistKmer that stores all the tracts with G4-DNA forming potential on both strands in the interval
+//		print_quadruplexes --
+//		scan_quadruplexes -- delivers to a HitSink all the tracts with G4-DNA forming potential on both strands in the interval in ascending order of index
+//
 //		get_kmers_triplex_gap -- returns a ptr to a LinkedlistKmer that stores all the Kmers with triplex forming potential of length [k_min..k_max] in the interval, allows for gaps
 //		print_kmers_triplex_gap --
 //		get_max_kmers_triplex_gap -- returns a ptr to a LinkedlistKmer that stores all the maximum Kmers with with triplex forming potential (maximum length max_k and minimum length min_k) in the interval, allows for gaps
 //		print_max_kmers_triplex_gap --
+//		scan_kmers_triplex_gap -- delivers to a HitSink all the Kmers with triplex forming potential of length [k_min..k_max] in the interval as they are found, allows for gaps
+//		scan_max_kmers_triplex_gap -- delivers to a HitSink all the maximum Kmers with triplex forming potential (maximum length max_k and minimum length min_k) in the interval as they are found, allows for gaps
+//		scan_sorted_kmers_triplex_gap -- delivers to a HitSink all the Kmers with triplex forming potential of length [k_min..k_max] in the interval in ascending order of index, allows for gaps
 //
 /////////////////////////////////////////////////////////////////////////////////////
 class Nessie{
@@ -188,16 +293,25 @@ class Nessie{
 private:
 	dna_bitset string_bit;	// initializing dna_bitset structure
 	dna_bitset *string_bit_ptr;
-	sparse_bitarray *array_dimer[16];	// array to store pointers to bit sets (sparse_bitarrays) encoding indexes for dimers in the string
+	uint32_t *dimer_positions_ptr;	// ptr to the starting indexes of the dimers in the string sorted by dimer and index, NULL if the dimer index is not built
+	size_t dimer_offsets[17];	// starting indexes of dimer d are stored in dimer_positions_ptr[dimer_offsets[d]..dimer_offsets[d + 1])
 	bitarray *indexes_checked_ptr;	// ptr to a bitarray of length n bit that stores indexes information on kmers checked
 									// bits are initialized to 1 and set to 0 when a kmer starting at that index is found
+	uint64_t *lce_forward_ptr;	// ptr to the DNA string packed 32 bases per uint64_t, NULL if the LCE index is not built
+	uint64_t *lce_reverse_ptr;	// ptr to the reversed DNA string packed 32 bases per uint64_t, NULL if the LCE index is not built
+	ScanWorkspace workspace;	// scratch buffers reused by the scans
+	size_t offset;	// index in the original DNA string of the first base stored, used to report the progress
 public:
 	// Basic functions
 	Nessie(const char *dna_str_ptr, size_t dna_str_len, size_t start = 0, size_t end = 0, bool build_structure = false, bool reverse_complement = false);
 	Nessie(int, const char *dna_str_ptr, size_t dna_str_len, size_t start = 0, size_t end = 0, bool reverse_complement = false);
+	Nessie(EncodedSequence &sequence, size_t start = 0, size_t end = 0, bool build_structure = false, bool reverse_complement = false);
 	~Nessie();
-	void routine_set_array_dimer(sparse_bitarray *array_dimer[], uint8_t *dimer_mask_ptr, bool dimer_set, size_t i, size_t encode);
+	static void routine_encode_dna(const char *dna_str_ptr, size_t dna_len, uint8_t *data_ptr, size_t *counts_UP_ptr, size_t *counts_LOW_ptr, uint64_t *unknown_ptr = NULL, uint64_t *lower_ptr = NULL);
+	void routine_build_dimer_index();
+	void routine_build_dimer_positions(uint8_t *dimer_codes_ptr, size_t len);
 	bitarray *get_indexes_checked_ptr();
+	size_t get_length();
 
 	// Functions for dna_bitset
 	char *to_string();
@@ -214,8 +328,8 @@ public:
 	bool check_palindrome_symmetry(BIT_ARRAY **monomer_bitarray_ptr, size_t k, size_t max_mm);
 	bool routine_check_mirror_symmetry_interval(BIT_ARRAY **monomer_bitarray_ptr, size_t k, size_t max_mm, size_t start, size_t end, size_t mm_c = 0);
 	bool routine_check_palindrome_symmetry_interval(BIT_ARRAY **monomer_bitarray_ptr, size_t k, size_t max_mm, size_t start, size_t end, size_t mm_c = 0);
-	bool routine_check_global_alignment(uint8_t *mask_kmer_ptr, std::vector<bool> *align_vector_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, int type);
-	bool routine_check_global_alignment_interval(uint8_t *mask_kmer_ptr, std::vector<bool> *align_vector_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, int type, size_t start, size_t end);
+	bool routine_check_global_alignment(uint8_t *mask_kmer_ptr, kmer_alignment *alignment_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, int type);
+	bool routine_check_global_alignment_interval(uint8_t *mask_kmer_ptr, kmer_alignment *alignment_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, int type, size_t start, size_t end);
 	int routine_compare_bases(uint8_t *mask_kmer_ptr, size_t i, size_t j, int m, int mm);
 	int routine_compare_bases_complement(uint8_t *mask_kmer_ptr, size_t i, size_t j, int m, int mm);
 	HashTable *routine_get_kmers_k_mirror(size_t k, size_t max_mm, size_t start, size_t end);
@@ -224,10 +338,24 @@ public:
 	HashTable *routine_get_max_kmer_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end, int type);
 	HashTable *routine_get_kmers_k_palindrome(size_t k, size_t max_mm, size_t start, size_t end);
 	HashTable *routine_get_max_kmer_palindrome(size_t k_max, size_t k_min, size_t modulo, size_t start, size_t end);
+	void routine_scan_kmers_k_mirror(size_t k, size_t max_mm, size_t start, size_t end, HitSink &sink);
+	void routine_scan_max_kmer_mirror(size_t k_max, size_t k_min, size_t modulo, size_t start, size_t end, HitSink &sink);
+	void routine_scan_kmers_k_gap(size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t start, size_t end, int type, HitSink &sink);
+	void routine_scan_max_kmer_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t start, size_t end, int type, HitSink &sink);
+	void routine_scan_kmers_k_palindrome(size_t k, size_t max_mm, size_t start, size_t end, HitSink &sink);
+	void routine_scan_max_kmer_palindrome(size_t k_max, size_t k_min, size_t modulo, size_t start, size_t end, HitSink &sink);
 	void routine_init_bitarray_and_mask(BIT_ARRAY **monomer_bitarray_ptr, uint8_t *mask_kmer_ptr, size_t k, size_t start);
 	void routine_init_mask(uint8_t *mask_kmer_ptr, size_t k, size_t start);
 	void routine_shift_bitarray_and_mask(BIT_ARRAY **monomer_bitarray_ptr, uint8_t *mask_kmer_ptr, size_t mask_kmer_len, size_t k, size_t i);
 	void routine_shift_mask(uint8_t *mask_kmer_ptr, size_t mask_kmer_len, size_t k, size_t i);
+	void routine_scan_sorted_kmers(size_t k_min, size_t k_max, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, size_t start, size_t end, int type, HitSink &sink);
+	void routine_get_center_arms(size_t *arm_ptr, size_t start, size_t end, int type);
+	void routine_scan_max_kmer_center(size_t k_max, size_t k_min, size_t start, size_t end, int type, HitSink &sink);
+	void build_lce_index();
+	uint64_t routine_get_lce_word(uint64_t *words_ptr, size_t i);
+	size_t routine_lce(size_t forward, size_t backward, size_t limit, int type);
+	bool routine_check_symmetry_lce(size_t i, size_t k, size_t max_mm, int type);
+	void routine_scan_max_kmer_lce(size_t k_max, size_t k_min, size_t modulo, size_t start, size_t end, int type, HitSink &sink);
 	LinkedlistKmer *get_kmers_mirror(size_t k_min, size_t k_max = 0, size_t modulo = 0, size_t start = 0, size_t end = 0);
 	LinkedlistKmer *get_kmers_mirror_gap(size_t k_min, size_t k_max = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t start = 0, size_t end = 0);
 	LinkedlistKmer *get_max_kmers_mirror_gap(size_t k_max, size_t k_min = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t start = 0, size_t end = 0);
@@ -240,8 +368,21 @@ public:
 	void print_kmers_palindrome(size_t k_min, size_t k_max = 0, size_t modulo = 0, size_t start = 0, size_t end = 0, std::ostream &fout = std::cout, bool counts = true, bool indexes = true, size_t start_idx = 0);
 	void print_kmers_palindrome_gap(size_t k_min, size_t k_max = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t start = 0, size_t end = 0, std::ostream &fout = std::cout, bool counts = true, bool indexes = true, size_t start_idx = 0);
 	void print_max_kmers_palindrome_gap(size_t k_max, size_t k_min = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t start = 0, size_t end = 0, std::ostream &fout = std::cout, bool counts = true, bool indexes = true, size_t start_idx = 0);
+	void scan_kmers_mirror_gap(HitSink &sink, size_t k_min, size_t k_max = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t start = 0, size_t end = 0);
+	void scan_max_kmers_mirror_gap(HitSink &sink, size_t k_max, size_t k_min = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t start = 0, size_t end = 0);
+	void scan_kmers_palindrome_gap(HitSink &sink, size_t k_min, size_t k_max = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t start = 0, size_t end = 0);
+	void scan_max_kmers_palindrome_gap(HitSink &sink, size_t k_max, size_t k_min = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t start = 0, size_t end = 0);
+	void scan_sorted_kmers_mirror_gap(HitSink &sink, size_t k_min, size_t k_max = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t start = 0, size_t end = 0);
+	void scan_sorted_kmers_palindrome_gap(HitSink &sink, size_t k_min, size_t k_max = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t start = 0, size_t end = 0);
 	HashTable *routine_get_kmers_k(size_t k, size_t start, size_t end);
+	void routine_scan_kmers_k(size_t k, size_t start, size_t end, HitSink &sink);
 	void print_kmers(size_t k_min, size_t k_max = 0, size_t start = 0, size_t end = 0, std::ostream &fout = std::cout, bool counts = true, bool indexes = true, size_t start_idx = 0);
+	void scan_kmers(HitSink &sink, size_t k_min, size_t k_max = 0, size_t start = 0, size_t end = 0);
+	HashTable *routine_get_kmers_k_canonical(size_t k, size_t start, size_t end);
+	void routine_scan_kmers_k_canonical(size_t k, size_t start, size_t end, HitSink &sink);
+	void print_kmers_canonical(size_t k_min, size_t k_max = 0, size_t start = 0, size_t end = 0, std::ostream &fout = std::cout, bool counts = true, bool indexes = true, size_t start_idx = 0);
+	void scan_kmers_canonical(HitSink &sink, size_t k_min, size_t k_max = 0, size_t start = 0, size_t end = 0);
+	void scan_kmers_keys(KmerCounter &counter, size_t start = 0, size_t end = 0);
 
 	// Shannon entropy
 	void routine_init_counts(size_t *array_counts_ptr, size_t start, size_t end);
@@ -261,23 +402,42 @@ public:
 	std::list<uint64_t> *routine_get_kmers_k_unique(size_t k, size_t start, size_t end);
 
 	// Quadruplex
-	//TODO
+	uint64_t routine_get_base_word(size_t i);
+	size_t routine_find_base(size_t i, size_t end, uint8_t base, bool equal);
+	void routine_chain_quadruplex_runs(std::vector<size_t> &tract_vector, const std::vector<size_t> &block_vector, size_t run_min, size_t loop_min, size_t loop_max, std::vector<size_t> &end_vector);
+	void routine_get_quadruplex_tracts(std::vector<size_t> &tract_vector, uint8_t base, size_t run_min, size_t loop_min, size_t loop_max, size_t start, size_t end);
+	void routine_scan_quadruplexes(size_t run_min, size_t loop_min, size_t loop_max, size_t start, size_t end, HitSink &sink);
+	LinkedlistKmer *get_quadruplexes(size_t run_min = 3, size_t loop_min = 1, size_t loop_max = 7, size_t start = 0, size_t end = 0);
+	void scan_quadruplexes(HitSink &sink, size_t run_min = 3, size_t loop_min = 1, size_t loop_max = 7, size_t start = 0, size_t end = 0);
+	void print_quadruplexes(size_t run_min = 3, size_t loop_min = 1, size_t loop_max = 7, size_t start = 0, size_t end = 0, std::ostream &fout = std::cout, bool counts = true, bool indexes = true, size_t start_idx = 0);
 
 	// Triplex
 	bool routine_check_triplex_forming(BIT_ARRAY **monomer_bitarray_ptr, size_t k, size_t max_mm, size_t max_purine);
 	bool routine_check_triplex_forming_interval(BIT_ARRAY **monomer_bitarray_ptr, size_t k, size_t max_mm, size_t max_purine, size_t start, size_t end);
-	bool routine_check_triplex_forming_gap(uint8_t *mask_kmer_ptr, std::vector<bool> *align_vector_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine);
-	bool routine_check_triplex_forming_gap_interval(uint8_t *mask_kmer_ptr, std::vector<bool> *align_vector_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine, size_t start, size_t end);
+	bool routine_check_triplex_forming_gap(uint8_t *mask_kmer_ptr, kmer_alignment *alignment_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine);
+	bool routine_check_triplex_forming_gap_interval(uint8_t *mask_kmer_ptr, kmer_alignment *alignment_ptr, size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine, size_t start, size_t end);
+	bool routine_is_purine(size_t i);
+	bool routine_check_purine(size_t purine_c, size_t k, size_t max_purine);
+	BIT_ARRAY *routine_get_triplex_seeds(size_t k_min, size_t k_max, size_t modulo_purine, size_t start, size_t end);
+	bool routine_check_mirror_symmetry_string(size_t i, size_t k, size_t max_mm);
 	HashTable *routine_get_kmers_k_triplex(size_t k, size_t max_mm, size_t max_purine, size_t start, size_t end);
 	HashTable *routine_get_kmers_k_triplex_gap(size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine, size_t start, size_t end);
 	HashTable *routine_get_max_kmer_triplex(size_t k_max, size_t k_min, size_t modulo, size_t modulo_purine, size_t start, size_t end);
 	HashTable *routine_get_max_kmer_triplex_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, size_t start, size_t end);
+	void routine_scan_kmers_k_triplex(size_t k, size_t max_mm, size_t max_purine, size_t start, size_t end, HitSink &sink);
+	void routine_scan_kmers_k_triplex_gap(size_t k, size_t max_mm, size_t max_gap, size_t max_gapmm, size_t max_purine, size_t start, size_t end, HitSink &sink);
+	void routine_scan_max_kmer_triplex(size_t k_max, size_t k_min, size_t modulo, size_t modulo_purine, size_t start, size_t end, HitSink &sink);
+	void routine_scan_max_kmer_triplex_gap(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, size_t start, size_t end, HitSink &sink);
+	void routine_scan_max_kmer_triplex_seed(size_t k_max, size_t k_min, size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, size_t start, size_t end, HitSink &sink);
 	LinkedlistKmer *get_kmers_triplex_gap(size_t k_min, size_t k_max = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t modulo_purine = 0, size_t start = 0, size_t end = 0);
 	LinkedlistKmer *get_max_kmers_triplex_gap(size_t k_max, size_t k_min = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t modulo_purine = 0, size_t start = 0, size_t end = 0);
 	void print_kmers_triplex_gap(size_t k_min, size_t k_max = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t modulo_purine = 0, size_t start = 0, size_t end = 0,
 								 std::ostream &fout = std::cout, bool counts = true, bool indexes = true, size_t start_idx = 0);
 	void print_max_kmers_triplex_gap(size_t k_max, size_t k_min = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t modulo_purine = 0, size_t start = 0, size_t end = 0,
 									 std::ostream &fout = std::cout, bool counts = true, bool indexes = true, size_t start_idx = 0);
+	void scan_kmers_triplex_gap(HitSink &sink, size_t k_min, size_t k_max = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t modulo_purine = 0, size_t start = 0, size_t end = 0);
+	void scan_max_kmers_triplex_gap(HitSink &sink, size_t k_max, size_t k_min = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t modulo_purine = 0, size_t start = 0, size_t end = 0);
+	void scan_sorted_kmers_triplex_gap(HitSink &sink, size_t k_min, size_t k_max = 0, size_t modulo = 0, size_t modulo_gap = 0, size_t modulo_gapmm = 0, size_t modulo_purine = 0, size_t start = 0, size_t end = 0);
 
 };
 
@@ -0,0 +1,546 @@
+/**************************************************************************************
+*
+**	C API (NessieC.cpp)
+*		Implementation of the C interface declared in NessieC.h.
+*		Every query builds a Nessie object for each sub-interval without non-canonical bases
+*		from the EncodedSequence stored in the handle, so that the DNA string is never encoded again,
+*		and delivers the hits through a HitSink calling the C callback.
+*		Exceptions never cross the interface, they are converted to a status and a message.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <utility>
+#include <new>
+#include <stdexcept>
+#include "NessieC.h"
+#include "Nessie.h"
+#include "Stats.h"
+
+#define NESSIE_ERROR_LEN 256
+
+static __thread char nessie_error[NESSIE_ERROR_LEN];	// message of the last error, for each thread
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT nessie_sequence DEFINITION
+//		Structure behind the opaque handle
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct nessie_sequence{
+
+	EncodedSequence *encoded_ptr;	// ptr to the encoded sequence, non-canonical bases are marked
+	size_t length;	// number of bases of the sequence
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS CallbackSink DEFINITION
+//		CallbackSink -- class constructor
+//
+//		add_hit -- decodes the hit and calls the callback, hits received after the callback stopped the query are ignored
+//		is_stopped -- returns true if the callback stopped the query
+//
+//	note: the scans are not interrupted by an exception, some of them own buffers that would be leaked,
+//		  the pass running is completed and the caller does not start the next one
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class CallbackSink : public HitSink{
+
+private:
+	nessie_hit_callback callback;
+	void *user_data;
+	size_t start_idx;	// starting index of the sub-interval, used to shift the indexes of the hits
+	bool stopped;	// true if the callback returned non-zero
+	std::vector<char> kmer_buffer;	// kmer decoded as string
+	std::vector<char> alignment_buffer;	// alignment operations as digits
+
+public:
+	CallbackSink(nessie_hit_callback callback, void *user_data, size_t start_idx){
+		this->callback = callback;
+		this->user_data = user_data;
+		this->start_idx = start_idx;
+		stopped = false;
+	}
+
+	void add_hit(size_t idx, size_t k, uint8_t *kmer_mask_ptr, size_t kmer_mask_len, kmer_alignment *alignment_ptr){
+
+		if (stopped){ return; }
+		NESSIE_STATS_ADD(hits, 1);
+
+		// Decoding the kmer, first base in the lowest bits
+		static const char bases[4] = {'A', 'C', 'G', 'T'};
+		kmer_buffer.resize(k + 1);
+		for (size_t i = 0; i < k; ++i){
+			kmer_buffer[i] = bases[(kmer_mask_ptr[i >> 2] >> ((i & 3) << 1)) & BASE_MASK];
+		}
+		kmer_buffer[k] = '\0';
+
+		nessie_hit hit;
+		hit.index = idx + start_idx;
+		hit.length = k;
+		hit.kmer = &kmer_buffer[0];
+		hit.alignment = NULL;
+
+		// Decoding the alignment, two digits for each operation as print_alignment
+		if (alignment_ptr){
+			alignment_buffer.resize((alignment_ptr->ops_len << 1) + 1);
+			for (size_t i = 0; i < alignment_ptr->ops_len; ++i){
+				uint8_t op = (alignment_ptr->ops_ptr[i >> 2] >> ((i & 3) << 1)) & BASE_MASK;
+				alignment_buffer[(i << 1)] = '0' + (op >> 1);
+				alignment_buffer[(i << 1) + 1] = '0' + (op & 1);
+			}
+			alignment_buffer[alignment_ptr->ops_len << 1] = '\0';
+			hit.alignment = &alignment_buffer[0];
+		}
+
+		if (callback(&hit, user_data)){ stopped = true; }
+	}
+
+	bool is_stopped(){ return stopped; }
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_set_error: stores the message of the last error for the calling thread
+//
+/////////////////////////////////////////////////////////////////////////////////////
+static void routine_set_error(const char *message){
+
+	std::strncpy(nessie_error, message, NESSIE_ERROR_LEN - 1);
+	nessie_error[NESSIE_ERROR_LEN - 1] = '\0';
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_catch: converts the exception being handled into a status, to be called inside catch (...)
+//
+/////////////////////////////////////////////////////////////////////////////////////
+static int routine_catch(){
+
+	try{
+		throw;
+	}
+	catch (std::bad_alloc &e){
+		routine_set_error("out of memory");
+		return NESSIE_ERROR_MEMORY;
+	}
+	catch (std::invalid_argument &e){
+		routine_set_error(e.what());
+		return NESSIE_ERROR_ARGUMENT;
+	}
+	catch (std::exception &e){
+		routine_set_error(e.what());
+		return NESSIE_ERROR;
+	}
+	catch (...){
+		routine_set_error("unknown error");
+		return NESSIE_ERROR;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_get_intervals: splits an interval of the sequence into the sub-intervals without non-canonical bases
+//
+//	parameters:
+//		sequence - ptr to the handle
+//		start - starting index of the interval
+//		end - ending index of the interval, 0 is the last base
+//		min_len - sub-intervals shorter than min_len are skipped
+//		interval_vector - receives the sub-intervals [start..end]
+//
+/////////////////////////////////////////////////////////////////////////////////////
+static void routine_get_intervals(const nessie_sequence *sequence, size_t start, size_t end, size_t min_len, std::vector<std::pair<size_t, size_t> > &interval_vector){
+
+	if (!sequence){ throw std::invalid_argument("sequence is NULL"); }
+	if (!end){ end = sequence->length - 1; }
+	if (start > end){ throw std::invalid_argument("starting index is larger than ending index"); }
+	if (end >= sequence->length){ throw std::invalid_argument("interval is out of the sequence"); }
+	if (!min_len){ min_len = 1; }
+
+	size_t i = start;
+	while (i <= end){
+		size_t unknown = sequence->encoded_ptr->find_unknown(i, end);
+		if (unknown - i >= min_len){ interval_vector.push_back(std::make_pair(i, unknown - 1)); }
+		i = unknown + 1;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		nessie_api_version
+/////////////////////////////////////////////////////////////////////////////////////
+int nessie_api_version(void){
+
+	return NESSIE_API_VERSION;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		nessie_strerror
+/////////////////////////////////////////////////////////////////////////////////////
+const char *nessie_strerror(int status){
+
+	switch (status){
+	case NESSIE_OK:
+		return "success";
+	case NESSIE_STOPPED:
+		return "stopped by the callback";
+	case NESSIE_ERROR_ARGUMENT:
+		return "invalid argument";
+	case NESSIE_ERROR_MEMORY:
+		return "out of memory";
+	default:
+		return "error";
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		nessie_last_error
+/////////////////////////////////////////////////////////////////////////////////////
+const char *nessie_last_error(void){
+
+	return nessie_error;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	nessie_sequence_create: encodes a DNA string into a new handle
+//
+//	parameters:
+//		dna - ptr to the DNA string, upper and lower case bases are accepted, any other character is non-canonical
+//		dna_len - length of the DNA string
+//		sequence - receives the handle, NULL if an error occurs
+//
+/////////////////////////////////////////////////////////////////////////////////////
+int nessie_sequence_create(const char *dna, size_t dna_len, nessie_sequence **sequence){
+
+	if (!sequence){ routine_set_error("sequence is NULL"); return NESSIE_ERROR_ARGUMENT; }
+	*sequence = NULL;
+	if (!dna || !dna_len){ routine_set_error("DNA string is empty"); return NESSIE_ERROR_ARGUMENT; }
+
+	nessie_sequence *sequence_ptr = NULL;
+	try{
+		sequence_ptr = new nessie_sequence;
+		sequence_ptr->encoded_ptr = NULL;
+		sequence_ptr->length = dna_len;
+		sequence_ptr->encoded_ptr = new EncodedSequence(dna, dna_len, 0, dna_len - 1);
+	}
+	catch (...){
+		if (sequence_ptr){ delete sequence_ptr; }
+		return routine_catch();
+	}
+
+	*sequence = sequence_ptr;
+	return NESSIE_OK;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		nessie_sequence_destroy
+/////////////////////////////////////////////////////////////////////////////////////
+void nessie_sequence_destroy(nessie_sequence *sequence){
+
+	if (!sequence){ return; }
+	delete sequence->encoded_ptr;
+	delete sequence;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		nessie_sequence_length
+/////////////////////////////////////////////////////////////////////////////////////
+size_t nessie_sequence_length(const nessie_sequence *sequence){
+
+	return (sequence) ? sequence->length : 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	nessie_symmetry_options_init: sets the options to the defaults of the nessie program, k_min has to be set
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void nessie_symmetry_options_init(nessie_symmetry_options *options, int type){
+
+	if (!options){ return; }
+	std::memset(options, 0, sizeof(nessie_symmetry_options));
+	options->type = type;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	nessie_scan_symmetry: delivers the palindromes, mirrors or triplexes in an interval
+//
+//	note: the same scans of the nessie program are used, the LCE index is built for -MAX with mismatches only
+//
+/////////////////////////////////////////////////////////////////////////////////////
+int nessie_scan_symmetry(const nessie_sequence *sequence, const nessie_symmetry_options *options,
+						 size_t start, size_t end, nessie_hit_callback callback, void *user_data){
+
+	try{
+		if (!options || !callback){ throw std::invalid_argument("options or callback is NULL"); }
+		if (options->type != NESSIE_PALINDROME && options->type != NESSIE_MIRROR && options->type != NESSIE_TRIPLEX){
+			throw std::invalid_argument("symmetry type is not valid");
+		}
+		if (!options->k_min){ throw std::invalid_argument("k_min is not declared"); }
+
+		size_t k_min = options->k_min, k_max = options->k_max;
+		if (!k_max && (!options->max || options->type == NESSIE_TRIPLEX)){ k_max = k_min; }	// -MAX without kmax searches for the longest kmers with no limit on length
+		size_t modulo = options->mismatches, modulo_gap = options->gaps, modulo_gapmm = options->total, modulo_purine = options->purine;
+
+		std::vector<std::pair<size_t, size_t> > interval_vector;
+		routine_get_intervals(sequence, start, end, (k_max) ? k_max : k_min, interval_vector);
+
+		for (size_t i = 0; i < interval_vector.size(); ++i){
+			Nessie nessie(*sequence->encoded_ptr, interval_vector[i].first, interval_vector[i].second, false, options->reverse_complement);
+			if (options->max && modulo && !modulo_gap && !modulo_gapmm){ nessie.build_lce_index(); }	// mismatches checked by longest common extensions
+			CallbackSink sink(callback, user_data, interval_vector[i].first);
+			switch (options->type){
+			case NESSIE_PALINDROME:
+				if (options->max){ nessie.scan_max_kmers_palindrome_gap(sink, k_max, k_min, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+				else if (options->sorted){ nessie.scan_sorted_kmers_palindrome_gap(sink, k_min, k_max, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+				else{ nessie.scan_kmers_palindrome_gap(sink, k_min, k_max, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+				break;
+			case NESSIE_MIRROR:
+				if (options->max){ nessie.scan_max_kmers_mirror_gap(sink, k_max, k_min, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+				else if (options->sorted){ nessie.scan_sorted_kmers_mirror_gap(sink, k_min, k_max, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+				else{ nessie.scan_kmers_mirror_gap(sink, k_min, k_max, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+				break;
+			case NESSIE_TRIPLEX:
+				if (options->max){ nessie.scan_max_kmers_triplex_gap(sink, k_max, k_min, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0); }
+				else if (options->sorted){ nessie.scan_sorted_kmers_triplex_gap(sink, k_min, k_max, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0); }
+				else{ nessie.scan_kmers_triplex_gap(sink, k_min, k_max, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0); }
+				break;
+			}
+			if (sink.is_stopped()){ return NESSIE_STOPPED; }
+		}
+	}
+	catch (...){
+		return routine_catch();
+	}
+
+	return NESSIE_OK;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	nessie_scan_kmers: delivers every kmer of length [k_min..k_max] in an interval
+//
+//	parameters:
+//		both_strands - if non-zero the canonical kmers of both strands are delivered
+//
+/////////////////////////////////////////////////////////////////////////////////////
+int nessie_scan_kmers(const nessie_sequence *sequence, size_t k_min, size_t k_max, int both_strands,
+					  size_t start, size_t end, nessie_hit_callback callback, void *user_data){
+
+	try{
+		if (!callback){ throw std::invalid_argument("callback is NULL"); }
+		if (!k_min){ throw std::invalid_argument("k_min is not declared"); }
+		if (!k_max){ k_max = k_min; }
+
+		std::vector<std::pair<size_t, size_t> > interval_vector;
+		routine_get_intervals(sequence, start, end, k_max, interval_vector);
+
+		for (size_t i = 0; i < interval_vector.size(); ++i){
+			Nessie nessie(*sequence->encoded_ptr, interval_vector[i].first, interval_vector[i].second, false, false);
+			CallbackSink sink(callback, user_data, interval_vector[i].first);
+			if (both_strands){ nessie.scan_kmers_canonical(sink, k_min, k_max, 0, 0); }
+			else{ nessie.scan_kmers(sink, k_min, k_max, 0, 0); }
+			if (sink.is_stopped()){ return NESSIE_STOPPED; }
+		}
+	}
+	catch (...){
+		return routine_catch();
+	}
+
+	return NESSIE_OK;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	nessie_scan_quadruplexes: delivers the tracts with G4-DNA forming potential on both strands in an interval
+//
+//	parameters:
+//		run_min - minimum length of the runs of G (C on the reverse strand) [-r]
+//		loop_min - minimum length of the loops [-lmin]
+//		loop_max - maximum length of the loops [-lmax]
+//
+/////////////////////////////////////////////////////////////////////////////////////
+int nessie_scan_quadruplexes(const nessie_sequence *sequence, size_t run_min, size_t loop_min, size_t loop_max,
+							 size_t start, size_t end, nessie_hit_callback callback, void *user_data){
+
+	try{
+		if (!callback){ throw std::invalid_argument("callback is NULL"); }
+
+		std::vector<std::pair<size_t, size_t> > interval_vector;
+		routine_get_intervals(sequence, start, end, (run_min << 2) + 3 * loop_min, interval_vector);	// shortest tract, four runs and three loops
+
+		for (size_t i = 0; i < interval_vector.size(); ++i){
+			Nessie nessie(*sequence->encoded_ptr, interval_vector[i].first, interval_vector[i].second, false, false);
+			CallbackSink sink(callback, user_data, interval_vector[i].first);
+			nessie.scan_quadruplexes(sink, run_min, loop_min, loop_max, 0, 0);
+			if (sink.is_stopped()){ return NESSIE_STOPPED; }
+		}
+	}
+	catch (...){
+		return routine_catch();
+	}
+
+	return NESSIE_OK;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	nessie_find_motif: delivers the copies of a motif in an interval, in ascending order of index
+//
+//	parameters:
+//		motif - ptr to the motif string, upper and lower case bases
+//		motif_len - length of the motif, at least a dimer
+//		reverse_complement - if non-zero the reverse complement of the motif is searched
+//
+/////////////////////////////////////////////////////////////////////////////////////
+int nessie_find_motif(const nessie_sequence *sequence, const char *motif, size_t motif_len, int reverse_complement,
+					  size_t start, size_t end, nessie_hit_callback callback, void *user_data){
+
+	try{
+		if (!callback || !motif){ throw std::invalid_argument("motif or callback is NULL"); }
+		if (motif_len < 2){ throw std::invalid_argument("motif is shorter than a dimer"); }
+
+		std::vector<std::pair<size_t, size_t> > interval_vector;
+		routine_get_intervals(sequence, start, end, motif_len, interval_vector);
+
+		for (size_t i = 0; i < interval_vector.size(); ++i){
+			Nessie nessie(*sequence->encoded_ptr, interval_vector[i].first, interval_vector[i].second, true, false);
+			Kmer *kmer_ptr = NULL;
+			try{
+				kmer_ptr = nessie.check_kmer_char(motif, motif_len, 0, 0, reverse_complement);
+			}
+			catch (std::runtime_error &e){	// no copy of the motif in the sub-interval, invalid bases are std::invalid_argument
+				continue;
+			}
+			CallbackSink sink(callback, user_data, interval_vector[i].first);
+			for (IndexList::iterator it = kmer_ptr->indexes.begin(); it != kmer_ptr->indexes.end() && !sink.is_stopped(); ++it){
+				sink.add_hit(*it, kmer_ptr->k, kmer_ptr->kmer_mask_ptr, kmer_ptr->kmer_mask_len, NULL);
+			}
+			delete kmer_ptr;
+			if (sink.is_stopped()){ return NESSIE_STOPPED; }
+		}
+	}
+	catch (...){
+		return routine_catch();
+	}
+
+	return NESSIE_OK;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	nessie_entropy: delivers the Shannon entropy of each sub-interval, or of the sliding windows
+//
+//	parameters:
+//		window - length of the sliding windows [-l], 0 for the entropy of each sub-interval
+//		shift - shift of the sliding windows [-s]
+//
+/////////////////////////////////////////////////////////////////////////////////////
+int nessie_entropy(const nessie_sequence *sequence, size_t window, size_t shift,
+				   size_t start, size_t end, nessie_value_callback callback, void *user_data){
+
+	try{
+		if (!callback){ throw std::invalid_argument("callback is NULL"); }
+		if (window && !shift){ throw std::invalid_argument("shift is not declared"); }
+
+		std::vector<std::pair<size_t, size_t> > interval_vector;
+		routine_get_intervals(sequence, start, end, window, interval_vector);
+
+		for (size_t i = 0; i < interval_vector.size(); ++i){
+			size_t first = interval_vector[i].first, last = interval_vector[i].second;
+			Nessie nessie(*sequence->encoded_ptr, first, last, false, false);
+			if (!window){
+				if (callback(first, last, nessie.shannon_entropy_interval(0, 0), user_data)){ return NESSIE_STOPPED; }
+				continue;
+			}
+			std::vector<double> *entropy_vector_ptr = nessie.shannon_entropy_sliding(window, shift, 0, 0);
+			bool stopped = false;
+			for (size_t j = 0; j < entropy_vector_ptr->size() && !stopped; ++j){
+				size_t first_j = first + j * shift;
+				stopped = callback(first_j, first_j + window - 1, (*entropy_vector_ptr)[j], user_data);
+			}
+			delete entropy_vector_ptr;
+			if (stopped){ return NESSIE_STOPPED; }
+		}
+	}
+	catch (...){
+		return routine_catch();
+	}
+
+	return NESSIE_OK;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	nessie_linguistic_complexity: delivers the linguistic complexity of each sub-interval, or of the sliding windows
+//
+//	parameters:
+//		k_min - minimum length of the kmers counted [-k], 0 is 1
+//		k_max - maximum length of the kmers counted [-K], 0 is 20 or the length of the window if shorter
+//		window - length of the sliding windows [-l], 0 for the complexity of each sub-interval
+//		shift - shift of the sliding windows [-s], 0 is 10
+//
+/////////////////////////////////////////////////////////////////////////////////////
+int nessie_linguistic_complexity(const nessie_sequence *sequence, size_t k_min, size_t k_max, size_t window, size_t shift,
+								 size_t start, size_t end, nessie_value_callback callback, void *user_data){
+
+	try{
+		if (!callback){ throw std::invalid_argument("callback is NULL"); }
+		if (!sequence){ throw std::invalid_argument("sequence is NULL"); }
+		if (window && !shift){ shift = 10; }
+
+		// Sub-intervals shorter than kmax are skipped as by the nessie program
+		size_t min_len = window;
+		if (!window){ min_len = (k_max) ? k_max : ((sequence->length < 20) ? sequence->length : 20); }
+
+		std::vector<std::pair<size_t, size_t> > interval_vector;
+		routine_get_intervals(sequence, start, end, min_len, interval_vector);
+
+		for (size_t i = 0; i < interval_vector.size(); ++i){
+			size_t first = interval_vector[i].first, last = interval_vector[i].second;
+			Nessie nessie(*sequence->encoded_ptr, first, last, false, false);
+			if (!window){
+				if (callback(first, last, nessie.linguistic_complexity_interval(0, 0, k_min, k_max), user_data)){ return NESSIE_STOPPED; }
+				continue;
+			}
+			std::vector<double> *linguistic_vector_ptr = nessie.linguistic_complexity_sliding(window, shift, 0, 0, k_min, k_max);
+			bool stopped = false;
+			for (size_t j = 0; j < linguistic_vector_ptr->size() && !stopped; ++j){
+				size_t first_j = first + j * shift;
+				stopped = callback(first_j, first_j + window - 1, (*linguistic_vector_ptr)[j], user_data);
+			}
+			delete linguistic_vector_ptr;
+			if (stopped){ return NESSIE_STOPPED; }
+		}
+	}
+	catch (...){
+		return routine_catch();
+	}
+
+	return NESSIE_OK;
+}
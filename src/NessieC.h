@@ -0,0 +1,164 @@
+/**************************************************************************************
+*
+**	C API (NessieC.h)
+*		Stable C interface to the Nessie library, built as libnessie.a and libnessie.so.
+*		A sequence is encoded once into an opaque nessie_sequence handle and stays resident,
+*		any number of symmetry, kmer, motif, entropy and complexity queries can then be run
+*		on intervals of the sequence, results are delivered to callbacks as they are found.
+*
+*		note: non-canonical bases split the sequence into sub-intervals that are searched separately,
+*			  as for the nessie program. Indexes are in the coordinates of the sequence passed to
+*			  nessie_sequence_create, intervals are inclusive [start..end], end 0 is the last base.
+*			  A handle is read-only after it is created and can be queried by several threads at the same time.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+// INCLUDE
+#include <stddef.h>
+
+
+// C API
+#ifndef NESSIEC_H
+#define NESSIEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Version of the interface, increased only when a function or a structure is changed in an incompatible way
+#define NESSIE_API_VERSION 1
+
+#if defined(__GNUC__)
+#define NESSIE_API __attribute__((visibility("default")))
+#else
+#define NESSIE_API
+#endif
+
+// Status returned by the functions
+#define NESSIE_OK 0
+#define NESSIE_STOPPED 1	// a callback returned non-zero, the query was interrupted
+#define NESSIE_ERROR_ARGUMENT -1	// invalid argument, e.g. interval out of the sequence or kmax longer than the interval
+#define NESSIE_ERROR_MEMORY -2
+#define NESSIE_ERROR -3	// any other error
+
+// Symmetries for nessie_scan_symmetry
+#define NESSIE_PALINDROME 1
+#define NESSIE_MIRROR 2
+#define NESSIE_TRIPLEX 8
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT nessie_hit DEFINITION
+//		Structure to describe a hit delivered to a nessie_hit_callback
+//
+//	note: kmer and alignment belong to the library and are valid only during the call
+//
+/////////////////////////////////////////////////////////////////////////////////////
+typedef struct nessie_hit{
+
+	size_t index;	// starting index of the hit
+	size_t length;	// length of the hit
+	const char *kmer;	// hit as an upper case string
+	const char *alignment;	// alignment of the arms as printed by nessie, NULL if gaps are not allowed
+} nessie_hit;
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT nessie_symmetry_options DEFINITION
+//		Structure to store the options of nessie_scan_symmetry, the fields match the arguments of the nessie program
+//
+/////////////////////////////////////////////////////////////////////////////////////
+typedef struct nessie_symmetry_options{
+
+	int type;	// NESSIE_PALINDROME, NESSIE_MIRROR or NESSIE_TRIPLEX
+	size_t k_min;	// minimum length [-k]
+	size_t k_max;	// maximum length [-K], 0 is k_min, or no limit if max is set
+	size_t mismatches;	// percentage of mismatches [-m]
+	size_t gaps;	// percentage of gaps [-g]
+	size_t total;	// percentage of gaps and mismatches [-t]
+	size_t purine;	// percentage of pyrimidines in the purine strand, triplexes only [-p]
+	int max;	// if non-zero only the longest hits are reported [-MAX]
+	int sorted;	// if non-zero hits are delivered in ascending order of index [-S], ignored with max
+	int reverse_complement;	// if non-zero the reverse complement of the intervals is searched [-C]
+} nessie_symmetry_options;
+
+// Callbacks, a non-zero return value stops the query
+typedef int (*nessie_hit_callback)(const nessie_hit *hit, void *user_data);
+typedef int (*nessie_value_callback)(size_t start, size_t end, double value, void *user_data);
+
+typedef struct nessie_sequence nessie_sequence;	// opaque handle to an encoded sequence
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	Handles
+//		nessie_api_version -- returns NESSIE_API_VERSION of the library, to be checked against the header
+//		nessie_strerror -- returns a description of a status
+//		nessie_last_error -- returns the message of the last error in the calling thread, "" if none
+//		nessie_sequence_create -- encodes a DNA string into a new handle, the string is not used after the call
+//		nessie_sequence_destroy -- frees a handle, NULL is ignored
+//		nessie_sequence_length -- returns the number of bases of the sequence
+//		nessie_symmetry_options_init -- sets the options to the defaults of the nessie program for a symmetry
+//
+/////////////////////////////////////////////////////////////////////////////////////
+NESSIE_API int nessie_api_version(void);
+NESSIE_API const char *nessie_strerror(int status);
+NESSIE_API const char *nessie_last_error(void);
+NESSIE_API int nessie_sequence_create(const char *dna, size_t dna_len, nessie_sequence **sequence);
+NESSIE_API void nessie_sequence_destroy(nessie_sequence *sequence);
+NESSIE_API size_t nessie_sequence_length(const nessie_sequence *sequence);
+NESSIE_API void nessie_symmetry_options_init(nessie_symmetry_options *options, int type);
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	Queries
+//		nessie_scan_symmetry -- delivers the palindromes, mirrors or triplexes in an interval [-P, -M, -T]
+//		nessie_scan_kmers -- delivers every kmer of length [k_min..k_max] in an interval, canonical kmers if both_strands [-A]
+//		nessie_scan_quadruplexes -- delivers the tracts with G4-DNA forming potential on both strands in an interval [-G]
+//		nessie_find_motif -- delivers the copies of a motif, or of its reverse complement, in an interval [-N]
+//		nessie_entropy -- delivers the Shannon entropy of an interval, or of the sliding windows of length window [-E]
+//		nessie_linguistic_complexity -- delivers the linguistic complexity of an interval,
+//										or of the sliding windows of length window [-L]
+//
+//	note: the value callbacks receive the interval of each value, one for each sub-interval without
+//		  non-canonical bases if window is 0. After a callback stops the query the pass running is
+//		  completed without further calls, the scans are never left with resources allocated
+//
+/////////////////////////////////////////////////////////////////////////////////////
+NESSIE_API int nessie_scan_symmetry(const nessie_sequence *sequence, const nessie_symmetry_options *options,
+									size_t start, size_t end, nessie_hit_callback callback, void *user_data);
+NESSIE_API int nessie_scan_kmers(const nessie_sequence *sequence, size_t k_min, size_t k_max, int both_strands,
+								 size_t start, size_t end, nessie_hit_callback callback, void *user_data);
+NESSIE_API int nessie_scan_quadruplexes(const nessie_sequence *sequence, size_t run_min, size_t loop_min, size_t loop_max,
+										size_t start, size_t end, nessie_hit_callback callback, void *user_data);
+NESSIE_API int nessie_find_motif(const nessie_sequence *sequence, const char *motif, size_t motif_len, int reverse_complement,
+								 size_t start, size_t end, nessie_hit_callback callback, void *user_data);
+NESSIE_API int nessie_entropy(const nessie_sequence *sequence, size_t window, size_t shift,
+							  size_t start, size_t end, nessie_value_callback callback, void *user_data);
+NESSIE_API int nessie_linguistic_complexity(const nessie_sequence *sequence, size_t k_min, size_t k_max, size_t window, size_t shift,
+											size_t start, size_t end, nessie_value_callback callback, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NESSIEC_H */
@@ -0,0 +1,294 @@
+/**************************************************************************************
+*
+**	FUNCTIONS (Progress.cpp)
+*		Implements the functions of the NessieProgress class.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+#include <cstdio>
+#include <cerrno>
+#include <stdexcept>
+#include <time.h>
+#include "Progress.h"
+
+NessieProgress nessie_progress;
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		routine_wall: returns the seconds elapsed on the monotonic clock
+/////////////////////////////////////////////////////////////////////////////////////
+static inline double routine_wall(){
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		routine_format_time: formats seconds as XhYYmZZs
+/////////////////////////////////////////////////////////////////////////////////////
+static std::string routine_format_time(double seconds){
+
+	char buffer[32];
+	unsigned long s = (seconds > 0) ? (unsigned long) (seconds + 0.5) : 0;
+	if (s >= 3600){ snprintf(buffer, sizeof(buffer), "%luh%02lum%02lus", s / 3600, (s / 60) % 60, s % 60); }
+	else if (s >= 60){ snprintf(buffer, sizeof(buffer), "%lum%02lus", s / 60, s % 60); }
+	else { snprintf(buffer, sizeof(buffer), "%lus", s); }
+
+	return buffer;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	NessieProgress -- class constructor, progress is not reported until start is called
+//
+/////////////////////////////////////////////////////////////////////////////////////
+NessieProgress::NessieProgress(){
+
+	position = 0; pass_offset = 0; pass_start = 0; pass_len = 0; completed = 0;
+	pthread_mutex_init(&lock, NULL);
+	pthread_cond_init(&cond, NULL);
+	record_n = 0; record_len = 0; record_passes = 1;
+	bytes_begin = 0; bytes_end = 0; bytes_total = 0; bases_done = 0;
+	scanning = false;
+	started = false; stopping = false; to_stderr = false;
+	interval = 10; start_wall = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	~NessieProgress -- class destructor, stops the reporter thread
+//
+/////////////////////////////////////////////////////////////////////////////////////
+NessieProgress::~NessieProgress(){
+
+	NessieProgress::stop();
+	pthread_cond_destroy(&cond);
+	pthread_mutex_destroy(&lock);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	start -- starts the reporter thread
+//
+//	parameters:
+//		to_stderr - bool value, if true the reports are printed to stderr
+//		status_path - status file rewritten at every report, not written if empty
+//		interval - seconds between the reports
+//		bytes_total - size of the input file, used to estimate the time to completion
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void NessieProgress::start(bool to_stderr, const std::string &status_path, unsigned interval, uint64_t bytes_total){
+
+	if (started){ return; }
+
+	this->to_stderr = to_stderr;
+	this->status_path = status_path;
+	this->interval = (interval) ? interval : 1;
+	this->bytes_total = bytes_total;
+	start_wall = routine_wall();
+	stopping = false;
+
+	if (pthread_create(&reporter, NULL, NessieProgress::routine_reporter, this) != 0){
+		throw std::runtime_error("Progress: can not start the reporter thread");
+	}
+	started = true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	stop -- prints the final report and stops the reporter thread
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void NessieProgress::stop(){
+
+	if (!started){ return; }
+
+	pthread_mutex_lock(&lock);
+	stopping = true;
+	pthread_cond_signal(&cond);
+	pthread_mutex_unlock(&lock);
+	pthread_join(reporter, NULL);
+	started = false;
+
+	NessieProgress::routine_report(true);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	begin_record -- sets the record being processed and the number of passes expected over its bases
+//
+//	parameters:
+//		id - id of the record
+//		length - bases of the record
+//		passes - passes expected over the bases of the record (e.g. one for each k with -A)
+//		bytes_begin - offset of the record in the input file
+//		bytes_end - offset of the end of the record in the input file
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void NessieProgress::begin_record(const std::string &id, size_t length, size_t passes, uint64_t bytes_begin, uint64_t bytes_end){
+
+	pthread_mutex_lock(&lock);
+	record_id = id;
+	++record_n;
+	record_len = length;
+	record_passes = (passes) ? passes : 1;
+	this->bytes_begin = bytes_begin;
+	this->bytes_end = bytes_end;
+	__atomic_store_n(&position, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&pass_offset, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&pass_start, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&pass_len, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&completed, 0, __ATOMIC_RELAXED);
+	scanning = true;
+	pthread_mutex_unlock(&lock);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	end_record -- marks the record as processed
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void NessieProgress::end_record(){
+
+	pthread_mutex_lock(&lock);
+	bases_done += record_len;
+	scanning = false;
+	pthread_mutex_unlock(&lock);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_reporter -- body of the reporter thread, reports every interval seconds until stop is called
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void *NessieProgress::routine_reporter(void *arg){
+
+	NessieProgress *progress_ptr = (NessieProgress *) arg;
+
+	pthread_mutex_lock(&progress_ptr->lock);
+	while (!progress_ptr->stopping){
+		struct timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += progress_ptr->interval;
+		int ret = 0;
+		while (!progress_ptr->stopping && ret != ETIMEDOUT){
+			ret = pthread_cond_timedwait(&progress_ptr->cond, &progress_ptr->lock, &deadline);
+		}
+		if (progress_ptr->stopping){ break; }
+		pthread_mutex_unlock(&progress_ptr->lock);
+		progress_ptr->routine_report(false);
+		pthread_mutex_lock(&progress_ptr->lock);
+	}
+	pthread_mutex_unlock(&progress_ptr->lock);
+
+	return NULL;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_report -- prints a report to stderr and rewrites the status file
+//
+//	parameters:
+//		final - bool value, if true the run is completed
+//
+//	note: the fraction of the record processed is (completed passes + position) / (record length * passes),
+//		  the time to completion is estimated on the fraction of the input file processed
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void NessieProgress::routine_report(bool final){
+
+	// Sampling the counters of the scanning thread
+	uint64_t done_pass = __atomic_load_n(&completed, __ATOMIC_RELAXED);
+	uint64_t curr_offset = __atomic_load_n(&pass_offset, __ATOMIC_RELAXED);
+	uint64_t curr_start = __atomic_load_n(&pass_start, __ATOMIC_RELAXED);
+	uint64_t curr_len = __atomic_load_n(&pass_len, __ATOMIC_RELAXED);
+	uint64_t curr_pos = __atomic_load_n(&position, __ATOMIC_RELAXED);
+
+	pthread_mutex_lock(&lock);
+	std::string id = record_id;
+	size_t n = record_n, len = record_len, passes = record_passes;
+	uint64_t b_begin = bytes_begin, b_end = bytes_end, b_total = bytes_total, b_done = bases_done;
+	bool in_record = scanning;
+	pthread_mutex_unlock(&lock);
+
+	// Fractions
+	double record_fraction = 0;
+	if (in_record && len){
+		uint64_t pos = (curr_pos > curr_start) ? curr_pos - curr_start : 0;
+		if (pos > curr_len){ pos = curr_len; }
+		record_fraction = (double) (done_pass + pos) / ((double) len * passes);
+		if (record_fraction > 1){ record_fraction = 1; }
+	}
+	double bases = b_done + record_fraction * len;
+	double file_fraction = (final) ? 1 : 0;
+	if (!final && b_total){
+		file_fraction = (b_begin + record_fraction * (b_end - b_begin)) / (double) b_total;
+		if (file_fraction > 1){ file_fraction = 1; }
+	}
+	double elapsed = routine_wall() - start_wall;
+	double mbps = (elapsed > 0) ? bases / elapsed / 1e6 : 0;
+	double eta = (file_fraction > 0) ? elapsed * (1 - file_fraction) / file_fraction : -1;
+
+	// Interval of the current pass in the record
+	unsigned long long interval_begin = curr_offset + curr_start;
+	unsigned long long interval_end = interval_begin + ((curr_len) ? curr_len - 1 : 0);
+
+	// Report
+	char line[512];
+	if (final){
+		snprintf(line, sizeof(line), "progress: completed, %zu records, %.2f Mb in %s, %.3f Mb/s",
+				 n, bases / 1e6, routine_format_time(elapsed).c_str(), mbps);
+	}
+	else if (in_record){
+		snprintf(line, sizeof(line), "progress: record %zu %.64s [%llu..%llu] %.2f/%.2f Mb (%.1f%%), file %.1f%%, %.3f Mb/s, ETA %s",
+				 n, id.c_str(), interval_begin, interval_end,
+				 record_fraction * len / 1e6, len / 1e6, record_fraction * 100, file_fraction * 100, mbps,
+				 (eta >= 0) ? routine_format_time(eta).c_str() : "unknown");
+	}
+	else{
+		snprintf(line, sizeof(line), "progress: reading record %zu, file %.1f%%, %.3f Mb/s, ETA %s",
+				 n + 1, file_fraction * 100, mbps, (eta >= 0) ? routine_format_time(eta).c_str() : "unknown");
+	}
+	if (to_stderr){ std::cerr << line << std::endl; }
+
+	if (!status_path.empty()){	// written to a temporary file and renamed, readers never see a partial file
+		std::string tmp_path = status_path + ".tmp";
+		FILE *fp = fopen(tmp_path.c_str(), "w");
+		if (fp){
+			std::string escaped;
+			for (size_t i = 0; i < id.size(); ++i){
+				if (id[i] == '"' || id[i] == '\\'){ escaped += '\\'; }
+				if ((unsigned char) id[i] >= 0x20){ escaped += id[i]; }
+			}
+			fprintf(fp, "{\"state\": \"%s\", \"record\": %zu, \"id\": \"%s\", \"interval\": [%llu, %llu], "
+						"\"record_length\": %zu, \"record_done\": %.4f, \"file_done\": %.4f, "
+						"\"bases_processed\": %.0f, \"elapsed_s\": %.1f, \"mbps\": %.4f, \"eta_s\": %.0f}\n",
+					(final) ? "completed" : ((in_record) ? "scanning" : "reading"), n, escaped.c_str(),
+					interval_begin, interval_end,
+					len, (final) ? 1 : record_fraction, file_fraction, bases, elapsed, mbps, (final) ? 0 : eta);
+			fclose(fp);
+			rename(tmp_path.c_str(), status_path.c_str());
+		}
+	}
+}
@@ -0,0 +1,129 @@
+/**************************************************************************************
+*
+**	CLASS (Progress.h)
+*		NessieProgress reports the progress of long scans: bases processed, current record and sub-interval,
+*		throughput and estimated time to completion. The scan loops publish their position with a relaxed store,
+*		a reporter thread samples it periodically and writes to stderr and/or to a status file.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+// INCLUDE CHECK
+#ifndef __IOSTREAM_H_INCLUDED
+#define __IOSTREAM_H_INCLUDED
+#include <iostream>
+#endif /* __IOSTREAM_H_INCLUDED */
+
+#ifndef __STDINT_H_INCLUDED
+#define __STDINT_H_INCLUDED
+#include <stdint.h>
+#endif /*__STDINT_H_INCLUDED */
+
+#ifndef __STRING_H_INCLUDED
+#define __STRING_H_INCLUDED
+#include <string>
+#endif /* __STRING_H_INCLUDED */
+
+#ifndef __PTHREAD_H_INCLUDED
+#define __PTHREAD_H_INCLUDED
+#include <pthread.h>
+#endif /* __PTHREAD_H_INCLUDED */
+
+
+// CLASS
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS NessieProgress DEFINITION
+//		NessieProgress -- class constructor, progress is not reported until start is called
+//		~NessieProgress -- class destructor, stops the reporter thread
+//
+//		start -- starts the reporter thread
+//		stop -- prints the final report and stops the reporter thread
+//		begin_record -- sets the record being processed and the number of passes expected over its bases
+//		end_record -- marks the record as processed
+//		begin_pass -- starts a pass over the interval [start..end] of a sequence that begins at offset in the record, called once by every scan
+//		update -- publishes the index reached by the current pass, called at every position by the scans
+//
+//	note: begin_pass and update are called by the scanning thread only, the reporter thread only reads,
+//		  all the shared counters are accessed with relaxed atomics
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class NessieProgress{
+
+private:
+	// Written by the scanning thread
+	uint64_t position;	// index reached by the current pass in the sequence scanned
+	uint64_t pass_offset;	// index in the record of the first base of the sequence scanned
+	uint64_t pass_start;	// starting index of the current pass in the sequence scanned
+	uint64_t pass_len;	// bases of the current pass
+	uint64_t completed;	// bases of the completed passes in the record
+
+	// Written under lock
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	std::string record_id;	// id of the record being processed
+	size_t record_n;	// number of the record, from 1
+	size_t record_len;	// bases of the record
+	size_t record_passes;	// passes expected over the bases of the record
+	uint64_t bytes_begin;	// offset of the record in the input file
+	uint64_t bytes_end;	// offset of the end of the record in the input file
+	uint64_t bytes_total;	// size of the input file
+	uint64_t bases_done;	// bases of the records already processed
+	bool scanning;	// true after begin_record, false after end_record
+
+	// Reporter
+	bool started;
+	bool stopping;
+	bool to_stderr;	// print the reports to stderr
+	std::string status_path;	// status file rewritten at every report, not written if empty
+	unsigned interval;	// seconds between the reports
+	double start_wall;	// wall time at start
+	pthread_t reporter;
+
+	static void *routine_reporter(void *arg);
+	void routine_report(bool final);
+
+public:
+	NessieProgress();
+	~NessieProgress();
+	void start(bool to_stderr, const std::string &status_path, unsigned interval, uint64_t bytes_total);
+	void stop();
+	void begin_record(const std::string &id, size_t length, size_t passes, uint64_t bytes_begin, uint64_t bytes_end);
+	void end_record();
+	inline void begin_pass(size_t offset, size_t start, size_t end){
+		uint64_t done = __atomic_load_n(&completed, __ATOMIC_RELAXED) + __atomic_load_n(&pass_len, __ATOMIC_RELAXED);
+		__atomic_store_n(&position, start, __ATOMIC_RELAXED);
+		__atomic_store_n(&pass_offset, offset, __ATOMIC_RELAXED);
+		__atomic_store_n(&pass_start, start, __ATOMIC_RELAXED);
+		__atomic_store_n(&pass_len, end - start + 1, __ATOMIC_RELAXED);
+		__atomic_store_n(&completed, done, __ATOMIC_RELAXED);
+	}
+	inline void update(size_t i){ __atomic_store_n(&position, i, __ATOMIC_RELAXED); }
+};
+
+// Progress of the run
+extern NessieProgress nessie_progress;
+
+#endif /* PROGRESS_H */
@@ -0,0 +1,320 @@
+/**************************************************************************************
+*
+**	FUNCTIONS (Stats.cpp)
+*		Implements the functions of the NessieStats class.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <sys/resource.h>
+#include "Stats.h"
+
+// Names of the phases in the JSON report
+static const char *phase_names[STATS_PHASES] = {"parsing", "encoding", "scanning", "dp", "hashing", "printing"};
+
+stats_counters nessie_stats_counters = {0, 0, 0, 0, 0, 0, 0, 0};
+NessieStats nessie_stats;
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		routine_clock: returns the seconds elapsed on a clock
+/////////////////////////////////////////////////////////////////////////////////////
+static inline double routine_clock(clockid_t clock){
+
+	struct timespec ts;
+	clock_gettime(clock, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		routine_json_string: writes a string as a JSON string
+/////////////////////////////////////////////////////////////////////////////////////
+static void routine_json_string(std::ostream &fout, const std::string &str){
+
+	fout << '"';
+	for (size_t i = 0; i < str.size(); ++i){
+		char c = str[i];
+		if (c == '"' || c == '\\'){ fout << '\\' << c; }
+		else if ((unsigned char) c < 0x20){
+			char buffer[8];
+			snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned char) c);
+			fout << buffer;
+		}
+		else { fout << c; }
+	}
+	fout << '"';
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		routine_json_counters: writes the counters, null if they are not compiled
+/////////////////////////////////////////////////////////////////////////////////////
+static void routine_json_counters(std::ostream &fout, const stats_counters &counters){
+
+#ifdef NESSIE_STATS
+	fout << "{\"windows\": " << counters.windows
+		 << ", \"quick_rejects\": " << counters.quick_rejects
+		 << ", \"dp_cells\": " << counters.dp_cells
+		 << ", \"tracebacks\": " << counters.tracebacks
+		 << ", \"hits\": " << counters.hits
+		 << ", \"hash_inserts\": " << counters.hash_inserts
+		 << ", \"hash_probes\": " << counters.hash_probes
+		 << ", \"hash_collisions\": " << counters.hash_collisions << "}";
+#else
+	(void) counters;
+	fout << "null";
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		routine_json_phases: writes the seconds for each phase
+/////////////////////////////////////////////////////////////////////////////////////
+static void routine_json_phases(std::ostream &fout, const double *seconds){
+
+	fout << "{";
+	for (int i = 0; i < STATS_PHASES; ++i){
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "%.6f", seconds[i]);
+		fout << ((i) ? ", " : "") << '"' << phase_names[i] << "\": " << buffer;
+	}
+	fout << "}";
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	NessieStats -- class constructor, statistics are disabled until enable is called
+//
+/////////////////////////////////////////////////////////////////////////////////////
+NessieStats::NessieStats(){
+
+	enabled = false;
+	peak_reset = false;
+	phase = STATS_PHASE_PARSING;
+	last_wall = 0;
+	last_cpu = 0;
+	NessieStats::routine_reset_sequence();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	enable -- starts collecting the statistics, the time is charged to the parsing phase
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void NessieStats::enable(){
+
+	enabled = true;
+	phase = STATS_PHASE_PARSING;
+	last_wall = routine_clock(CLOCK_MONOTONIC);
+	last_cpu = routine_clock(CLOCK_PROCESS_CPUTIME_ID);
+	NessieStats::begin_sequence();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_charge_phase -- charges the time elapsed since the last change to the current phase
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void NessieStats::routine_charge_phase(){
+
+	double wall = routine_clock(CLOCK_MONOTONIC);
+	double cpu = routine_clock(CLOCK_PROCESS_CPUTIME_ID);
+	current.wall[phase] += wall - last_wall;
+	current.cpu[phase] += cpu - last_cpu;
+	last_wall = wall;
+	last_cpu = cpu;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	set_phase -- charges the time elapsed to the current phase and moves to a new phase
+//
+//	parameters:
+//		new_phase - phase the time is charged to from now on
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void NessieStats::set_phase(int new_phase){
+
+	if (!enabled){ return; }
+	NessieStats::routine_charge_phase();
+	phase = new_phase;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_reset_sequence -- clears the statistics of the current sequence
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void NessieStats::routine_reset_sequence(){
+
+	current.id.clear();
+	current.length = 0;
+	for (int i = 0; i < STATS_PHASES; ++i){
+		current.wall[i] = 0;
+		current.cpu[i] = 0;
+	}
+	current.peak_rss_kb = 0;
+	current.counters = nessie_stats_counters;	// counters are stored as the difference at the end of the sequence
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_reset_peak_rss -- resets the peak resident memory of the process, returns false if not supported
+//
+//	note: writing 5 to /proc/self/clear_refs resets VmHWM, available on Linux since 4.0
+//
+/////////////////////////////////////////////////////////////////////////////////////
+bool NessieStats::routine_reset_peak_rss(){
+
+	FILE *fp = fopen("/proc/self/clear_refs", "w");
+	if (!fp){ return false; }
+	bool reset = (fputs("5", fp) >= 0);
+	if (fclose(fp) != 0){ reset = false; }
+
+	return reset;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	routine_get_peak_rss -- returns the peak resident memory of the process in kB
+//
+//	note: VmHWM is read from /proc/self/status, the peak of the whole run is used if not available
+//
+/////////////////////////////////////////////////////////////////////////////////////
+long NessieStats::routine_get_peak_rss(){
+
+	FILE *fp = fopen("/proc/self/status", "r");
+	if (fp){
+		char line[256];
+		long peak = -1;
+		while (fgets(line, sizeof(line), fp)){
+			if (strncmp(line, "VmHWM:", 6) == 0){
+				peak = strtol(line + 6, NULL, 10);
+				break;
+			}
+		}
+		fclose(fp);
+		if (peak >= 0){ return peak; }
+	}
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	return usage.ru_maxrss;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	begin_sequence -- starts the statistics for a new sequence
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void NessieStats::begin_sequence(){
+
+	if (!enabled){ return; }
+	NessieStats::routine_charge_phase();	// time since the end of the previous sequence is discarded
+	NessieStats::routine_reset_sequence();
+	peak_reset = NessieStats::routine_reset_peak_rss();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	end_sequence -- stores the statistics for the current sequence
+//
+//	parameters:
+//		id - id of the sequence
+//		length - bases of the sequence
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void NessieStats::end_sequence(const std::string &id, size_t length){
+
+	if (!enabled){ return; }
+	NessieStats::routine_charge_phase();
+
+	current.id = id;
+	current.length = length;
+	current.peak_rss_kb = NessieStats::routine_get_peak_rss();
+	current.counters.windows = nessie_stats_counters.windows - current.counters.windows;
+	current.counters.quick_rejects = nessie_stats_counters.quick_rejects - current.counters.quick_rejects;
+	current.counters.dp_cells = nessie_stats_counters.dp_cells - current.counters.dp_cells;
+	current.counters.tracebacks = nessie_stats_counters.tracebacks - current.counters.tracebacks;
+	current.counters.hits = nessie_stats_counters.hits - current.counters.hits;
+	current.counters.hash_inserts = nessie_stats_counters.hash_inserts - current.counters.hash_inserts;
+	current.counters.hash_probes = nessie_stats_counters.hash_probes - current.counters.hash_probes;
+	current.counters.hash_collisions = nessie_stats_counters.hash_collisions - current.counters.hash_collisions;
+	sequence_vector.push_back(current);
+
+	NessieStats::routine_reset_sequence();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	write_json -- writes the statistics as JSON
+//
+//	parameters:
+//		fout - stream to write to
+//		command - command line of the run
+//
+//	note: counters are null if the library was not compiled with NESSIE_STATS
+//
+/////////////////////////////////////////////////////////////////////////////////////
+void NessieStats::write_json(std::ostream &fout, const std::string &command){
+
+	double wall[STATS_PHASES], cpu[STATS_PHASES];
+	long peak_rss_kb = 0;
+	size_t length = 0;
+	for (int i = 0; i < STATS_PHASES; ++i){ wall[i] = 0; cpu[i] = 0; }
+	for (size_t j = 0; j < sequence_vector.size(); ++j){
+		for (int i = 0; i < STATS_PHASES; ++i){
+			wall[i] += sequence_vector[j].wall[i];
+			cpu[i] += sequence_vector[j].cpu[i];
+		}
+		if (sequence_vector[j].peak_rss_kb > peak_rss_kb){ peak_rss_kb = sequence_vector[j].peak_rss_kb; }
+		length += sequence_vector[j].length;
+	}
+
+	fout << "{" << std::endl;
+	fout << "  \"command\": "; routine_json_string(fout, command); fout << "," << std::endl;
+#ifdef NESSIE_STATS
+	fout << "  \"counters_compiled\": true," << std::endl;
+#else
+	fout << "  \"counters_compiled\": false," << std::endl;
+#endif
+	fout << "  \"peak_rss_per_sequence\": " << ((peak_reset) ? "true" : "false") << "," << std::endl;
+	fout << "  \"total\": {\"sequences\": " << sequence_vector.size() << ", \"length\": " << length
+		 << ", \"peak_rss_kb\": " << peak_rss_kb << "," << std::endl;
+	fout << "    \"wall\": "; routine_json_phases(fout, wall); fout << "," << std::endl;
+	fout << "    \"cpu\": "; routine_json_phases(fout, cpu); fout << "," << std::endl;
+	fout << "    \"counters\": "; routine_json_counters(fout, nessie_stats_counters); fout << "}," << std::endl;
+	fout << "  \"sequences\": [";
+	for (size_t j = 0; j < sequence_vector.size(); ++j){
+		fout << ((j) ? "," : "") << std::endl;
+		fout << "    {\"id\": "; routine_json_string(fout, sequence_vector[j].id);
+		fout << ", \"length\": " << sequence_vector[j].length << ", \"peak_rss_kb\": " << sequence_vector[j].peak_rss_kb << "," << std::endl;
+		fout << "     \"wall\": "; routine_json_phases(fout, sequence_vector[j].wall); fout << "," << std::endl;
+		fout << "     \"cpu\": "; routine_json_phases(fout, sequence_vector[j].cpu); fout << "," << std::endl;
+		fout << "     \"counters\": "; routine_json_counters(fout, sequence_vector[j].counters); fout << "}";
+	}
+	fout << std::endl << "  ]" << std::endl;
+	fout << "}" << std::endl;
+}
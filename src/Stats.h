@@ -0,0 +1,181 @@
+/**************************************************************************************
+*
+**	CLASS (Stats.h)
+*		NessieStats collects the statistics of a run when --stats is requested:
+*		wall and CPU time spent in each phase, peak memory for each sequence
+*		and the counters of the hot paths (windows, quick rejects, DP cells, tracebacks, hits, HashTable probes).
+*		The counters are updated only if the library is compiled with NESSIE_STATS (make STATS=1),
+*		otherwise the NESSIE_STATS_ADD and NESSIE_STATS_PHASE macros expand to nothing.
+*
+*	Author: Michele Berselli
+*		University of Padova
+*		berselli.michele@gmail.com
+*
+**	LICENSE:
+*   	Copyright (C) 2017  Michele Berselli
+*
+*   	This program is free software: you can redistribute it and/or modify
+*   	it under the terms of the GNU General Public License as published by
+*   	the Free Software Foundation.
+*
+*  	 	This program is distributed in the hope that it will be useful,
+*   	but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   	GNU General Public License for more details.
+*
+*   	You should have received a copy of the GNU General Public License
+*   	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************************/
+
+
+// INCLUDE CHECK
+#ifndef __IOSTREAM_H_INCLUDED
+#define __IOSTREAM_H_INCLUDED
+#include <iostream>
+#endif /* __IOSTREAM_H_INCLUDED */
+
+#ifndef __STDINT_H_INCLUDED
+#define __STDINT_H_INCLUDED
+#include <stdint.h>
+#endif /*__STDINT_H_INCLUDED */
+
+#ifndef __VECTOR_H_INCLUDED
+#define __VECTOR_H_INCLUDED
+#include <vector>
+#endif /* __VECTOR_H_INCLUDED */
+
+#ifndef __STRING_H_INCLUDED
+#define __STRING_H_INCLUDED
+#include <string>
+#endif /* __STRING_H_INCLUDED */
+
+
+// CLASS
+#ifndef STATS_H
+#define STATS_H
+
+// Phases, the time is charged to a single phase at a time
+#define STATS_PHASE_PARSING 0	// reading the FASTA file
+#define STATS_PHASE_ENCODING 1	// encoding the sequence
+#define STATS_PHASE_SCANNING 2	// searching, except for the DP and the HashTable inserts if counted separately
+#define STATS_PHASE_DP 3	// filling the alignment matrices and tracebacks, only with NESSIE_STATS
+#define STATS_PHASE_HASHING 4	// inserting the hits into the HashTable, only with NESSIE_STATS
+#define STATS_PHASE_PRINTING 5	// printing the results
+#define STATS_PHASES 6
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT stats_counters DEFINITION
+//		Structure to store the counters of the hot paths
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct stats_counters{
+
+	uint64_t windows;	// kmers checked for a symmetry
+	uint64_t quick_rejects;	// kmers rejected by the first and last bases check
+	uint64_t dp_cells;	// cells filled in the alignment matrices
+	uint64_t tracebacks;	// alignments traced back
+	uint64_t hits;	// hits delivered to the sinks or found by the motifs search
+	uint64_t hash_inserts;	// Kmers inserted into the HashTable
+	uint64_t hash_probes;	// Kmers compared in the HashTable buckets
+	uint64_t hash_collisions;	// Kmers compared in the HashTable buckets that were different from the one inserted
+};
+
+// Counters of the hot paths, updated only with NESSIE_STATS
+extern stats_counters nessie_stats_counters;
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	STRUCT stats_sequence DEFINITION
+//		Structure to store the statistics of a sequence
+//
+/////////////////////////////////////////////////////////////////////////////////////
+struct stats_sequence{
+
+	std::string id;	// id of the sequence
+	size_t length;	// bases of the sequence
+	double wall[STATS_PHASES];	// wall seconds for each phase
+	double cpu[STATS_PHASES];	// CPU seconds for each phase, all threads
+	long peak_rss_kb;	// peak resident memory while the sequence was processed
+	stats_counters counters;	// counters for the sequence
+};
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS NessieStats DEFINITION
+//		NessieStats -- class constructor, statistics are disabled until enable is called
+//
+//		enable -- starts collecting the statistics, the time is charged to the parsing phase
+//		is_enabled -- returns true if the statistics are collected
+//		get_phase -- returns the current phase
+//		set_phase -- charges the time elapsed to the current phase and moves to a new phase
+//		begin_sequence -- starts the statistics for a new sequence
+//		end_sequence -- stores the statistics for the current sequence
+//		write_json -- writes the statistics as JSON
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class NessieStats{
+
+private:
+	bool enabled;
+	bool peak_reset;	// true if the peak memory is reset for each sequence
+	int phase;	// current phase
+	double last_wall;	// wall time of the last phase change
+	double last_cpu;	// CPU time of the last phase change
+	stats_sequence current;	// statistics of the sequence being processed
+	std::vector<stats_sequence> sequence_vector;	// statistics of the sequences processed
+
+	void routine_charge_phase();
+	void routine_reset_sequence();
+	bool routine_reset_peak_rss();
+	long routine_get_peak_rss();
+
+public:
+	NessieStats();
+	void enable();
+	inline bool is_enabled(){ return enabled; }
+	inline int get_phase(){ return phase; }
+	void set_phase(int new_phase);
+	void begin_sequence();
+	void end_sequence(const std::string &id, size_t length);
+	void write_json(std::ostream &fout, const std::string &command);
+};
+
+// Statistics of the run
+extern NessieStats nessie_stats;
+
+/////////////////////////////////////////////////////////////////////////////////////
+//
+//	CLASS StatsPhase DEFINITION
+//		StatsPhase -- class constructor, moves to a phase if the statistics are enabled
+//		~StatsPhase -- class destructor, moves back to the previous phase
+//
+/////////////////////////////////////////////////////////////////////////////////////
+class StatsPhase{
+
+private:
+	int previous;	// phase to restore, -1 if the statistics are disabled
+
+public:
+	inline StatsPhase(int phase){
+		previous = -1;
+		if (nessie_stats.is_enabled()){
+			previous = nessie_stats.get_phase();
+			nessie_stats.set_phase(phase);
+		}
+	}
+	inline ~StatsPhase(){
+		if (previous >= 0){ nessie_stats.set_phase(previous); }
+	}
+};
+
+#ifdef NESSIE_STATS
+#define NESSIE_STATS_ADD(counter, n) (nessie_stats_counters.counter += (n))
+#define NESSIE_STATS_PHASE(phase) StatsPhase stats_phase_guard(phase)
+#else
+#define NESSIE_STATS_ADD(counter, n) ((void) 0)
+#define NESSIE_STATS_PHASE(phase) ((void) 0)
+#endif
+
+#endif /* STATS_H */
@@ -31,8 +31,12 @@
 #include <iomanip>
 #include <fstream>
 #include <stdexcept>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "Nessie.h"
 #include "FastaUtilities.h"
+#include "Stats.h"
+#include "Progress.h"
 
 #define TEST
 #undef TEST
@@ -59,7 +63,7 @@ void print_h(ostream &pout = std::cout){
 	pout << "  -E/--entropy:  Shannon entropy calculation" << std::endl;
 	pout << "  -L/--linguistic:  linguistic complexity calculation" << std::endl;
 	pout << "  -T/--triplex:  search for possible triplex forming sequences" << std::endl;
-//	pout << "  -G/--quadruplex:  search for possible G4-DNA forming sequences" << std::endl;
+	pout << "  -G/--quadruplex:  search for possible G4-DNA forming sequences" << std::endl;
 	pout << "  -A/--allkmer:  search for all kmers in the sequence" << std::endl;
 
 	pout << std::endl;
@@ -74,11 +78,28 @@ void print_h(ostream &pout = std::cout){
 	pout << "  -c/--counts:  print counts only" << std::endl;
 	pout << "  -i/--indexes:  print indexes only" << std::endl;
 	pout << "  -C/--complement:  search in the reverse complement of the sequence" << std::endl;
+	pout << "  --stats:  write wall and CPU time for each phase and peak memory for each sequence to stats.json, next to the log file" << std::endl;
+	pout << "            (counters for the hot paths are written if nessie is built with make STATS=1)" << std::endl;
+	pout << "  --progress:  print the progress of the search to stderr (bases processed, current record and sub-interval, Mb/s, ETA)" << std::endl;
+	pout << "  --progress-file FILEPATH:  rewrite the progress of the search as JSON to FILEPATH" << std::endl;
+	pout << "  --progress-interval N:  seconds between two progress reports [10]" << std::endl;
+
+	pout << std::endl;
+	pout << "Additional arguments for -N/-A" << std::endl;
+	pout << "  -B/--both-strands:  search both strands in a single pass, hits are tagged by strand for -N and kmers are reported as canonical for -A" << std::endl;
+
+	pout << std::endl;
+	pout << "Additional arguments for -A" << std::endl;
+	pout << "  -mc/--min-count N:  print only the kmers with at least N occurrences, counts only" << std::endl;
+	pout << "  -top/--top N:  print only the N kmers with the highest counts, counts only" << std::endl;
+	pout << "  -hist/--histogram:  print the number of distinct kmers for each count (kmer spectrum) instead of the kmers" << std::endl;
+	pout << "  -mem/--max-mem N:  memory limit in MB for counting, kmers are counted out-of-core in temporary files (in TMPDIR or /tmp) if needed, counts only" << std::endl;
+	pout << "  -j/--threads N:  number of threads used to count the temporary files [number of processors]" << std::endl;
 
 	pout << std::endl;
 	pout << "Additional arguments for -P/-M/-A/-L/-T" << std::endl;
 	pout << "  -k/--kmin N:  minimum kmer length (required for -P/-M/-A/-T)" << std::endl;
-	pout << "  -K/--kmax N:  maximum kmer length (required for -MAX)" << std::endl;
+	pout << "  -K/--kmax N:  maximum kmer length (required for -MAX with mismatches, gaps or -T)" << std::endl;
 
 	pout << std::endl;
 	pout << "Additional arguments for -P/-M/-T" << std::endl;
@@ -86,6 +107,7 @@ void print_h(ostream &pout = std::cout){
 	pout << "  -g/--gap N:  percentage of permitted gaps" << std::endl;
 	pout << "  -t/--total N:  percentage of permitted gaps and mismatches in total" << std::endl;
 	pout << "  -MAX/--MAX:  flag that sets the search for the longest kmers with the selected symmetry in range [kmin..kmax]" << std::endl;
+	pout << "  -S/--sorted:  print every hit as soon as it is found, hits are sorted by index and not grouped by kmer" << std::endl;
 
 	pout << std::endl;
 	pout << "Additional arguments for -E/-L" << std::endl;
@@ -95,6 +117,13 @@ void print_h(ostream &pout = std::cout){
 	pout << std::endl;
 	pout << "Additional arguments for -T" << std::endl;
 	pout << "  -p/--purine N:  percentage of permitted non purine bases" << std::endl;
+
+	pout << std::endl;
+	pout << "Additional arguments for -G" << std::endl;
+	pout << "  -r/--run N:  minimum length of the G-runs (C-runs on the opposite strand) [3]" << std::endl;
+	pout << "  -lmin/--loopmin N:  minimum length of the loops between runs [1]" << std::endl;
+	pout << "  -lmax/--loopmax N:  maximum length of the loops between runs [7]" << std::endl;
+	pout << "  -S/--sorted:  print every hit as soon as it is found, hits are sorted by index and not grouped by sequence" << std::endl;
 	pout << std::endl;
 }
 
@@ -149,7 +178,8 @@ void init_basic_arg_I_O(char *argv[], std::string &inFile, std::string &outFile)
 //		parsing_additional_arg_p_m_a_t
 /////////////////////////////////////////////////////////////////////////////////////
 void parsing_additional_arg_p_m_a_t(int &i, char *argv[], size_t &begin, size_t &end, bool &indexes, bool &counts,
-		size_t &kmax, size_t &perc, size_t &perc_gap, bool &complement, bool &MAX, size_t &perc_purine, size_t &perc_gapmm){
+		size_t &kmax, size_t &perc, size_t &perc_gap, bool &complement, bool &MAX, size_t &perc_purine, size_t &perc_gapmm, bool &sorted, bool &both_strands,
+		size_t &min_count, size_t &top, bool &histogram, size_t &max_mem, size_t &threads){
 
 	if (("-b" == (std::string) argv[i] || "--begin" == (std::string) argv[i]) && !startswith(argv[i + 1], "-")){
 		begin = strtoll(argv[i + 1], NULL, 10);
@@ -187,6 +217,10 @@ void parsing_additional_arg_p_m_a_t(int &i, char *argv[], size_t &begin, size_t
 		MAX = true;
 		i += 1;
 	}
+	else if ("-S" == (std::string) argv[i] || "--sorted" == (std::string) argv[i]){
+		sorted = true;
+		i += 1;
+	}
 	else if (("-p" == (std::string) argv[i] || "--purine" == (std::string) argv[i]) && !startswith(argv[i + 1], "-")){
 		perc_purine = strtoll(argv[i + 1], NULL, 10);
 		i += 2;
@@ -195,6 +229,30 @@ void parsing_additional_arg_p_m_a_t(int &i, char *argv[], size_t &begin, size_t
 		perc_gapmm = strtoll(argv[i + 1], NULL, 10);
 		i += 2;
 	}
+	else if ("-B" == (std::string) argv[i] || "--both-strands" == (std::string) argv[i]){
+		both_strands = true;
+		i += 1;
+	}
+	else if (("-mc" == (std::string) argv[i] || "--min-count" == (std::string) argv[i]) && !startswith(argv[i + 1], "-")){
+		min_count = strtoll(argv[i + 1], NULL, 10);
+		i += 2;
+	}
+	else if (("-top" == (std::string) argv[i] || "--top" == (std::string) argv[i]) && !startswith(argv[i + 1], "-")){
+		top = strtoll(argv[i + 1], NULL, 10);
+		i += 2;
+	}
+	else if ("-hist" == (std::string) argv[i] || "--histogram" == (std::string) argv[i]){
+		histogram = true;
+		i += 1;
+	}
+	else if (("-mem" == (std::string) argv[i] || "--max-mem" == (std::string) argv[i]) && !startswith(argv[i + 1], "-")){
+		max_mem = strtoll(argv[i + 1], NULL, 10) << 20;	// MB to bytes
+		i += 2;
+	}
+	else if (("-j" == (std::string) argv[i] || "--threads" == (std::string) argv[i]) && !startswith(argv[i + 1], "-")){
+		threads = strtoll(argv[i + 1], NULL, 10);
+		i += 2;
+	}
 	else{
 		throw std::invalid_argument("non-recognized additional argument, call [-h] for documentation");
 	}
@@ -251,7 +309,7 @@ void parsing_additional_arg_e_l(int &i, char *argv[], size_t &begin, size_t &end
 /////////////////////////////////////////////////////////////////////////////////////
 //		parsing_additional_arg_n
 /////////////////////////////////////////////////////////////////////////////////////
-void parsing_additional_arg_n(int &i, char *argv[], size_t &begin, size_t &end, bool &indexes, bool &counts, bool &complement){
+void parsing_additional_arg_n(int &i, char *argv[], size_t &begin, size_t &end, bool &indexes, bool &counts, bool &complement, bool &both_strands){
 
 	if (("-b" == (std::string) argv[i] || "--begin" == (std::string) argv[i]) && !startswith(argv[i + 1], "-")){
 		begin = strtoll(argv[i + 1], NULL, 10);
@@ -273,25 +331,153 @@ void parsing_additional_arg_n(int &i, char *argv[], size_t &begin, size_t &end,
 		complement = true;
 		i += 1;
 	}
+	else if ("-B" == (std::string) argv[i] || "--both-strands" == (std::string) argv[i]){
+		both_strands = true;
+		i += 1;
+	}
 	else{
 		throw std::invalid_argument("non-recognized additional argument, call [-h] for documentation");
 	}
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+//		parsing_additional_arg_g
+/////////////////////////////////////////////////////////////////////////////////////
+void parsing_additional_arg_g(int &i, char *argv[], size_t &begin, size_t &end, bool &indexes, bool &counts,
+		size_t &run_min, size_t &loop_min, size_t &loop_max, bool &complement, bool &sorted){
+
+	if (("-b" == (std::string) argv[i] || "--begin" == (std::string) argv[i]) && !startswith(argv[i + 1], "-")){
+		begin = strtoll(argv[i + 1], NULL, 10);
+		i += 2;
+	}
+	else if (("-e" == (std::string) argv[i] || "--end" == (std::string) argv[i]) && !startswith(argv[i + 1], "-")){
+		end = strtoll(argv[i + 1], NULL, 10);
+		i += 2;
+	}
+	else if ("-c" == (std::string) argv[i] || "--counts" == (std::string) argv[i]){
+		indexes = false;
+		i += 1;
+	}
+	else if ("-i" == (std::string) argv[i] || "--indexes" == (std::string) argv[i]){
+		counts = false;
+		i += 1;
+	}
+	else if (("-r" == (std::string) argv[i] || "--run" == (std::string) argv[i]) && !startswith(argv[i + 1], "-")){
+		run_min = strtoll(argv[i + 1], NULL, 10);
+		i += 2;
+	}
+	else if (("-lmin" == (std::string) argv[i] || "--loopmin" == (std::string) argv[i]) && !startswith(argv[i + 1], "-")){
+		loop_min = strtoll(argv[i + 1], NULL, 10);
+		i += 2;
+	}
+	else if (("-lmax" == (std::string) argv[i] || "--loopmax" == (std::string) argv[i]) && !startswith(argv[i + 1], "-")){
+		loop_max = strtoll(argv[i + 1], NULL, 10);
+		i += 2;
+	}
+	else if ("-C" == (std::string) argv[i] || "--complement" == (std::string) argv[i]){
+		complement = true;
+		i += 1;
+	}
+	else if ("-S" == (std::string) argv[i] || "--sorted" == (std::string) argv[i]){
+		sorted = true;
+		i += 1;
+	}
+	else{
+		throw std::invalid_argument("non-recognized additional argument, call [-h] for documentation");
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		progress_passes
+//			returns the passes over the bases of a sequence for the progress report,
+//			one for each k with -A and with -L on the whole interval
+/////////////////////////////////////////////////////////////////////////////////////
+size_t progress_passes(int mode, size_t kmin, size_t kmax, size_t interval){
+
+	if (7 == mode && kmax > kmin){ return kmax - kmin + 1; }
+	if (5 == mode && !interval){
+		if (!kmin){ kmin = 1; }
+		if (!kmax){ kmax = 20; }
+		if (kmax > kmin){ return kmax - kmin + 1; }
+	}
+
+	return 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		progress_length
+//			returns the bases searched in a sequence for the progress report
+/////////////////////////////////////////////////////////////////////////////////////
+size_t progress_length(size_t sequence_len, size_t begin, size_t end){
+
+	if (!end || end >= sequence_len){ end = (sequence_len) ? sequence_len - 1 : 0; }
+	if (begin > end){ return sequence_len; }	// the interval is not valid, an error is reported by calling_function
+
+	return end - begin + 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+//		calling_function_motif
+//			searches the motifs of fasta_vector [-N], the motifs are searched on the original string
+//			and the encoding shared by the other modes is not built
+/////////////////////////////////////////////////////////////////////////////////////
+void calling_function_motif(std::ofstream &out, const char *fasta_sequence_ptr, size_t fasta_sequence_len,
+							size_t begin, size_t end, bool counts, bool indexes,
+							bool complement, bool both_strands, std::vector<Fasta> &fasta_vector){
+
+	std::vector<Fasta>::iterator IT;
+
+	class Nessie fasta_sequence_nessie(1, fasta_sequence_ptr, fasta_sequence_len, begin, end, complement);
+	if (both_strands){	// the reverse complement of the motif is searched on the same structure, hits are tagged by strand
+		for (IT = fasta_vector.begin(); IT != fasta_vector.end(); ++IT){
+			try {
+				Kmer *tmp_motif = fasta_sequence_nessie.check_kmer_char(IT->get_sequence().c_str(), IT->get_sequence().length(), 0, 0, false);
+				out << '!' << IT->get_id() << "|+" << std::endl;
+				{ StatsPhase printing_phase(STATS_PHASE_PRINTING); tmp_motif->print(out, counts, indexes); }
+				delete tmp_motif;
+			}
+			catch (exception &e){}
+			try {
+				Kmer *tmp_motif = fasta_sequence_nessie.check_kmer_char(IT->get_sequence().c_str(), IT->get_sequence().length(), 0, 0, true);
+				out << '!' << IT->get_id() << "|-" << std::endl;
+				{ StatsPhase printing_phase(STATS_PHASE_PRINTING); tmp_motif->print(out, counts, indexes); }
+				delete tmp_motif;
+			}
+			catch (exception &e){}
+		}
+		return;
+	}
+	for (IT = fasta_vector.begin(); IT != fasta_vector.end();){
+		try {
+			Kmer *tmp_motif = fasta_sequence_nessie.check_kmer_char(IT->get_sequence().c_str(), IT->get_sequence().length(), 0, 0, complement);
+			out << '!' << IT->get_id() << std::endl;
+			{ StatsPhase printing_phase(STATS_PHASE_PRINTING); tmp_motif->print(out, counts, indexes); }
+			delete tmp_motif;
+			++IT;
+		}
+		catch (exception &e){
+			++IT;
+		}
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 //		calling_function
 /////////////////////////////////////////////////////////////////////////////////////
 void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 					  size_t begin, size_t end, bool counts, bool indexes,
 					  size_t kmin, size_t kmax,
-					  size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, bool MAX,
+					  size_t modulo, size_t modulo_gap, size_t modulo_gapmm, size_t modulo_purine, bool MAX, bool sorted,
 					  size_t interval, size_t shift,
-					  bool complement, std::vector<Fasta> &fasta_vector){
+					  size_t run_min, size_t loop_min, size_t loop_max,
+					  size_t min_count, size_t top, bool histogram, size_t max_mem, size_t threads,
+					  bool complement, bool both_strands, std::vector<Fasta> &fasta_vector){
 
 	// Variables
 	const char *fasta_sequence_ptr = fasta.get_sequence().c_str();
 	size_t fasta_sequence_len = fasta.get_sequence().length();
 	if (!end){ end = fasta_sequence_len - 1; }
+	StatsPhase stats_phase(STATS_PHASE_SCANNING);	// encoding and printing move to their own phases
 
 	// Check Variables
 	if (end > fasta_sequence_len - 1){ throw std::invalid_argument("selected ending index [-e] is larger than sequence ending index"); }
@@ -313,10 +499,10 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 
 	// Other Variables
 	std::vector<size_t> tmp_idx_unknown;
-	std::vector<Fasta>::iterator IT;
 	std::vector<size_t>::iterator it;
 	size_t begin_i = begin;	//keep stored the current position on the sequence, starting from the first canonical base
 	size_t end_i = end;	//stores the latest possible ending index (later indexes correspond to non-canonical bases)
+	size_t k_req = 0;	//minimum length of a sub-interval to be searched
 
 	// Calculating begin_i, end_i and building tmp_idx_unknown for the interval [begin_i..end_i]
 	if (fasta.get_idx_unknown().size()){
@@ -343,6 +529,16 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 		} //std::cout << std::endl;
 	}
 
+	// Motifs are searched on the original string, without the encoding
+	if (3 == mode){
+		out << '>' << fasta.get_id() << std::endl;
+		calling_function_motif(out, fasta_sequence_ptr, fasta_sequence_len, begin, end, counts, indexes, complement, both_strands, fasta_vector);
+		return;
+	}
+
+	// Encoding the interval once, the sub-intervals skipping non-canonical bases share the encoding
+	EncodedSequence fasta_sequence_encoded(fasta_sequence_ptr, fasta_sequence_len, begin_i, end_i);
+
 	// Printing fasta sequence id
 	out << '>' << fasta.get_id() << std::endl;
 
@@ -350,57 +546,67 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 	switch(mode){
 		case 1:	//palindrome
 		{
-			if (!kmax){ kmax = kmin; }
+			if (!kmax && !MAX){ kmax = kmin; }	// -MAX without kmax searches for the longest kmers with no limit on length
+			k_req = (kmax) ? kmax : kmin;
 			for (it = tmp_idx_unknown.begin(); it != tmp_idx_unknown.end();){	// working sub-intervals skipping non-canonical bases
-				if ((*it - begin_i) >= kmax){ //std::cout << begin_i << " - " << (*it - 1) << std::endl;
-					class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, (*it - 1), false, complement);
-					if (!MAX){ fasta_sequence_nessie.print_kmers_palindrome_gap(kmin, kmax, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
+				if ((*it - begin_i) >= k_req){ //std::cout << begin_i << " - " << (*it - 1) << std::endl;
+					class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, (*it - 1), false, complement);
+					if (MAX && modulo && !modulo_gap && !modulo_gapmm){ fasta_sequence_nessie.build_lce_index(); }	// mismatches checked by longest common extensions
+					if (sorted){	// hits printed as soon as they are found, sorted by index
+						PrintSink sink(out, counts, indexes, begin_i);
+						if (!MAX){ fasta_sequence_nessie.scan_sorted_kmers_palindrome_gap(sink, kmin, kmax, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+						else if (MAX){ fasta_sequence_nessie.scan_max_kmers_palindrome_gap(sink, kmax, kmin, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+					}
+					else if (!MAX){ fasta_sequence_nessie.print_kmers_palindrome_gap(kmin, kmax, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
 					else if (MAX){ fasta_sequence_nessie.print_max_kmers_palindrome_gap(kmax, kmin, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
 				}
 				begin_i = *it + 1;
 				++it;
 			}
 			// working last sub-interval skipping non-canonical bases
-			if ((end_i - begin_i + 1) >= kmax){ //std::cout << begin_i << " - " << end_i << std::endl;
-				class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, end_i, false, complement);
-				if (!MAX){ fasta_sequence_nessie.print_kmers_palindrome_gap(kmin, kmax, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
+			if ((end_i - begin_i + 1) >= k_req){ //std::cout << begin_i << " - " << end_i << std::endl;
+				class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, end_i, false, complement);
+				if (MAX && modulo && !modulo_gap && !modulo_gapmm){ fasta_sequence_nessie.build_lce_index(); }	// mismatches checked by longest common extensions
+				if (sorted){	// hits printed as soon as they are found, sorted by index
+					PrintSink sink(out, counts, indexes, begin_i);
+					if (!MAX){ fasta_sequence_nessie.scan_sorted_kmers_palindrome_gap(sink, kmin, kmax, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+					else if (MAX){ fasta_sequence_nessie.scan_max_kmers_palindrome_gap(sink, kmax, kmin, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+				}
+				else if (!MAX){ fasta_sequence_nessie.print_kmers_palindrome_gap(kmin, kmax, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
 				else if (MAX){ fasta_sequence_nessie.print_max_kmers_palindrome_gap(kmax, kmin, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
 			}
 			break;
 		}
 		case 2:	//mirror
 		{
-			if (!kmax){ kmax = kmin; }
+			if (!kmax && !MAX){ kmax = kmin; }	// -MAX without kmax searches for the longest kmers with no limit on length
+			k_req = (kmax) ? kmax : kmin;
 			for (it = tmp_idx_unknown.begin(); it != tmp_idx_unknown.end();){	// working sub-intervals skipping non-canonical bases
-				if ((*it - begin_i) >= kmax){ //std::cout << begin_i << " - " << (*it - 1) << std::endl;
-					class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, (*it - 1), false, complement);
-					if (!MAX){ fasta_sequence_nessie.print_kmers_mirror_gap(kmin, kmax, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
+				if ((*it - begin_i) >= k_req){ //std::cout << begin_i << " - " << (*it - 1) << std::endl;
+					class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, (*it - 1), false, complement);
+					if (MAX && modulo && !modulo_gap && !modulo_gapmm){ fasta_sequence_nessie.build_lce_index(); }	// mismatches checked by longest common extensions
+					if (sorted){	// hits printed as soon as they are found, sorted by index
+						PrintSink sink(out, counts, indexes, begin_i);
+						if (!MAX){ fasta_sequence_nessie.scan_sorted_kmers_mirror_gap(sink, kmin, kmax, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+						else if (MAX){ fasta_sequence_nessie.scan_max_kmers_mirror_gap(sink, kmax, kmin, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+					}
+					else if (!MAX){ fasta_sequence_nessie.print_kmers_mirror_gap(kmin, kmax, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
 					else if (MAX){ fasta_sequence_nessie.print_max_kmers_mirror_gap(kmax, kmin, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
 				}
 				begin_i = *it + 1;
 				++it;
 			}
 			// working last sub-interval skipping non-canonical bases
-			if ((end_i - begin_i + 1) >= kmax){ //std::cout << begin_i << " - " << end_i << std::endl;
-				class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, end_i, false, complement);
-				if (!MAX){ fasta_sequence_nessie.print_kmers_mirror_gap(kmin, kmax, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
-				else if (MAX){ fasta_sequence_nessie.print_max_kmers_mirror_gap(kmax, kmin, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
-			}
-			break;
-		}
-		case 3:	//motif
-		{
-			class Nessie fasta_sequence_nessie(1, fasta_sequence_ptr, fasta_sequence_len, begin, end, complement);
-			for (IT = fasta_vector.begin(); IT != fasta_vector.end();){
-				try {
-					Kmer *tmp_motif = fasta_sequence_nessie.check_kmer_char(IT->get_sequence().c_str(), IT->get_sequence().length(), 0, 0, complement);
-					out << '!' << IT->get_id() << std::endl;
-					tmp_motif->print(out, counts, indexes);
-					++IT;
-				}
-				catch (exception &e){
-					++IT;
+			if ((end_i - begin_i + 1) >= k_req){ //std::cout << begin_i << " - " << end_i << std::endl;
+				class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, end_i, false, complement);
+				if (MAX && modulo && !modulo_gap && !modulo_gapmm){ fasta_sequence_nessie.build_lce_index(); }	// mismatches checked by longest common extensions
+				if (sorted){	// hits printed as soon as they are found, sorted by index
+					PrintSink sink(out, counts, indexes, begin_i);
+					if (!MAX){ fasta_sequence_nessie.scan_sorted_kmers_mirror_gap(sink, kmin, kmax, modulo, modulo_gap, modulo_gapmm, 0, 0); }
+					else if (MAX){ fasta_sequence_nessie.scan_max_kmers_mirror_gap(sink, kmax, kmin, modulo, modulo_gap, modulo_gapmm, 0, 0); }
 				}
+				else if (!MAX){ fasta_sequence_nessie.print_kmers_mirror_gap(kmin, kmax, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
+				else if (MAX){ fasta_sequence_nessie.print_max_kmers_mirror_gap(kmax, kmin, modulo, modulo_gap, modulo_gapmm, 0, 0, out, counts, indexes, begin_i); }
 			}
 			break;
 		}
@@ -409,7 +615,7 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 			if (interval){
 				for (it = tmp_idx_unknown.begin(); it != tmp_idx_unknown.end();){	// working sub-intervals skipping non-canonical bases
 					if ((*it - begin_i) >= interval){
-						class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, (*it - 1), false, complement);
+						class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, (*it - 1), false, complement);
 						out << '@' << begin_i << '-' << (*it - 1) << std::endl;
 						fasta_sequence_nessie.print_shannon_entropy_sliding(interval, shift, out, 0, 0);
 					}
@@ -418,7 +624,7 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 				}
 				// working last sub-interval skipping non-canonical bases
 				if ((end_i - begin_i + 1) >= interval){
-					class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, end_i, false, complement);
+					class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, end_i, false, complement);
 					out << '@' << begin_i << '-' << end_i << std::endl;
 					fasta_sequence_nessie.print_shannon_entropy_sliding(interval, shift, out, 0, 0);
 				}
@@ -426,7 +632,7 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 			else{
 				for (it = tmp_idx_unknown.begin(); it != tmp_idx_unknown.end();){	// working sub-intervals skipping non-canonical bases
 					if ((*it - 1) > begin_i){
-						class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, (*it - 1), false, complement);
+						class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, (*it - 1), false, complement);
 						out << '@' << begin_i << '-' << (*it - 1) << ": ";
 						fasta_sequence_nessie.print_shannon_entropy_interval(out, 0, 0);
 					}
@@ -435,7 +641,7 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 				}
 				// working last sub-interval skipping non-canonical bases
 				if (end_i > begin_i){
-					class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, end_i, false, complement);
+					class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, end_i, false, complement);
 					out << '@' << begin_i << '-' << end_i << ": ";
 					fasta_sequence_nessie.print_shannon_entropy_interval(out, 0, 0);
 				}
@@ -447,7 +653,7 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 			if (interval){
 				for (it = tmp_idx_unknown.begin(); it != tmp_idx_unknown.end();){	// working sub-intervals skipping non-canonical bases
 					if ((*it - begin_i) >= interval){
-						class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, (*it - 1), false, complement);
+						class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, (*it - 1), false, complement);
 						out << '@' << begin_i << '-' << (*it - 1) << std::endl;
 						fasta_sequence_nessie.print_linguistic_complexity_sliding(interval, shift, out, 0, 0, kmin, kmax);
 					}
@@ -456,7 +662,7 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 				}
 				// working last sub-interval skipping non-canonical bases
 				if ((end_i - begin_i + 1) >= interval){
-					class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, end_i, false, complement);
+					class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, end_i, false, complement);
 					out << '@' << begin_i << '-' << end_i << std::endl;
 					fasta_sequence_nessie.print_linguistic_complexity_sliding(interval, shift, out, 0, 0, kmin, kmax);
 				}
@@ -465,7 +671,7 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 				if (!kmax){ kmax = (fasta_sequence_len < 20) ? fasta_sequence_len : 20; }
 				for (it = tmp_idx_unknown.begin(); it != tmp_idx_unknown.end();){	// working sub-intervals skipping non-canonical bases
 					if ((*it - begin_i) >= kmax ){
-						class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, (*it - 1), false, complement);
+						class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, (*it - 1), false, complement);
 						out << '@' << begin_i << '-' << (*it - 1) << ": ";
 						fasta_sequence_nessie.print_linguistic_complexity_interval(out, 0, 0, kmin, kmax);
 					}
@@ -474,7 +680,7 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 				}
 				// working last sub-interval skipping non-canonical bases
 				if ((end_i - begin_i + 1) >= kmax){
-					class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, end_i, false, complement);
+					class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, end_i, false, complement);
 					out << '@' << begin_i << '-' << end_i << ": ";
 					fasta_sequence_nessie.print_linguistic_complexity_interval(out, 0, 0, kmin, kmax);
 				}
@@ -483,23 +689,80 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 		}
 		case 6:	//quadruplex
 		{
+			k_req = (run_min << 2) + 3 * loop_min;	// shortest tract, four runs and three loops
+			for (it = tmp_idx_unknown.begin(); it != tmp_idx_unknown.end();){	// working sub-intervals skipping non-canonical bases
+				if ((*it - begin_i) >= k_req){ //std::cout << begin_i << " - " << (*it - 1) << std::endl;
+					class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, (*it - 1), false, complement);
+					if (sorted){	// hits printed as soon as they are found, sorted by index
+						PrintSink sink(out, counts, indexes, begin_i);
+						fasta_sequence_nessie.scan_quadruplexes(sink, run_min, loop_min, loop_max, 0, 0);
+					}
+					else{ fasta_sequence_nessie.print_quadruplexes(run_min, loop_min, loop_max, 0, 0, out, counts, indexes, begin_i); }
+				}
+				begin_i = *it + 1;
+				++it;
+			}
+			// working last sub-interval skipping non-canonical bases
+			if ((end_i - begin_i + 1) >= k_req){ //std::cout << begin_i << " - " << end_i << std::endl;
+				class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, end_i, false, complement);
+				if (sorted){	// hits printed as soon as they are found, sorted by index
+					PrintSink sink(out, counts, indexes, begin_i);
+					fasta_sequence_nessie.scan_quadruplexes(sink, run_min, loop_min, loop_max, 0, 0);
+				}
+				else{ fasta_sequence_nessie.print_quadruplexes(run_min, loop_min, loop_max, 0, 0, out, counts, indexes, begin_i); }
+			}
 			break;
 		}
 		case 7:	//allkmer
 		{
 			if (!kmax){ kmax = kmin; }
+			if (counts && !indexes && kmax <= 32){	// counts only, kmers are counted as keys and positions are never stored
+				std::vector<Nessie*> nessie_vector;	// sub-intervals are encoded once and counted for every k
+				for (it = tmp_idx_unknown.begin(); it != tmp_idx_unknown.end();){	// working sub-intervals skipping non-canonical bases
+					if ((*it - begin_i) >= kmax){
+						nessie_vector.push_back(new Nessie(fasta_sequence_encoded, begin_i, (*it - 1), false, complement));
+					}
+					begin_i = *it + 1;
+					++it;
+				}
+				// working last sub-interval skipping non-canonical bases
+				if ((end_i - begin_i + 1) >= kmax){
+					nessie_vector.push_back(new Nessie(fasta_sequence_encoded, begin_i, end_i, false, complement));
+				}
+				// counts are merged across the sub-intervals of the sequence
+				for (size_t k = kmin; k <= kmax; ++k){
+					size_t expected_keys = 0;	// used to decide if the keys are counted out-of-core
+					for (size_t j = 0; j < nessie_vector.size(); ++j){
+						expected_keys += nessie_vector[j]->get_length() - k + 1;
+					}
+					KmerCounter counter(k, both_strands, max_mem, expected_keys, threads);
+					for (size_t j = 0; j < nessie_vector.size(); ++j){
+						nessie_vector[j]->scan_kmers_keys(counter, 0, 0);
+					}
+					counter.count_keys();
+					StatsPhase printing_phase(STATS_PHASE_PRINTING);
+					if (histogram){ counter.print_histogram(out, (min_count) ? min_count : 1); }
+					else{ counter.print_counts(out, (min_count) ? min_count : 1, top); }
+				}
+				for (size_t j = 0; j < nessie_vector.size(); ++j){
+					delete nessie_vector[j];
+				}
+				break;
+			}
 			for (it = tmp_idx_unknown.begin(); it != tmp_idx_unknown.end();){	// working sub-intervals skipping non-canonical bases
 				if ((*it - begin_i) >= kmax){ //std::cout << begin_i << " - " << (*it - 1) << std::endl;
-					class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, (*it - 1), false, complement);
-					fasta_sequence_nessie.print_kmers(kmin, kmax, 0, 0, out, counts, indexes, begin_i);
+					class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, (*it - 1), false, complement);
+					if (both_strands){ fasta_sequence_nessie.print_kmers_canonical(kmin, kmax, 0, 0, out, counts, indexes, begin_i); }
+					else{ fasta_sequence_nessie.print_kmers(kmin, kmax, 0, 0, out, counts, indexes, begin_i); }
 				}
 				begin_i = *it + 1;
 				++it;
 			}
 			// working last sub-interval skipping non-canonical bases
 			if ((end_i - begin_i + 1) >= kmax){ //std::cout << begin_i << " - " << end_i << std::endl;
-				class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, end_i, false, complement);
-				fasta_sequence_nessie.print_kmers(kmin, kmax, 0, 0, out, counts, indexes, begin_i);
+				class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, end_i, false, complement);
+				if (both_strands){ fasta_sequence_nessie.print_kmers_canonical(kmin, kmax, 0, 0, out, counts, indexes, begin_i); }
+				else{ fasta_sequence_nessie.print_kmers(kmin, kmax, 0, 0, out, counts, indexes, begin_i); }
 			}
 			break;
 		}
@@ -508,8 +771,14 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 			if (!kmax){ kmax = kmin; }
 			for (it = tmp_idx_unknown.begin(); it != tmp_idx_unknown.end();){	// working sub-intervals skipping non-canonical bases
 				if ((*it - begin_i) >= kmax){ //std::cout << begin_i << " - " << (*it - 1) << std::endl;
-					class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, (*it - 1), false, complement);
-					if (!MAX){ fasta_sequence_nessie.print_kmers_triplex_gap(kmin, kmax, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0, out, counts, indexes, begin_i); }
+					class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, (*it - 1), false, complement);
+					if (MAX && modulo && !modulo_gap && !modulo_gapmm){ fasta_sequence_nessie.build_lce_index(); }	// mismatches checked by longest common extensions
+					if (sorted){	// hits printed as soon as they are found, sorted by index
+						PrintSink sink(out, counts, indexes, begin_i);
+						if (!MAX){ fasta_sequence_nessie.scan_sorted_kmers_triplex_gap(sink, kmin, kmax, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0); }
+						else if (MAX){ fasta_sequence_nessie.scan_max_kmers_triplex_gap(sink, kmax, kmin, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0); }
+					}
+					else if (!MAX){ fasta_sequence_nessie.print_kmers_triplex_gap(kmin, kmax, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0, out, counts, indexes, begin_i); }
 					else if (MAX){ fasta_sequence_nessie.print_max_kmers_triplex_gap(kmax, kmin, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0, out, counts, indexes, begin_i); }
 				}
 				begin_i = *it + 1;
@@ -517,8 +786,14 @@ void calling_function(std::ofstream &out, Fasta &fasta, int mode,
 			}
 			// working last sub-interval skipping non-canonical bases
 			if ((end_i - begin_i + 1) >= kmax){ //std::cout << begin_i << " - " << end_i << std::endl;
-				class Nessie fasta_sequence_nessie(fasta_sequence_ptr, fasta_sequence_len, begin_i, end_i, false, complement);
-				if (!MAX){ fasta_sequence_nessie.print_kmers_triplex_gap(kmin, kmax, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0, out, counts, indexes, begin_i); }
+				class Nessie fasta_sequence_nessie(fasta_sequence_encoded, begin_i, end_i, false, complement);
+				if (MAX && modulo && !modulo_gap && !modulo_gapmm){ fasta_sequence_nessie.build_lce_index(); }	// mismatches checked by longest common extensions
+				if (sorted){	// hits printed as soon as they are found, sorted by index
+					PrintSink sink(out, counts, indexes, begin_i);
+					if (!MAX){ fasta_sequence_nessie.scan_sorted_kmers_triplex_gap(sink, kmin, kmax, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0); }
+					else if (MAX){ fasta_sequence_nessie.scan_max_kmers_triplex_gap(sink, kmax, kmin, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0); }
+				}
+				else if (!MAX){ fasta_sequence_nessie.print_kmers_triplex_gap(kmin, kmax, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0, out, counts, indexes, begin_i); }
 				else if (MAX){ fasta_sequence_nessie.print_max_kmers_triplex_gap(kmax, kmin, modulo, modulo_gap, modulo_gapmm, modulo_purine, 0, 0, out, counts, indexes, begin_i); }
 			}
 			break;
@@ -552,14 +827,19 @@ int main(int argc, char *argv[]){
 
 	// Varibales for additional arguments
 	size_t begin = 0, end = 0;	//additional arguments for all searches
-	bool counts = true, indexes = true; bool MAX = false;
+	bool counts = true, indexes = true; bool MAX = false; bool sorted = false;
 	size_t kmin = 0, kmax = 0;	//additional arguments for -P/-M/-L
 	size_t perc = 0, perc_gap = 0, perc_gapmm = 0; //additional arguments for -P/-M/-T
 	size_t modulo = 0, modulo_gap = 0, modulo_gapmm = 0;
 	size_t interval = 0, shift = 0;	//additional arguments for -E/-L
 	bool complement = false;	//additional arguments for -N
+	bool both_strands = false;	//additional arguments for -N/-A
+	size_t min_count = 0, top = 0;	//additional arguments for -A
+	bool histogram = false;
+	size_t max_mem = 0, threads = 0;
 	size_t perc_purine = 0;
 	size_t modulo_purine = 0;	//additional arguments for -T
+	size_t run_min = 3, loop_min = 1, loop_max = 7;	//additional arguments for -G
 	MultiFasta motifs;	//class to store the motifs to be searched with -N flag
 
 	// Credits
@@ -576,6 +856,41 @@ int main(int argc, char *argv[]){
 //													Parsing command line													//
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+	// Command line as called, echoed in the output and in stats.json before the options parsed here are removed
+	std::string command_line;
+	for (int i = 1; i < argc; ++i){
+		command_line += (std::string) argv[i] + " ";
+	}
+
+	// Removing --stats, it can be anywhere in the command line
+	bool stats = false;
+	int argc_stats = 1;
+	for (int i = 1; i < argc; ++i){
+		if ("--stats" == (std::string) argv[i]){ stats = true; }
+		else { argv[argc_stats++] = argv[i]; }
+	}
+	argc = argc_stats;
+
+	// Removing --progress, --progress-file and --progress-interval, they can be anywhere in the command line
+	bool progress = false;
+	std::string progress_path;
+	unsigned progress_interval = 10;
+	int argc_progress = 1;
+	for (int i = 1; i < argc; ++i){
+		if ("--progress" == (std::string) argv[i]){ progress = true; }
+		else if ("--progress-file" == (std::string) argv[i] || "--progress-interval" == (std::string) argv[i]){
+			if ((i + 1) >= argc || startswith(argv[i + 1], "-")){
+				std::cerr << std::endl;
+				std::cerr << "missing value for [" << argv[i] << "], call [-h] for documentation" << std::endl;
+				print_basic(std::cerr); return 1;
+			}
+			if ("--progress-file" == (std::string) argv[i]){ progress_path = (std::string) argv[++i]; }
+			else { progress_interval = strtoll(argv[++i], NULL, 10); }	// 0 is reported every second
+		}
+		else { argv[argc_progress++] = argv[i]; }
+	}
+	argc = argc_progress;
+
 	// Parsing
 	if (1 == argc){
 		std::cout << std::endl;
@@ -628,10 +943,6 @@ int main(int argc, char *argv[]){
 			}
 			else if ("-G" == (std::string) argv[5] || "--quadruplex" == (std::string) argv[5]){
 				mode = 6;
-				std::cout << std::endl;
-				std::cout << "This option is currently under development, stay tuned!" << std::endl;
-				std::cout << std::endl;
-				return 1;
 			}
 			else{
 				std::cerr << std::endl;
@@ -687,7 +998,7 @@ int main(int argc, char *argv[]){
 			int i = 8;
 			while (i < argc){
 				try{
-					parsing_additional_arg_p_m_a_t(i, argv, begin, end, indexes, counts, kmax, perc, perc_gap, complement, MAX, perc_purine, perc_gapmm);
+					parsing_additional_arg_p_m_a_t(i, argv, begin, end, indexes, counts, kmax, perc, perc_gap, complement, MAX, perc_purine, perc_gapmm, sorted, both_strands, min_count, top, histogram, max_mem, threads);
 				}
 				catch (exception &e){
 					std::cerr << std::endl;
@@ -715,7 +1026,7 @@ int main(int argc, char *argv[]){
 				int i = 7;
 				while (i < argc){
 					try{
-						parsing_additional_arg_n(i, argv, begin, end, indexes, counts, complement);
+						parsing_additional_arg_n(i, argv, begin, end, indexes, counts, complement, both_strands);
 					}
 					catch (exception &e){
 						std::cerr << std::endl;
@@ -759,10 +1070,19 @@ int main(int argc, char *argv[]){
 			}
 			else if ("-G" == (std::string) argv[5] || "--quadruplex" == (std::string) argv[5]){
 				mode = 6;
-				std::cout << std::endl;
-				std::cout << "This option is currently under development, stay tuned!" << std::endl;
-				std::cout << std::endl;
-				return 1;
+
+				int i = 6;
+				while (i < argc){
+					try{
+						parsing_additional_arg_g(i, argv, begin, end, indexes, counts, run_min, loop_min, loop_max, complement, sorted);
+					}
+					catch (exception &e){
+						std::cerr << std::endl;
+						std::cerr << e.what() << std::endl;
+						print_basic(std::cerr);
+						return 1;
+					}
+				}
 			}
 			else{
 				std::cerr << std::endl;
@@ -813,9 +1133,37 @@ int main(int argc, char *argv[]){
 		print_basic(std::cerr); return 1;
 	}
 
-	if (MAX && !kmax){
+	if (MAX && !kmax && (8 == mode || perc || perc_gap || perc_gapmm)){
 		std::cerr << std::endl;
-		std::cerr << "kmax [-K] is needed to search patterns with -MAX flag" << std::endl;
+		std::cerr << "kmax [-K] is needed to search patterns with -MAX flag if mismatches or gaps are allowed or with -T" << std::endl;
+		print_basic(std::cerr); return 1;
+	}
+
+	if (both_strands && ((3 != mode && 7 != mode) || complement)){
+		std::cerr << std::endl;
+		std::cerr << "both strands search [-B] is available only with -N/-A and can not be combined with reverse complement [-C]" << std::endl;
+		print_basic(std::cerr); return 1;
+	}
+
+	if ((min_count || top || histogram || max_mem || threads) && (7 != mode || !counts || kmax > 32 || (!kmax && kmin > 32))){
+		std::cerr << std::endl;
+		std::cerr << "filters on counts [-mc/-top/-hist] and counting options [-mem/-j] are available only with -A, for kmers up to 32 bases and can not be combined with indexes only [-i]" << std::endl;
+		print_basic(std::cerr); return 1;
+	}
+	if (histogram && top){
+		std::cerr << std::endl;
+		std::cerr << "histogram [-hist] can not be combined with top kmers [-top]" << std::endl;
+		print_basic(std::cerr); return 1;
+	}
+	if (min_count || top || histogram || max_mem){ indexes = false; }	// filters on counts, histogram and counting out-of-core print counts only
+	if (!threads){	// default to the number of processors
+		long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = (processors > 0) ? processors : 1;
+	}
+
+	if (6 == mode && (!run_min || (loop_min > loop_max))){
+		std::cerr << std::endl;
+		std::cerr << "selected run length [-r] must be larger than 0 and minimum loop length [-lmin] can not be larger than maximum loop length [-lmax]" << std::endl;
 		print_basic(std::cerr); return 1;
 	}
 
@@ -856,18 +1204,25 @@ int main(int argc, char *argv[]){
 		motifs.get_data(motifsFile);
 	}
 
-	// Printing command line
-	outFile << "#Command ";
-	for (int i = 1; i < argc; ++i){
-		outFile << argv[i] << " ";
+	// Statistics, parsing of the first sequence starts here
+	if (stats){ nessie_stats.enable(); }
+
+	// Progress, the size of the input file is used to estimate the time to completion
+	if (progress || !progress_path.empty()){
+		struct stat inFile_stat;
+		uint64_t inFile_size = (0 == stat(inFile_path.c_str(), &inFile_stat)) ? (uint64_t) inFile_stat.st_size : 0;
+		nessie_progress.start(progress, progress_path, progress_interval, inFile_size);
 	}
-	outFile << std::endl;
+
+	// Printing command line
+	outFile << "#Command " << command_line << std::endl;
 
 	// Variables
 	char c;	//current read char
 	bool first = true;
 	bool add_id = false;
 	size_t curr_base_idx = 0;
+	uint64_t record_offset = 0;	// offset of the current record in inFile, for the progress report
 
 	// Variables Fasta
 	std::string tmp_id;
@@ -883,19 +1238,28 @@ int main(int argc, char *argv[]){
 		}
 		else if (('>' == c) && !first){
 			Fasta fasta_seq(tmp_id, tmp_sequence, tmp_idx_unknown);
+			uint64_t next_record_offset = (uint64_t) inFile.tellg() - 1;
+			nessie_progress.begin_record(tmp_id, progress_length(tmp_sequence.length(), begin, end), progress_passes(mode, kmin, kmax, interval),
+										 record_offset, next_record_offset);
 			//TODO --> call operations here
 			try{
 				calling_function(outFile, fasta_seq, mode,
 								  begin, end, counts, indexes,
 								  kmin, kmax,
-								  modulo, modulo_gap, modulo_gapmm, modulo_purine, MAX,
+								  modulo, modulo_gap, modulo_gapmm, modulo_purine, MAX, sorted,
 								  interval, shift,
-								  complement, motifs.get_sequences_vector());
+								  run_min, loop_min, loop_max,
+								  min_count, top, histogram, max_mem, threads,
+								  complement, both_strands, motifs.get_sequences_vector());
 			}
 			catch (exception &e){
 				logFile << '>' << tmp_id << std::endl;
 				logFile << e.what() << std::endl;
 			}
+			nessie_stats.end_sequence(tmp_id, tmp_sequence.length());
+			nessie_stats.begin_sequence();
+			nessie_progress.end_record();
+			record_offset = next_record_offset;
 
 			// Resetting tmp variables for the new fasta entry
 			tmp_id.clear();
@@ -933,18 +1297,27 @@ int main(int argc, char *argv[]){
 	}
 	// TODO --> call operations here
 	Fasta fasta_seq(tmp_id, tmp_sequence, tmp_idx_unknown);
+	inFile.clear();	// end of file reached, the offset of the end of the record is the size of the file
+	inFile.seekg(0, ios::end);
+	nessie_progress.begin_record(tmp_id, progress_length(tmp_sequence.length(), begin, end), progress_passes(mode, kmin, kmax, interval),
+								 record_offset, (uint64_t) inFile.tellg());
 	try{
 		calling_function(outFile, fasta_seq, mode,
 						  begin, end, counts, indexes,
 						  kmin, kmax,
-						  modulo, modulo_gap, modulo_gapmm, modulo_purine, MAX,
+						  modulo, modulo_gap, modulo_gapmm, modulo_purine, MAX, sorted,
 						  interval, shift,
-						  complement, motifs.get_sequences_vector());
+						  run_min, loop_min, loop_max,
+						  min_count, top, histogram, max_mem, threads,
+						  complement, both_strands, motifs.get_sequences_vector());
 	}
 	catch (exception &e){
 		logFile << '>' << tmp_id << std::endl;
 		logFile << e.what() << std::endl;
 	}
+	nessie_stats.end_sequence(tmp_id, tmp_sequence.length());
+	nessie_progress.end_record();
+	nessie_progress.stop();
 
 	std::cout << std::endl;
 	// Closing files
@@ -952,6 +1325,14 @@ int main(int argc, char *argv[]){
 	outFile.close();
 	logFile.close();
 
+	// Writing statistics
+	if (stats){
+		std::ofstream statsFile("stats.json", ios::out);
+		nessie_stats.write_json(statsFile, "nessie " + command_line.substr(0, command_line.size() - 1));
+		statsFile.close();
+		std::cout << "Statistics written to stats.json" << std::endl;
+	}
+
 	std::cout << "Analysis completed successfully! Check the log file for errors report."<< std::endl;
 
 